@@ -34,6 +34,7 @@
 #include <opencog/atoms/atom_types/types.h>
 #include <opencog/atoms/atom_types/atom_types.h>
 #include <opencog/atoms/base/ClassServer.h>
+#include <opencog/atoms/base/hash.h>
 #include <opencog/atoms/value/Value.h>
 #include <opencog/util/exceptions.h>
 
@@ -49,6 +50,8 @@ NameServer::NameServer(void)
 	nValues = 0;   // TopType is 0  Value is 1
 	_maxDepth = 0;
 	_tmod = 0;
+	_table = nullptr;
+	_num_types = nTypes;
 }
 
 /**
@@ -94,6 +97,10 @@ void NameServer::endTypeDecls(void)
 {
 	// Valid types are odd-numbered.
 	_tmod++;
+
+	// Build the table for the new types now, once, rather than on
+	// each declType().
+	table();
 	_module_mutex.unlock();
 
 	classserver().update_factories();
@@ -111,9 +118,10 @@ Type NameServer::declType(const Type parent,
     // the second and subsequent calls are to be interpreted as defining
     // multiple inheritance for this type.  A real-life example is the
     // GroundedSchemaNode, which inherits from several types.
-    Type type = getType(name);
-    if (type != NOTYPE) {
-        std::lock_guard<std::mutex> l(type_mutex);
+    std::unique_lock<std::mutex> l(type_mutex);
+    auto it = name2CodeMap.find(name);
+    if (it != name2CodeMap.end()) {
+        Type type = it->second;
 
         // ... unless someone is accidentally declaring the same type
         // in some different place. In that case, we throw an error.
@@ -127,12 +135,12 @@ Type NameServer::declType(const Type parent,
         Type maxd = 1;
         setParentRecursively(parent, type, maxd);
         if (_maxDepth < maxd) _maxDepth = maxd;
+        _table.store(nullptr, std::memory_order_release);
         return type;
     }
 
-    std::unique_lock<std::mutex> l(type_mutex);
-
     // Assign type code and increment type counter.
+    Type type;
     if (0 == ATOM or parent < ATOM)
     {
         if (0 == ATOM and 0 == name.compare("Atom"))
@@ -171,7 +179,7 @@ Type NameServer::declType(const Type parent,
     name2CodeMap[name]           = type;
     _code2NameMap[type]          = &(name2CodeMap.find(name)->first);
     _mod[type]                   = _tmod;
-    _hash[type]                  = std::hash<std::string>{}(name);
+    _hash[type]                  = name_hash(name);
 
     Type maxd = 1;
     setParentRecursively(parent, type, maxd);
@@ -190,6 +198,10 @@ Type NameServer::declType(const Type parent,
        _code2ShortMap[type]      = &(name2CodeMap.find(name)->first);
     }
 
+    // The table is rebuilt when the declarations are done.
+    _num_types.store(nTypes, std::memory_order_release);
+    _table.store(nullptr, std::memory_order_release);
+
     // unlock mutex before sending signal which could call
     l.unlock();
 
@@ -225,29 +237,72 @@ TypeSignal& NameServer::typeAddedSignal()
     return _addTypeSignal;
 }
 
+/// Build a table from the maps, and publish it. Called by readers,
+/// the first time they look after new types were declared.
+const TypeTable* NameServer::publish(void) const
+{
+    std::lock_guard<std::mutex> l(type_mutex);
+
+    // Someone else may have gotten here first.
+    const TypeTable* tab = _table.load(std::memory_order_acquire);
+    if (tab) return tab;
+
+    TypeTable* nt = new TypeTable();
+    nt->nTypes = nTypes;
+    nt->nValues = nValues;
+    nt->words = (nTypes + 63) / 64;
+    nt->bits.resize(nTypes * nt->words, 0);
+    nt->subtypes.resize(nTypes);
+
+    // recursiveMap has not been resized, if no types are declared.
+    Type nr = recursiveMap.size();
+    for (Type super = 0; super < nr; super++)
+    {
+        uint64_t* row = &nt->bits[super * nt->words];
+        for (Type sub = super; sub < nr; sub++)
+        {
+            if (not recursiveMap[super][sub]) continue;
+            row[sub / 64] |= ((uint64_t) 1) << (sub % 64);
+            nt->subtypes[super].push_back(sub);
+        }
+    }
+
+    nt->names = _code2NameMap;
+    nt->shorts = _code2ShortMap;
+    nt->hashes = _hash;
+    nt->names.resize(nTypes, nullptr);
+    nt->shorts.resize(nTypes, nullptr);
+    nt->hashes.resize(nTypes, 0);
+    for (const auto& pr : name2CodeMap)
+        nt->codes.emplace(pr.first, pr.second);
+
+    _tables.emplace_back(nt);
+    _table.store(nt, std::memory_order_release);
+    return nt;
+}
+
 bool NameServer::isAncestor(Type super, Type sub) const
 {
-	std::lock_guard<std::mutex> l(type_mutex);
-	return recursiveMap[super][sub];
+    return table()->isA(sub, super);
 }
 
 bool NameServer::isDefined(const std::string& typeName) const
 {
-    std::lock_guard<std::mutex> l(type_mutex);
-    return name2CodeMap.find(typeName) != name2CodeMap.end();
+    const TypeTable* tab = table();
+    return tab->codes.find(typeName) != tab->codes.end();
 }
 
 bool NameServer::isDefined(Type t) const
 {
-    std::lock_guard<std::mutex> l(type_mutex);
-    return (1 <= t and t < nValues) or (ATOM <= t and t < nTypes);
+    const TypeTable* tab = table();
+    return (1 <= t and t < tab->nValues) or (ATOM <= t and t < tab->nTypes);
 }
 
 Type NameServer::getType(const std::string& typeName) const
 {
-    std::lock_guard<std::mutex> l(type_mutex);
-    std::unordered_map<std::string, Type>::const_iterator it = name2CodeMap.find(typeName);
-    if (it == name2CodeMap.end()) {
+    const TypeTable* tab = table();
+    auto it = tab->codes.find(typeName);
+    if (it == tab->codes.end()) {
         return NOTYPE;
     }
     return it->second;
@@ -259,10 +314,10 @@ const std::string& NameServer::getTypeName(Type type) const
     static std::string bottomString = "*** Bottom Type! ***";
 
     if (NOTYPE == type) return bottomString;
-    if (nTypes <= type) return nullString;
 
-    std::lock_guard<std::mutex> l(type_mutex);
-    const std::string* name = _code2NameMap[type];
+    const TypeTable* tab = table();
+    if (tab->nTypes <= type) return nullString;
+    const std::string* name = tab->names[type];
     if (name) return *name;
     return nullString;
 }
@@ -273,10 +328,10 @@ const std::string& NameServer::getTypeShortName(Type type) const
     static std::string bottomString = "*** Bottom Type! ***";
 
     if (NOTYPE == type) return bottomString;
-    if (nTypes <= type) return nullString;
 
-    std::lock_guard<std::mutex> l(type_mutex);
-    const std::string* name = _code2ShortMap[type];
+    const TypeTable* tab = table();
+    if (tab->nTypes <= type) return nullString;
+    const std::string* name = tab->shorts[type];
     if (name) return *name;
     return nullString;
 }
@@ -24,9 +24,13 @@
 #ifndef _OPENCOG_CLASS_NAMESERVER_H
 #define _OPENCOG_CLASS_NAMESERVER_H
 
+#include <atomic>
+#include <iterator>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -44,6 +48,38 @@ namespace opencog
 
 typedef SigSlot<Type> TypeSignal;
 
+/**
+ * An immutable snapshot of the type hierarchy, laid out for fast
+ * lookup. Row `super` of the bitset has bit `sub` set whenever `sub`
+ * inherits from `super`. Tables are never modified after they are
+ * published, and never freed, so readers need no locks.
+ */
+struct TypeTable
+{
+    Type nTypes;
+    Type nValues;
+    size_t words;   // Number of 64-bit words per row of bits.
+    std::vector<uint64_t> bits;
+
+    // All subtypes of each type, recursively, in ascending order.
+    // The first entry is always the type itself.
+    std::vector<std::vector<Type>> subtypes;
+
+    std::vector<const std::string*> names;
+    std::vector<const std::string*> shorts;
+    std::vector<size_t> hashes;
+
+    // The keys point into NameServer::name2CodeMap, which never
+    // deletes entries.
+    std::unordered_map<std::string_view, Type> codes;
+
+    bool isA(Type sub, Type super) const
+    {
+        if ((sub >= nTypes) or (super >= nTypes)) return false;
+        return (bits[super * words + sub / 64] >> (sub % 64)) & 1;
+    }
+};
+
 /**
  * This class keeps track of the complete protoatom (value and atom)
  * class hierarchy.
@@ -69,6 +105,26 @@ private:
      */
     mutable std::mutex type_mutex;
 
+    /* The type hierarchy, as seen by readers. Writers modify the maps
+     * below, under the type_mutex, and then set `_table` to null. A
+     * fresh table is built once, by endTypeDecls(), after all of the
+     * types of a module have been declared; a reader looking in the
+     * middle of the declarations builds one for itself.
+     *
+     * Old tables are kept, as some other thread may still be looking
+     * at one. They cannot be retired to the EpochManager: that lives
+     * in the AtomSpace library, above this one, and readers here do
+     * not enter epochs. There is one per module, so only a handful.
+     */
+    mutable std::atomic<const TypeTable*> _table;
+    mutable std::vector<std::unique_ptr<const TypeTable>> _tables;
+    const TypeTable* publish(void) const;
+
+    /* The number of types, for callers that need nothing else, such
+     * as the TypeIndex, resizing on each new type. Asking for it does
+     * not build a table. */
+    std::atomic<Type> _num_types;
+
     /* Only one module can add types at a time. */
     mutable std::mutex _module_mutex;
     mutable int _tmod;
@@ -155,24 +211,16 @@ public:
     template <typename OutputIterator>
     unsigned long getChildrenRecursive(Type type, OutputIterator result) const
     {
-        unsigned long n_children = 0;
-        for (Type i = type+1; i < nTypes; ++i) {
-            if (recursiveMap[type][i]) {
-                *(result++) = i;
-                n_children++;
-            }
-        }
-        return n_children;
+        const std::vector<Type>& subs = getSubtypes(type);
+        for (size_t i = 1; i < subs.size(); ++i)
+            *(result++) = subs[i];
+        return subs.empty() ? 0 : subs.size() - 1;
     }
     TypeSet getChildrenRecursive(Type type) const
     {
-        TypeSet ts;
-        for (Type i = type+1; i < nTypes; ++i) {
-            if (recursiveMap[type][i]) {
-                ts.insert(i);
-            }
-        }
-        return ts;
+        const std::vector<Type>& subs = getSubtypes(type);
+        if (subs.size() < 2) return TypeSet();
+        return TypeSet(subs.begin() + 1, subs.end());
     }
 
     /**
@@ -184,9 +232,10 @@ public:
     template <typename OutputIterator>
     unsigned long getParentsRecursive(Type type, OutputIterator result) const
     {
+        const TypeTable* tab = table();
         unsigned long n_parents = 0;
         for (Type i = 0; i < type; ++i) {
-            if (recursiveMap[i][type]) {
+            if (tab->isA(type, i)) {
                 *(result++) = i;
                 n_parents++;
             }
@@ -196,20 +245,39 @@ public:
     TypeSet getParentsRecursive(Type type) const
     {
         TypeSet ts;
-        for (Type i = 0; i < type; ++i) {
-            if (recursiveMap[i][type]) {
-                ts.insert(i);
-            }
-        }
+        getParentsRecursive(type, std::inserter(ts, ts.end()));
         return ts;
     }
 
     template <typename Function>
     void foreachRecursive(Function func, Type type) const
     {
-        for (Type i = 0; i < nTypes; ++i) {
-            if (recursiveMap[type][i]) (func)(i);
-        }
+        for (Type t : getSubtypes(type)) (func)(t);
+    }
+
+    /**
+     * Return all of the subtypes of `type`, recursively, in ascending
+     * order, starting with `type` itself. Empty if `type` is not
+     * defined. The reference stays valid forever, but does not see
+     * types declared later on.
+     */
+    const std::vector<Type>& getSubtypes(Type type) const
+    {
+        static const std::vector<Type> none;
+        const TypeTable* tab = table();
+        if (tab->nTypes <= type) return none;
+        return tab->subtypes[type];
+    }
+
+    /**
+     * Return the current snapshot of the type hierarchy. Does not
+     * lock, except for the first call after new types are declared.
+     */
+    const TypeTable* table(void) const
+    {
+        const TypeTable* tab = _table.load(std::memory_order_acquire);
+        if (tab) return tab;
+        return publish();
     }
 
     /**
@@ -217,7 +285,8 @@ public:
      *
      * @return The total number of classes in the system.
      */
-    Type getNumberOfClasses() const { return nTypes; }
+    Type getNumberOfClasses() const
+    { return _num_types.load(std::memory_order_acquire); }
 
     /**
      * Returns whether a given class is assignable from another.
@@ -230,25 +299,13 @@ public:
     bool isA(Type sub, Type super) const
     {
         /* Because this method is called extremely often, we want
-         * the best-case fast-path for it.  Since updates are extremely
-         * unlikely after initialization, we use a multi-reader lock,
-         * and don't care at all about writer starvation, since there
-         * will almost never be writers. However, see comments above
-         * about multi-reader-locks -- we are not using them just right
-         * now, because they don't seem to actually help.
-         *
-         * Currently, this lock accounts for 2% or 3% performance
-         * impact on atom insertion into atomspace.  The unit tests
-         * don't need it to pass.  Most users probably dont need it
-         * at all, because most type creation/update happens in
-         * shared-lib ctors, which mostly should be done by the time
-         * that this gets called. How big a price do you want to pay
-         * for avoiding a possible crash on a shared-lib load while
-         * also running some multi-threaded app?
+         * the best-case fast-path for it. Types are declared rarely,
+         * mostly in shared-lib ctors, so the hierarchy is read from
+         * an immutable table, published atomically. No lock is
+         * needed, even while some shared lib is declaring new types
+         * in another thread.
          */
-        // std::lock_guard<std::mutex> l(type_mutex);
-        if ((sub >= nTypes) || (super >= nTypes)) return false;
-        return recursiveMap[super][sub];
+        return table()->isA(sub, super);
     }
 
     bool isAncestor(Type super, Type sub) const;
@@ -317,7 +374,7 @@ public:
      * @param type Atom type code.
      * @return A corresponding hash.
      */
-    size_t getTypeHash(Type type) const { return _hash[type]; }
+    size_t getTypeHash(Type type) const { return table()->hashes[type]; }
 };
 
 NameServer& nameserver();
@@ -24,6 +24,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
 #include <set>
 #include <sstream>
 
@@ -34,6 +35,7 @@
 #include <opencog/atoms/base/Atom.h>
 #include <opencog/atoms/base/Link.h>
 #include <opencog/atoms/base/Node.h>
+#include <opencog/atoms/value/CountValue.h>
 #include <opencog/atoms/value/FloatValue.h>
 
 #include <opencog/atomspace/AtomSpace.h>
@@ -50,10 +52,6 @@ template <>
 std::weak_ptr<Atom> hashable_weak_ptr<Atom>::_dummy = std::weak_ptr<Atom>();
 #endif
 
-#if USE_MUTEX_POOL
-Atom::MutexPool Atom::_mutex_pool;
-#endif
-
 Atom::~Atom()
 {
     _atom_space = nullptr;
@@ -80,6 +78,82 @@ const Handle& truth_key(void)
 	return tk;
 }
 
+// ==============================================================
+// The KVPMap
+
+KVPMap::KVPMap(const KVPMap& other)
+{
+    *this = other;
+}
+
+KVPMap& KVPMap::operator=(const KVPMap& other)
+{
+    if (this == &other) return *this;
+    _flat = other._flat;
+    _hashed.reset(other._hashed ? new Hashed(*other._hashed) : nullptr);
+    return *this;
+}
+
+ValuePtr* KVPMap::find(const Handle& key)
+{
+    if (_hashed)
+    {
+        auto pr = _hashed->find(key);
+        if (_hashed->end() == pr) return nullptr;
+        return &pr->second;
+    }
+    auto it = lower_bound(key);
+    if (_flat.end() == it or key < it->first) return nullptr;
+    return &_flat[it - _flat.begin()].second;
+}
+
+ValuePtr& KVPMap::operator[](const Handle& key)
+{
+    if (_hashed) return (*_hashed)[key];
+
+    auto it = lower_bound(key);
+    if (_flat.end() != it and not (key < it->first))
+        return _flat[it - _flat.begin()].second;
+
+    if (_flat.size() < FLAT_MAX)
+        return _flat.insert(it, Entry(key, ValuePtr()))->second;
+
+    // Too many keys; switch to the hash table.
+    _hashed.reset(new Hashed(_flat.begin(), _flat.end()));
+    std::vector<Entry>().swap(_flat);
+    return (*_hashed)[key];
+}
+
+bool KVPMap::erase(const Handle& key)
+{
+    if (_hashed) return 0 < _hashed->erase(key);
+
+    auto it = lower_bound(key);
+    if (_flat.end() == it or key < it->first) return false;
+    _flat.erase(it);
+    return true;
+}
+
+void KVPMap::clear(void)
+{
+    std::vector<Entry>().swap(_flat);
+    _hashed.reset();
+}
+
+// Approximate heap usage of one node of a std::set or std::map, and
+// of a std::unordered_map: the tree links, or the chain link and the
+// cached hash, plus the payload.
+static constexpr size_t TREE_NODE = 32;
+static constexpr size_t HASH_NODE = 16;
+
+size_t KVPMap::bytes(void) const
+{
+    if (not _hashed)
+        return _flat.capacity() * sizeof(Entry);
+    return sizeof(Hashed) + _hashed->bucket_count() * sizeof(void*) +
+        _hashed->size() * (HASH_NODE + sizeof(Hashed::value_type));
+}
+
 // ==============================================================
 /// Setting values associated with this atom.
 /// If the value is a null pointer, then the key is removed.
@@ -109,6 +183,14 @@ void Atom::setValue(const Handle& key, const ValuePtr& value)
 	}
 }
 
+// CountValues change in place; they never leave the Atom. Everyone
+// else gets a FloatValue holding the counts, which does not change.
+static inline ValuePtr counter_snapshot(const ValuePtr& v)
+{
+    if (COUNT_VALUE != v->get_type()) return v;
+    return CountValueCast(v)->snapshot();
+}
+
 ValuePtr Atom::getValue(const Handle& key) const
 {
     // OK. The atomic thread-safety of shared-pointers is subtle. See
@@ -128,95 +210,151 @@ ValuePtr Atom::getValue(const Handle& key) const
     if ((key != truth_key()) and (*key == *truth_key()))
     {
         KVP_SHARED_LOCK;
-        auto pr = _values.find(truth_key());
-        if (_values.end() != pr) return pr->second;
+        const ValuePtr* pv = _values.find(truth_key());
+        if (pv) return counter_snapshot(*pv);
     }
     else
     {
         KVP_SHARED_LOCK;
-        auto pr = _values.find(key);
-        if (_values.end() != pr) return pr->second;
+        const ValuePtr* pv = _values.find(key);
+        if (pv) return counter_snapshot(*pv);
     }
 
     return ValuePtr();
 }
 
-ValuePtr Atom::incrementCount(const Handle& key, const std::vector<double>& count)
+// Counts are kept in CountValues, which are incremented in place,
+// while holding only the shared lock, so that many threads can count
+// on the same Atom at once. The exclusive lock is needed only to put
+// a new CountValue in place: the first time, or when it must grow.
+void Atom::incrementCount(const Handle& key, const std::vector<double>& count)
 {
+	{
+		KVP_SHARED_LOCK;
+		const ValuePtr* pv = _values.find(key);
+		if (pv and COUNT_VALUE == (*pv)->get_type() and
+		    ((CountValue*) pv->get())->add(count))
+			return;
+	}
+
 	KVP_UNIQUE_LOCK;
 
 	// Find the existing value, if it is there.
-	auto pr = _values.find(key);
-	if (_values.end() != pr)
+	ValuePtr* pv = _values.find(key);
+	if (pv)
 	{
-		ValuePtr pap = pr->second;
+		ValuePtr pap = *pv;
 
 		// Its not a float. Do nothing.
 		if (not pap->is_type(FLOAT_VALUE))
-			return pap;
-
-		// Its a float. Let it increment itself.
-		FloatValuePtr fv(FloatValueCast(pap));
-		ValuePtr nv = fv->incrementCount(count);
-
-		_values[key] = nv;
-		return nv;
+			return;
+
+		// Some other thread may have made room, while we waited.
+		if (COUNT_VALUE == pap->get_type() and
+		    CountValueCast(pap)->add(count))
+			return;
+
+		// Streams and other kinds of floats increment themselves.
+		if (FLOAT_VALUE != pap->get_type() and COUNT_VALUE != pap->get_type())
+		{
+			*pv = FloatValueCast(pap)->incrementCount(count);
+			return;
+		}
+
+		// Plain floats, and counters that are too short, are replaced
+		// by a counter that is big enough.
+		std::vector<double> new_vect =
+			FloatValueCast(counter_snapshot(pap))->value();
+		if (new_vect.size() < count.size())
+			new_vect.resize(count.size(), 0.0);
+		for (size_t idx=0; idx < count.size(); idx++)
+			new_vect[idx] += count[idx];
+		*pv = createCountValue(new_vect);
+		return;
 	}
 
 	// If we are here, an existing value was not found.
-	// Create a brand new float.
-	ValuePtr nv = createFloatValue(FLOAT_VALUE, count);
-
-	_values[key] = nv;
-	return nv;
+	// Create a brand new counter.
+	_values[key] = createCountValue(count);
 }
 
 // Cut-n-paste of the code above.
-ValuePtr Atom::incrementCount(const Handle& key, size_t idx, double count)
+void Atom::incrementCount(const Handle& key, size_t idx, double count)
 {
+	{
+		KVP_SHARED_LOCK;
+		const ValuePtr* pv = _values.find(key);
+		if (pv and COUNT_VALUE == (*pv)->get_type() and
+		    ((CountValue*) pv->get())->add(idx, count))
+			return;
+	}
+
 	KVP_UNIQUE_LOCK;
 
 	// Find the existing value, if it is there.
-	auto pr = _values.find(key);
-	if (_values.end() != pr)
+	ValuePtr* pv = _values.find(key);
+	if (pv)
 	{
-		ValuePtr pap = pr->second;
+		ValuePtr pap = *pv;
 
 		// Its not a float. Do nothing.
 		if (not pap->is_type(FLOAT_VALUE))
-			return pap;
-
-		// Its a float. Let it increment itself.
-		FloatValuePtr fv(FloatValueCast(pap));
-		ValuePtr nv = fv->incrementCount(idx, count);
-
-		_values[key] = nv;
-		return nv;
+			return;
+
+		// Some other thread may have made room, while we waited.
+		if (COUNT_VALUE == pap->get_type() and
+		    CountValueCast(pap)->add(idx, count))
+			return;
+
+		// Streams and other kinds of floats increment themselves.
+		if (FLOAT_VALUE != pap->get_type() and COUNT_VALUE != pap->get_type())
+		{
+			*pv = FloatValueCast(pap)->incrementCount(idx, count);
+			return;
+		}
+
+		// Plain floats, and counters that are too short, are replaced
+		// by a counter that is big enough.
+		std::vector<double> new_vect =
+			FloatValueCast(counter_snapshot(pap))->value();
+		if (new_vect.size() <= idx)
+			new_vect.resize(idx+1, 0.0);
+		new_vect[idx] += count;
+		*pv = createCountValue(new_vect);
+		return;
 	}
 
 	// If we are here, an existing value was not found.
 
-	// Create a brand new float.
+	// Create a brand new counter.
 	std::vector<double> new_vect;
 	new_vect.resize(idx+1, 0.0);
 	new_vect[idx] += count;
 
-	ValuePtr nv = createFloatValue(FLOAT_VALUE, new_vect);
-
-	_values[key] = nv;
-	return nv;
+	_values[key] = createCountValue(new_vect);
 }
 
 HandleSet Atom::getKeys() const
 {
     HandleSet keyset;
     KVP_SHARED_LOCK;
-    for (const auto& pr : _values)
-        keyset.insert(pr.first);
+    _values.foreach([&](const Handle& k, const ValuePtr&) {
+        keyset.insert(k);
+    });
 
     return keyset;
 }
 
+size_t Atom::foreachValue(
+    const std::function<void(const Handle&, const ValuePtr&)>& cb) const
+{
+    KVP_SHARED_LOCK;
+    _values.foreach([&](const Handle& k, const ValuePtr& v) {
+        cb(k, counter_snapshot(v));
+    });
+    return _values.bytes();
+}
+
 void Atom::copyValues(const Handle& other)
 {
     HandleSet okeys(other->getKeys());
@@ -349,6 +487,210 @@ void Atom::setAtomSpace(AtomSpace *tb)
 	#define GET_PTR(a) a
 #endif // USE_BARE_BACKPOINTER
 
+// ==============================================================
+// The InSetMap
+
+WincomingSet& InSetMap::get_bucket(Buckets& big, Type t)
+{
+    auto bucket = big.find(t);
+    if (bucket != big.end()) return bucket->second;
+
+    bucket = big.emplace(std::make_pair(t, WincomingSet())).first;
+#if USE_SPARSE_INCOMING
+    bucket->second.set_deleted_key(Handle());
+#endif
+    return bucket->second;
+}
+
+/// Move all of the inline entries to an out-of-line map of buckets.
+void InSetMap::spill(void)
+{
+    Buckets* big = new Buckets();
+    for (size_t i = 0; i < _n; i++)
+    {
+        get_bucket(*big, _types[i]).insert(_inl[i]);
+        _inl[i].~WinkPtr();
+    }
+    _big = big;
+    _n = SPILLED;
+}
+
+/// Remove the i'th inline entry, keeping the rest in order.
+void InSetMap::erase_inline(size_t i)
+{
+    for (; i+1 < _n; i++)
+    {
+        std::swap(_inl[i], _inl[i+1]);
+        _types[i] = _types[i+1];
+    }
+    _n--;
+    _inl[_n].~WinkPtr();
+}
+
+void InSetMap::clear(void)
+{
+    if (spilled())
+        delete _big;
+    else
+        for (size_t i = 0; i < _n; i++) _inl[i].~WinkPtr();
+    _n = 0;
+}
+
+InSetMap::InSetMap(const InSetMap& other) : _n(0)
+{
+    *this = other;
+}
+
+InSetMap::InSetMap(InSetMap&& other) noexcept : _n(other._n)
+{
+    if (other.spilled())
+        _big = other._big;
+    else
+    {
+        for (size_t i = 0; i < _n; i++)
+        {
+            new (&_inl[i]) WinkPtr(std::move(other._inl[i]));
+            _types[i] = other._types[i];
+            other._inl[i].~WinkPtr();
+        }
+    }
+    other._n = 0;
+}
+
+InSetMap& InSetMap::operator=(const InSetMap& other)
+{
+    if (this == &other) return *this;
+    clear();
+    if (other.spilled())
+    {
+        _big = new Buckets(*other._big);
+        _n = SPILLED;
+        return *this;
+    }
+    for (size_t i = 0; i < other._n; i++)
+    {
+        new (&_inl[i]) WinkPtr(other._inl[i]);
+        _types[i] = other._types[i];
+    }
+    _n = other._n;
+    return *this;
+}
+
+bool InSetMap::insert(Type t, const WinkPtr& w)
+{
+    if (not spilled())
+    {
+        // Entries of the same type are contiguous; look for a
+        // duplicate among them.
+        size_t i = 0;
+        while (i < _n and _types[i] < t) i++;
+        for (; i < _n and _types[i] == t; i++)
+            if (same(_inl[i], w)) return false;
+
+        if (_n < INLINE_SIZE)
+        {
+            // Append, and then bubble down into place.
+            new (&_inl[_n]) WinkPtr(w);
+            _types[_n] = t;
+            for (size_t j = _n; i < j; j--)
+            {
+                std::swap(_inl[j], _inl[j-1]);
+                std::swap(_types[j], _types[j-1]);
+            }
+            _n++;
+            return true;
+        }
+        spill();
+    }
+    return get_bucket(*_big, t).insert(w).second;
+}
+
+bool InSetMap::erase(Type t, const WinkPtr& w)
+{
+    if (not spilled())
+    {
+        for (size_t i = 0; i < _n and _types[i] <= t; i++)
+        {
+            if (_types[i] == t and same(_inl[i], w))
+            {
+                erase_inline(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const auto bucket = _big->find(t);
+    if (bucket == _big->end()) return false;
+    return 0 < bucket->second.erase(w);
+}
+
+#if not USE_BARE_BACKPOINTER
+void InSetMap::erase_expired(Type t)
+{
+    if (not spilled())
+    {
+        for (size_t i = 0; i < _n; )
+        {
+            if (_types[i] == t and 0 == _inl[i].use_count())
+                erase_inline(i);
+            else i++;
+        }
+        return;
+    }
+
+    auto bucket = _big->find(t);
+    if (bucket == _big->end()) return;
+    for (auto bi = bucket->second.begin(); bi != bucket->second.end();)
+    {
+        if (0 == bi->use_count())
+#if HAVE_SPARSEHASH
+            // sparsehash erase does not invalidate iterators.
+            bucket->second.erase(bi);
+        bi++;
+#else
+            bi = bucket->second.erase(bi);
+        else bi++;
+#endif
+    }
+}
+#endif
+
+size_t InSetMap::size(void) const
+{
+    if (not spilled()) return _n;
+    size_t cnt = 0;
+    for (const auto& bucket : *_big)
+        cnt += bucket.second.size();
+    return cnt;
+}
+
+size_t InSetMap::size(Type t) const
+{
+    if (not spilled())
+    {
+        size_t cnt = 0;
+        for (size_t i = 0; i < _n; i++)
+            if (_types[i] == t) cnt++;
+        return cnt;
+    }
+    const auto bucket = _big->find(t);
+    if (bucket == _big->end()) return 0;
+    return bucket->second.size();
+}
+
+size_t InSetMap::bytes(void) const
+{
+    if (not spilled()) return 0;
+    size_t sz = sizeof(Buckets);
+    for (const auto& bucket : *_big)
+        sz += TREE_NODE + sizeof(Buckets::value_type) +
+            bucket.second.size() * (TREE_NODE + sizeof(WinkPtr));
+    return sz;
+}
+
+// ==============================================================
+
 #if USE_INCOME_INDEX
 bool Atom::have_inset_map(void) const
 {
@@ -409,20 +751,86 @@ void Atom::insert_atom(const Handle& a)
 {
     if (not (_flags.load() & USE_ISET_FLAG)) return;
     INCOMING_UNIQUE_LOCK;
+    insert_atom_unlocked(a);
+}
 
-    Type at = a->get_type();
-    InSetMap& iset = get_inset_map();
-    auto bucket = iset.find(at);
-    if (bucket == iset.end())
+/// Add an atom to the incoming set. Caller must hold the lock.
+void Atom::insert_atom_unlocked(const Handle& a)
+{
+    get_inset_map().insert(a->get_type(), GET_PTR(a));
+}
+
+/// Call `fn(owner, link)` for each link, and each atom in its
+/// outgoing set, while holding the incoming-set lock of the owner.
+/// The calls are grouped by lock, so that each lock is taken only
+/// once.
+void Atom::foreach_owner(const HandleSeq& links,
+                         const std::function<void(Atom*, const Handle&)>& fn)
+{
+    // Triples of (lock, owner, link). The link goes into, or comes
+    // out of, the incoming set of the owner.
+    struct Owned
     {
-        auto pr = iset.emplace(
-                   std::make_pair(at, WincomingSet()));
-        bucket = pr.first;
-#if USE_SPARSE_INCOMING
-        bucket->second.set_deleted_key(Handle());
+        AtomMutex* _mtx;
+        Atom* _owner;
+        const Handle* _link;
+    };
+    std::vector<Owned> owned;
+    for (const Handle& lnk : links)
+    {
+        for (const Handle& h : lnk->getOutgoingSet())
+        {
+#if USE_MUTEX_POOL
+            AtomMutex* mtx = &incoming_mutex_pool().get_mutex(h->get_hash());
+#else
+            AtomMutex* mtx = &h->_mtx;
 #endif
+            owned.push_back({mtx, h.operator->(), &lnk});
+        }
     }
-    bucket->second.insert(GET_PTR(a));
+
+    // Stable, so that each incoming set sees the links in order.
+    std::stable_sort(owned.begin(), owned.end(),
+        [](const Owned& a, const Owned& b) { return a._mtx < b._mtx; });
+
+    size_t i = 0;
+    size_t sz = owned.size();
+    while (i < sz)
+    {
+        AtomMutex* mtx = owned[i]._mtx;
+        std::unique_lock<AtomMutex> lck(*mtx);
+        for (; i < sz and owned[i]._mtx == mtx; i++)
+        {
+            Atom* owner = owned[i]._owner;
+            if (owner->_flags.load() & USE_ISET_FLAG)
+                fn(owner, *owned[i]._link);
+        }
+    }
+}
+
+/// Place each of the links into the incoming set of each of its
+/// outgoing atoms. This is the same as calling install() on each
+/// of them, except that the incoming sets are updated in groups
+/// that share a lock, so that each lock is taken only once. This
+/// is for bulk loading; it assumes plain Links, i.e. ones that do
+/// not override install().
+void Atom::install_links(const HandleSeq& links)
+{
+    foreach_owner(links, [](Atom* owner, const Handle& lnk) {
+        owner->insert_atom_unlocked(lnk);
+    });
+}
+
+/// Take each of the links out of the incoming set of each of its
+/// outgoing atoms. The converse of install_links(); this is for
+/// bulk extraction, and assumes plain Links, i.e. ones that do not
+/// override remove().
+void Atom::remove_links(const HandleSeq& links)
+{
+    foreach_owner(links, [](Atom* owner, const Handle& lnk) {
+        if (owner->have_inset_map())
+            owner->get_inset_map().erase(lnk->get_type(), GET_PTR(lnk));
+    });
 }
 
 /// Remove an atom from the incoming set.
@@ -437,12 +845,7 @@ void Atom::remove_atom(const Handle& a)
     // extracts.
     if (not have_inset_map()) return;
 
-    InSetMap& iset = get_inset_map();
-    Type at = a->get_type();
-    const auto bucket = iset.find(at);
-
-    OC_ASSERT(bucket != iset.end(), "No bucket!");
-    bucket->second.erase(GET_PTR(a));
+    get_inset_map().erase(a->get_type(), GET_PTR(a));
 
     // Don't bother. Unit test takes this into account.
 #if 0
@@ -452,24 +855,8 @@ void Atom::remove_atom(const Handle& a)
     // empty incoming set still heelps a handle warm in the inset map.
     // This handle is counted in UseCountUTest and is flagged as an
     // error. The right answer is to just change the unit test.
-    if (0 == bucket->second.size())
-    {
-        iset.erase(at);
-        if (0 == iset.size())
-            drop_inset_map();
-    }
-#endif
-
-    // Don't bother. This never triggers.
-#if 0
-    size_t erc = bucket->second.erase(GET_PTR(a));
-    // std::set is a "true set", in that it either contains something,
-    // or it does not.  Therefore, the erase count is either 1 (the
-    // atom was found and erased) or 0 (the atom was not found, that's
-    // because it was erased earlier, e.g. it had been inserted more
-    // than once into the outgoing set. All other erase counts are ...
-    // unexpected.
-    OC_ASSERT(2 > erc, "Unexpected erase count!");
+    if (0 == get_inset_map().size())
+        drop_inset_map();
 #endif
 }
 
@@ -481,20 +868,9 @@ void Atom::swap_atom(const Handle& old, const Handle& neu)
     if (not (_flags.load() & USE_ISET_FLAG)) return;
     INCOMING_UNIQUE_LOCK;
 
-    Type ot = old->get_type();
     InSetMap& iset = get_inset_map();
-    auto bucket = iset.find(ot);
-    bucket->second.erase(GET_PTR(old));
-
-    Type nt = neu->get_type();
-    bucket = iset.find(nt);
-    if (bucket == iset.end())
-    {
-        auto pr = iset.emplace(
-                   std::make_pair(nt, WincomingSet()));
-        bucket = pr.first;
-    }
-    bucket->second.insert(GET_PTR(neu));
+    iset.erase(old->get_type(), GET_PTR(old));
+    iset.insert(neu->get_type(), GET_PTR(neu));
 }
 
 // Virtual. Derived classes want to know about incoming set add/remove.
@@ -507,13 +883,19 @@ bool Atom::isIncomingSetEmpty(const AtomSpace* as) const
     INCOMING_SHARED_LOCK;
     if (not have_inset_map()) return false;
 
-    const InSetMap& iset = get_inset_map_const();
-    for (const auto& bucket : iset)
-    {
-        for (const WinkPtr& w : bucket.second)
-            WEAKLY_DO(l, w, { if (not as or as->in_environ(l) or nameserver().isA(_type, FRAME)) return false; })
-    }
-    return true;
+    bool found = get_inset_map_const().foreach([&](const WinkPtr& w) {
+        WEAKLY_DO(l, w, { if (not as or as->in_environ(l) or nameserver().isA(_type, FRAME)) return true; })
+        return false;
+    });
+    return not found;
+}
+
+size_t Atom::getIncomingSetBytes() const
+{
+    if (not (_flags.load() & USE_ISET_FLAG)) return 0;
+    INCOMING_SHARED_LOCK;
+    if (not have_inset_map()) return 0;
+    return get_inset_map_const().bytes();
 }
 
 size_t Atom::getIncomingSetSize(const AtomSpace* as) const
@@ -534,22 +916,16 @@ size_t Atom::getIncomingSetSize(const AtomSpace* as) const
         size_t cnt = 0;
         INCOMING_SHARED_LOCK;
         if (not have_inset_map()) return 0;
-        const InSetMap& iset = get_inset_map_const();
-        for (const auto& bucket : iset)
-        {
-            for (const WinkPtr& w : bucket.second)
-                WEAKLY_DO(l, w, { if (as->in_environ(l)) cnt++; })
-        }
+        get_inset_map_const().foreach([&](const WinkPtr& w) {
+            WEAKLY_DO(l, w, { if (as->in_environ(l)) cnt++; })
+            return false;
+        });
         return cnt;
     }
 
-    size_t cnt = 0;
     INCOMING_SHARED_LOCK;
     if (not have_inset_map()) return 0;
-    const InSetMap& iset = get_inset_map_const();
-    for (const auto& pr : iset)
-        cnt += pr.second.size();
-    return cnt;
+    return get_inset_map_const().size();
 }
 
 /// Add the incoming set for this Atom only to the HandleSet.
@@ -558,29 +934,19 @@ void Atom::getLocalInc(const AtomSpace* as, HandleSet& hs, Type t) const
     INCOMING_SHARED_LOCK;
     if (not have_inset_map()) return;
 
-    if (NOTYPE != t)
-    {
-        const InSetMap& iset = get_inset_map_const();
-        const auto bucket = iset.find(t);
-        if (bucket == iset.cend()) return;
-        for (const WinkPtr& w : bucket->second)
-            WEAKLY_DO(l, w, {
-                const Handle& local(as->lookupHandle(l));
-                if (local) hs.insert(local);
-            })
-        return;
-    }
+    auto add_local = [&](const WinkPtr& w) {
+        WEAKLY_DO(l, w, {
+            const Handle& local(as->lookupHandle(l));
+            if (local) hs.insert(local);
+        })
+        return false;
+    };
 
     // If NOTYPE was given, then loop over all possibilities.
-    const InSetMap& iset = get_inset_map_const();
-    for (const auto& bucket : iset)
-    {
-        for (const WinkPtr& w : bucket.second)
-            WEAKLY_DO(l, w, {
-                const Handle& local(as->lookupHandle(l));
-                if (local) hs.insert(local);
-            })
-    }
+    if (NOTYPE != t)
+        get_inset_map_const().foreach(t, add_local);
+    else
+        get_inset_map_const().foreach(add_local);
 }
 
 /// Find all copies of this atom in deeper AtomSpaces, and add the
@@ -646,12 +1012,10 @@ IncomingSet Atom::getIncomingSet(const AtomSpace* as) const
         INCOMING_SHARED_LOCK;
         if (not have_inset_map()) return empty_set;
         IncomingSet retset;
-        const InSetMap& iset = get_inset_map_const();
-        for (const auto& bucket : iset)
-        {
-            for (const WinkPtr& w : bucket.second)
-                WEAKLY_DO(l, w, { if (as->in_environ(l)) retset.emplace_back(l); })
-        }
+        get_inset_map_const().foreach([&](const WinkPtr& w) {
+            WEAKLY_DO(l, w, { if (as->in_environ(l)) retset.emplace_back(l); })
+            return false;
+        });
         return retset;
     }
 
@@ -659,13 +1023,30 @@ IncomingSet Atom::getIncomingSet(const AtomSpace* as) const
     INCOMING_SHARED_LOCK;
     if (not have_inset_map()) return empty_set;
     IncomingSet retset;
-    const InSetMap& iset = get_inset_map_const();
-    for (const auto& bucket : iset)
+    get_inset_map_const().foreach([&](const WinkPtr& w) {
+        WEAKLY_DO(l, w, { retset.emplace_back(l); });
+        return false;
+    });
+    return retset;
+}
+
+void Atom::getIncomingWinks(std::vector<WinkPtr>& winks, Type type) const
+{
+    if (not (_flags.load() & USE_ISET_FLAG)) return;
+
+    INCOMING_SHARED_LOCK;
+    if (not have_inset_map()) return;
+    auto copy = [&](const WinkPtr& w) { winks.push_back(w); return false; };
+    if (NOTYPE == type)
     {
-        for (const WinkPtr& w : bucket.second)
-            WEAKLY_DO(l, w, { retset.emplace_back(l); });
+        winks.reserve(winks.size() + get_inset_map_const().size());
+        get_inset_map_const().foreach(copy);
+    }
+    else
+    {
+        winks.reserve(winks.size() + get_inset_map_const().size(type));
+        get_inset_map_const().foreach(type, copy);
     }
-    return retset;
 }
 
 IncomingSet Atom::getIncomingSetByType(Type type, const AtomSpace* as) const
@@ -692,26 +1073,22 @@ IncomingSet Atom::getIncomingSetByType(Type type, const AtomSpace* as) const
         // Lock to prevent updates of the set of atoms.
         INCOMING_SHARED_LOCK;
         if (not have_inset_map()) return empty_set;
-        const InSetMap& iset = get_inset_map_const();
-        const auto bucket = iset.find(type);
-        if (bucket == iset.cend()) return empty_set;
-
         IncomingSet result;
-        for (const WinkPtr& w : bucket->second)
+        get_inset_map_const().foreach(type, [&](const WinkPtr& w) {
             WEAKLY_DO(l, w, { if (as->in_environ(l)) result.emplace_back(l); })
+            return false;
+        });
         return result;
     }
 
     // Lock to prevent updates of the set of atoms.
     INCOMING_SHARED_LOCK;
     if (not have_inset_map()) return empty_set;
-    const InSetMap& iset = get_inset_map_const();
-    const auto bucket = iset.find(type);
-    if (bucket == iset.cend()) return empty_set;
-
     IncomingSet result;
-    for (const WinkPtr& w : bucket->second)
+    get_inset_map_const().foreach(type, [&](const WinkPtr& w) {
         WEAKLY_DO(l, w, { result.emplace_back(l); })
+        return false;
+    });
     return result;
 }
 
@@ -734,23 +1111,19 @@ size_t Atom::getIncomingSetSizeByType(Type type, const AtomSpace* as) const
 
         INCOMING_SHARED_LOCK;
         if (not have_inset_map()) return 0;
-        const InSetMap& iset = get_inset_map_const();
-        const auto bucket = iset.find(type);
-        if (bucket == iset.cend()) return 0;
-
-        for (const WinkPtr& w : bucket->second)
+        get_inset_map_const().foreach(type, [&](const WinkPtr& w) {
             WEAKLY_DO(l, w, { if (as->in_environ(l)) cnt++; })
+            return false;
+        });
         return cnt;
     }
 
     INCOMING_SHARED_LOCK;
     if (not have_inset_map()) return 0;
-    const InSetMap& iset = get_inset_map_const();
-    const auto bucket = iset.find(type);
-    if (bucket == iset.cend()) return 0;
-
-    for (const WinkPtr& w : bucket->second)
+    get_inset_map_const().foreach(type, [&](const WinkPtr& w) {
         WEAKLY_DO(l, w, { cnt++; })
+        return false;
+    });
     return cnt;
 }
 
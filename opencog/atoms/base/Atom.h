@@ -27,12 +27,16 @@
 #ifndef _OPENCOG_ATOM_H
 #define _OPENCOG_ATOM_H
 
+#include <algorithm>
 #include <atomic>
 #include <functional>
+#include <map>
 #include <memory>
 #include <shared_mutex>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #if HAVE_SPARSEHASH
 #include <sparsehash/sparse_hash_set>
@@ -48,6 +52,8 @@
 #include <opencog/util/exceptions.h>
 
 #include <opencog/atoms/base/Handle.h>
+#include <opencog/atoms/base/MutexPool.h>
+#include <opencog/atoms/base/SlabAllocator.h>
 #include <opencog/atoms/value/Value.h>
 #include <opencog/atoms/value/BoolValue.h>
 
@@ -203,10 +209,119 @@ typedef folly::F14ValueSet<WinkPtr> WincomingSet;
 typedef std::set<WinkPtr, std::owner_less<WinkPtr> > WincomingSet;
 #endif
 
+/**
+ * The incoming set of an Atom, bucketed by the type of the incoming
+ * Link. Most Atoms have only a few incoming Links, typically one to
+ * three, and a std::map of per-type sets is very wasteful for these:
+ * each populated type costs a map node, plus a set node per Link,
+ * i.e. about 150 bytes for an Atom with just one incoming Link.
+ *
+ * So small incoming sets are stored inline, as a flat array of
+ * (Type, WinkPtr) pairs, kept sorted by type. When the array
+ * overflows, the entries are moved to an out-of-line map of per-type
+ * buckets, and stay there. Large incoming sets (10K Links are not
+ * unusual) thus keep the fast insert and remove of WincomingSet.
+ *
+ * This is not thread-safe; the Atom lock protects it.
+ */
+class InSetMap
+{
+public:
+    typedef std::map<Type, WincomingSet> Buckets;
+
+    // Inline entries share space with the pointer to the Buckets.
+    // For std::weak_ptr, this is three entries, in the same 48 bytes
+    // that a std::map uses.
+    static constexpr size_t INLINE_SIZE =
+        (48 / sizeof(WinkPtr) < 2) ? 2 : 48 / sizeof(WinkPtr);
+
+private:
+    static constexpr uint8_t SPILLED = 0xff;
+
+    union
+    {
+        WinkPtr _inl[INLINE_SIZE];
+        Buckets* _big;
+    };
+    Type _types[INLINE_SIZE];
+    uint8_t _n;  // Number of inline entries, or SPILLED.
+
+    static bool same(const WinkPtr& a, const WinkPtr& b)
+    {
+        std::owner_less<WinkPtr> less;
+        return not less(a, b) and not less(b, a);
+    }
+    static WincomingSet& get_bucket(Buckets&, Type);
+    void spill(void);
+    void erase_inline(size_t);
+    void clear(void);
+
+public:
+    InSetMap(void) : _n(0) {}
+    InSetMap(const InSetMap&);
+    InSetMap(InSetMap&&) noexcept;
+    InSetMap& operator=(const InSetMap&);
+    ~InSetMap() { clear(); }
+
+    /// True if the entries have moved out-of-line.
+    bool spilled(void) const { return SPILLED == _n; }
+
+    /// Add the Link, if it is not already there. Return true if added.
+    bool insert(Type, const WinkPtr&);
+
+    /// Remove the Link. Return true if it was there.
+    bool erase(Type, const WinkPtr&);
+
+#if not USE_BARE_BACKPOINTER
+    /// Remove all expired Links of the given type.
+    void erase_expired(Type);
+#endif
+
+    /// Number of entries, including any that might have expired.
+    size_t size(void) const;
+    size_t size(Type) const;
+
+    /// Bytes of heap in use, beyond sizeof(InSetMap). Approximate.
+    size_t bytes(void) const;
+
+    /// Call `cb` on each entry, until it returns true. Return true
+    /// if the walk was stopped.
+    template<class CB>
+    bool foreach(CB cb) const
+    {
+        if (not spilled())
+        {
+            for (size_t i = 0; i < _n; i++)
+                if (cb(_inl[i])) return true;
+            return false;
+        }
+        for (const auto& bucket : *_big)
+            for (const WinkPtr& w : bucket.second)
+                if (cb(w)) return true;
+        return false;
+    }
+
+    /// Call `cb` on each entry of the given type, until it returns
+    /// true. Return true if the walk was stopped.
+    template<class CB>
+    bool foreach(Type t, CB cb) const
+    {
+        if (not spilled())
+        {
+            for (size_t i = 0; i < _n and _types[i] <= t; i++)
+                if (_types[i] == t and cb(_inl[i])) return true;
+            return false;
+        }
+        const auto bucket = _big->find(t);
+        if (bucket == _big->end()) return false;
+        for (const WinkPtr& w : bucket->second)
+            if (cb(w)) return true;
+        return false;
+    }
+};
+
 // ----------------------------------------------------
 // Other maps.
-typedef std::map<Type, WincomingSet> InSetMap;
-
 #if USE_SPARSE_KVP
 typedef google::sparse_hash_map<Handle, ValuePtr> KVPMap;
 
@@ -216,7 +331,76 @@ typedef google::sparse_hash_map<Handle, ValuePtr> KVPMap;
 // Anyway, we disable, to avoid screw-ups.
 #error "USE_SPARSE_KVP is enabled! It works, but you probably did this by accident. If you meant to do this, edit the header file and try again."
 #else
-typedef std::map<const Handle, ValuePtr> KVPMap;
+
+/**
+ * The Values attached to an Atom, indexed by key. Almost all Atoms
+ * carry zero, one or two Values (e.g. a count and a mutual information)
+ * and a std::map, at 48 bytes plus a 64-byte tree node per key, is
+ * mostly overhead. So a handful of keys are kept in a flat vector,
+ * sorted the same way that std::map would sort them; past FLAT_MAX
+ * keys, everything moves to a hash table.
+ *
+ * Keys are compared by content, just as with std::map<Handle>: setting
+ * a Value with a free-floating copy of a key overwrites the Value that
+ * was set with the original key.
+ *
+ * This is not thread-safe; the KVP lock protects it.
+ */
+class KVPMap
+{
+    typedef std::pair<Handle, ValuePtr> Entry;
+    typedef std::unordered_map<Handle, ValuePtr> Hashed;
+
+    static constexpr size_t FLAT_MAX = 8;
+
+    std::vector<Entry> _flat;
+    std::unique_ptr<Hashed> _hashed;
+
+    std::vector<Entry>::const_iterator
+    lower_bound(const Handle& key) const
+    {
+        return std::lower_bound(_flat.begin(), _flat.end(), key,
+            [](const Entry& e, const Handle& k) { return e.first < k; });
+    }
+
+public:
+    KVPMap(void) {}
+    KVPMap(const KVPMap&);
+    KVPMap& operator=(const KVPMap&);
+
+    /// Return a pointer to the Value for the key, or nullptr if
+    /// there is none. The pointer is invalidated by any insertion
+    /// or removal.
+    ValuePtr* find(const Handle&);
+    const ValuePtr* find(const Handle& key) const
+        { return const_cast<KVPMap*>(this)->find(key); }
+
+    /// Return the Value for the key, inserting a null one if absent.
+    ValuePtr& operator[](const Handle&);
+
+    /// Remove the key. Return true if it was there.
+    bool erase(const Handle&);
+
+    void clear(void);
+    bool empty(void) const
+        { return _hashed ? _hashed->empty() : _flat.empty(); }
+    size_t size(void) const
+        { return _hashed ? _hashed->size() : _flat.size(); }
+
+    /// Bytes of heap in use, beyond sizeof(KVPMap), not counting the
+    /// Values themselves. Approximate.
+    size_t bytes(void) const;
+
+    /// Call `cb(key, value)` on each entry.
+    template<class CB>
+    void foreach(CB cb) const
+    {
+        if (_hashed)
+            for (const auto& pr : *_hashed) cb(pr.first, pr.second);
+        else
+            for (const Entry& e : _flat) cb(e.first, e.second);
+    }
+};
 #endif
 
 /**
@@ -235,23 +419,24 @@ typedef std::map<const Handle, ValuePtr> KVPMap;
  * --  4 Bytes Type _type plus 4 bool flags.
  * --  8 Bytes ContentHash _content_hash;
  * --  8 Bytes AtomSpace *_atom_space;
- * -- 48 Bytes std::map<const Handle, ValuePtr> _values;
- * -- 48 Bytes std::map<Type, WincomingSet> _incoming_set;
- * Total: 144 Bytes for a base naked Atom.
+ * -- 32 Bytes KVPMap _values; (plus 32 per key, out-of-line)
+ * -- 56 Bytes InSetMap _incoming_set; (holds three Links inline)
+ * Total: 136 Bytes for a base naked Atom.
  *
  * Node: Additional 32 Bytes for std::string _name + sizeof(chars of string)
  * Link: Additional 24 Bytes for std::vector _outgoing + 16*(_outgoing.size());
  *       A "typical" Link of size 2 is 200 Bytes, outside of AtomSpace
  *
  * Inserted into the AtomSpace: ?? per hash bucket. I guess 24 or 32
- * Per addition to incoming set: 64 per std::_Rb_tree node
+ * Per addition to incoming set: nothing, for the first three. After
+ *   that, 64 per std::_Rb_tree node, plus the map of buckets.
  * With a value of three doubles, e.g. FloatValue:
  * -- 24 Bytes std::enable_shared_from_this<Value>
  * --  8 Bytes Type _type plus padding
  * -- 24 Bytes std::vector<double> _value
  * -- 24 Bytes 3*sizeof(double)
- * -- 64 std::_Rb_tree node in the Atom holding the TV
- * Total: 144 Bytes per FloatValue (ouch).
+ * -- 32 Bytes KVPMap entry in the Atom holding the TV
+ * Total: 112 Bytes per FloatValue (ouch).
  *
  * A "typical" Link of size 2, held in one other Link, in AtomSpace,
  *   holding a FloatValue in it: 344 Bytes. With a large incomnig set,
@@ -309,22 +494,21 @@ protected:
     //
     // CPU usage improves 3% to 6%, probably because the shrinkage
     // fits into the cache better.
-    struct MutexPool
-    {
-        static constexpr size_t POOL_SIZE = 64;
-        mutable std::shared_mutex mutexes[POOL_SIZE];
-        inline std::shared_mutex& get_mutex(ContentHash hsh) {
-            return mutexes[hsh % POOL_SIZE];
-        }
-    };
-    static MutexPool _mutex_pool;
-
-    #define _MTX (_mutex_pool.get_mutex(_content_hash))
-    #define INCOMING_SHARED_LOCK std::shared_lock<std::shared_mutex> lck(_MTX);
-    #define INCOMING_UNIQUE_LOCK std::unique_lock<std::shared_mutex> lck(_MTX);
-    #define KVP_UNIQUE_LOCK std::unique_lock<std::shared_mutex> lck(_MTX);
-    #define KVP_SHARED_LOCK std::shared_lock<std::shared_mutex> lck(_MTX);
+    //
+    // There are two pools: one for the Values, and one for the
+    // incoming sets, so that heavy Value updates, e.g. incrementCount
+    // from many threads, do not stall incoming-set walks on unrelated
+    // Atoms. Pool sizes are set at startup; see MutexPool.h. Lock
+    // contention can be watched with `get_stats()` on either pool.
+    typedef PoolMutex AtomMutex;
+    #define _KVP_MTX (kvp_mutex_pool().get_mutex(_content_hash))
+    #define _INCOMING_MTX (incoming_mutex_pool().get_mutex(_content_hash))
+    #define INCOMING_SHARED_LOCK std::shared_lock<PoolMutex> lck(_INCOMING_MTX);
+    #define INCOMING_UNIQUE_LOCK std::unique_lock<PoolMutex> lck(_INCOMING_MTX);
+    #define KVP_UNIQUE_LOCK std::unique_lock<PoolMutex> lck(_KVP_MTX);
+    #define KVP_SHARED_LOCK std::shared_lock<PoolMutex> lck(_KVP_MTX);
 #else
+    typedef std::shared_mutex AtomMutex;
     #define INCOMING_SHARED_LOCK std::shared_lock<std::shared_mutex> lck(_mtx);
     #define INCOMING_UNIQUE_LOCK std::unique_lock<std::shared_mutex> lck(_mtx);
     #define KVP_UNIQUE_LOCK std::unique_lock<std::shared_mutex> lck(_mtx);
@@ -413,7 +597,9 @@ private:
         // be the source of bottlenecks.  Note that an atomspace can
         // contain a hundred-million atoms, so the solution has to be
         // small. This rules out using a vector to store the
-        // buckets (I tried).
+        // buckets (I tried). The exception is the very common case
+        // of an Atom with only a few incoming Links; those are kept
+        // in a flat array. See InSetMap.
         // std::map<Type, WincomingSet> _iset;
         InSetMap _iset;
     };
@@ -436,11 +622,18 @@ protected:
 
     // Insert and remove links from the incoming set.
     void insert_atom(const Handle&);
+    void insert_atom_unlocked(const Handle&);
     void remove_atom(const Handle&);
     void swap_atom(const Handle&, const Handle&);
     virtual void install();
     virtual void remove();
 
+    // Same as install() and remove(), for many Links at once.
+    static void install_links(const HandleSeq&);
+    static void remove_links(const HandleSeq&);
+    static void foreach_owner(const HandleSeq&,
+                              const std::function<void(Atom*, const Handle&)>&);
+
     virtual ContentHash compute_hash() const = 0;
 
 private:
@@ -477,6 +670,22 @@ public:
     virtual ~Atom();
     virtual bool is_atom() const { return true; }
 
+#if USE_MUTEX_POOL
+    /// The locks protecting the Values, and the incoming sets, of all
+    /// Atoms. These are never freed, as Atoms may outlive the static
+    /// destructors. (Same reason as for the nameserver().)
+    static MutexPool& kvp_mutex_pool(void)
+    {
+        static MutexPool* pool = new MutexPool(MutexPool::env_size());
+        return *pool;
+    }
+    static MutexPool& incoming_mutex_pool(void)
+    {
+        static MutexPool* pool = new MutexPool(MutexPool::env_size());
+        return *pool;
+    }
+#endif
+
     //! Returns the AtomSpace in which this Atom is inserted.
     AtomSpace* getAtomSpace() const { return _atom_space; }
 
@@ -561,9 +770,11 @@ public:
     virtual void setValue(const Handle& key, const ValuePtr& value);
     /// Get value at `key` for this atom.
     virtual ValuePtr getValue(const Handle& key) const;
-    /// Atomically increment a generic FloatValue.
-    ValuePtr incrementCount(const Handle& key, const std::vector<double>&);
-    ValuePtr incrementCount(const Handle& key, size_t idx, double);
+    /// Atomically increment a generic FloatValue. The counts are
+    /// kept in a CountValue, and are updated in place; getValue()
+    /// returns a FloatValue snapshot of them.
+    void incrementCount(const Handle& key, const std::vector<double>&);
+    void incrementCount(const Handle& key, size_t idx, double);
 
     /// Return true if this Atom is used as a key, somewhere, anywhere.
     bool isKey() const { return _flags.load() & IS_KEY_FLAG; }
@@ -589,6 +800,12 @@ public:
     /// Print all of the key-value pairs.
     std::string valuesToString() const;
 
+    /// Call `cb` on each key and Value, while holding the lock; the
+    /// callback must not touch the Values on this Atom. Returns the
+    /// bytes of heap used by the key-value map itself, not counting
+    /// the Values. Used for memory accounting.
+    size_t foreachValue(const std::function<void(const Handle&, const ValuePtr&)>&) const;
+
     /// Remove all values. The only anticipated users of this are the
     // storage backends, manipulating multi-AtomSpace bulk loads.
     void clearValues();
@@ -600,6 +817,10 @@ public:
     //! Get the size of the incoming set.
     size_t getIncomingSetSize(const AtomSpace* = nullptr) const;
 
+    //! Bytes of heap used by the incoming set, beyond sizeof(Atom).
+    //! Approximate; used for memory accounting.
+    size_t getIncomingSetBytes() const;
+
     //! Return the incoming set of this atom.
     //! If the AtomSpace pointer is non-null, then only those atoms
     //! that belonged to that atomspace at the time this call was made
@@ -617,6 +838,11 @@ public:
     /** Return the size of the incoming set, for the given type. */
     size_t getIncomingSetSizeByType(Type, const AtomSpace* = nullptr) const;
 
+    /** Append the incoming set (of the given type, if not NOTYPE) to
+     *  the vector, as weak pointers. Used by IncomingCursor, which
+     *  turns these into Handles only as they are consumed. */
+    void getIncomingWinks(std::vector<WinkPtr>&, Type = NOTYPE) const;
+
     // ---------------------------------------------------
     /** Returns a string representation of the node. */
     virtual std::string to_string(const std::string& indent) const = 0;
@@ -665,7 +891,20 @@ public:
     static inline CNAME##Ptr CNAME##Cast(const ValuePtr& v) \
         { return std::dynamic_pointer_cast<CNAME>(v); }
 
+// Allocate Atoms out of size-class slabs, with a per-thread cache of
+// free blocks, instead of from the general-purpose heap. This saves
+// the malloc headers (about 16 bytes per Atom), keeps the Atoms of a
+// bulk load packed together, and avoids the heap lock when many
+// threads create Atoms at once. Memory freed by extracting Atoms is
+// re-used for new Atoms, but is never returned to the OS. Comment
+// this out to use std::make_shared.
+#define USE_SLAB_ALLOCATOR 1
+
+#if USE_SLAB_ALLOCATOR
+#define CREATE_DECL(CNAME)  slab_create<CNAME>
+#else
 #define CREATE_DECL(CNAME)  std::make_shared<CNAME>
+#endif
 
 static inline Handle HandleCast(const ValuePtr& pa)
     { return Handle(std::dynamic_pointer_cast<Atom>(pa)); }
@@ -94,6 +94,7 @@ public:
      * Declare a factory for an atom type.
      */
     void addFactory(Type, AtomFactory*);
+    bool hasFactory(Type t) const { return nullptr != getFactory(t); }
 
     /**
      * Declare a validator for an atom type.
@@ -28,6 +28,7 @@
 
 #include <opencog/atoms/atom_types/NameServer.h>
 #include <opencog/atoms/base/Node.h>
+#include <opencog/atoms/base/hash.h>
 
 #include "Link.h"
 
@@ -158,23 +159,20 @@ bool Link::operator<(const Atom& other) const
 /// Returns a Merkle tree hash -- that is, the hash of this link
 /// chains the hash values of the child atoms, as well.
 ContentHash Link::compute_hash() const
+{
+	return compute_hash(get_type(), _outgoing.data(), _outgoing.size());
+}
+
+ContentHash Link::compute_hash(Type t, const Handle* outgoing, size_t arity)
 {
 	// The nameserver().getTypeHash() returns hash of the type name
 	// string, and is thus independent of all other type declarations.
 	// 1<<44 - 377 is prime
-	ContentHash hsh = ((1ULL<<44) - 377) * nameserver().getTypeHash(get_type());
-
-	for (const Handle& h: _outgoing)
-	{
-		hsh += (hsh <<5) ^ (353 * h->get_hash()); // recursive!
-
-		// Bit-mixing copied from murmur64. Yes, this is needed.
-		hsh ^= hsh >> 33;
-		hsh *= 0xff51afd7ed558ccdL;
-		hsh ^= hsh >> 33;
-		hsh *= 0xc4ceb9fe1a85ec53L;
-		hsh ^= hsh >> 33;
-	}
+	ContentHash hsh = ((1ULL<<44) - 377) * nameserver().getTypeHash(t);
+
+	// Order matters; this is not a set. See hash.h for the mixing.
+	hsh = hash_sequence(hsh, arity,
+		[&](size_t i) { return outgoing[i]->get_hash(); }); // recursive!
 
 	// Links will always have the MSB set.
 	ContentHash mask = ((ContentHash) 1ULL) << (8*sizeof(ContentHash) - 1);
@@ -46,6 +46,8 @@ namespace opencog
  */
 class Link : public Atom
 {
+    friend class AtomSpace;       // Needs to re-point _outgoing in squash()
+
 private:
     void init();
 
@@ -59,6 +61,13 @@ protected:
     virtual ContentHash compute_hash() const;
 
 public:
+    /**
+     * The hash that a Link of type t, with the given outgoing set,
+     * would have. Lets lookups skip making a temporary Link.
+     */
+    static ContentHash compute_hash(Type t, const Handle* outgoing,
+                                    size_t arity);
+
     /**
      * Constructor for this class.
      *
@@ -210,7 +219,7 @@ LINK_PTR_DECL(Link);
 template< class... Args >
 Handle createLink( Args&&... args )
 {
-	Handle tmp(std::make_shared<Link>(std::forward<Args>(args) ...));
+	Handle tmp(CREATE_DECL(Link)(std::forward<Args>(args) ...));
 	return classserver().factory(tmp);
 }
 
@@ -0,0 +1,102 @@
+/*
+ * opencog/atoms/base/MutexPool.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+#include "MutexPool.h"
+
+using namespace opencog;
+
+// ================================================================
+
+MutexStats PoolMutex::get_stats(void) const
+{
+	MutexStats ms;
+#if USE_MUTEX_POOL_STATS
+	ms.acquired = _acquired.load(std::memory_order_relaxed);
+	ms.contended = _contended.load(std::memory_order_relaxed);
+	ms.wait_ns = _wait_ns.load(std::memory_order_relaxed);
+#endif
+	return ms;
+}
+
+void PoolMutex::reset_stats(void)
+{
+#if USE_MUTEX_POOL_STATS
+	_acquired.store(0, std::memory_order_relaxed);
+	_contended.store(0, std::memory_order_relaxed);
+	_wait_ns.store(0, std::memory_order_relaxed);
+#endif
+}
+
+// ================================================================
+
+MutexPool::MutexPool(size_t size)
+{
+	if (0 == size)
+		size = std::max<size_t>(64, 4 * std::thread::hardware_concurrency());
+
+	size_t sz = 1;
+	while (sz < size) sz <<= 1;
+	_mask = sz - 1;
+	_slots.reset(new PoolMutex[sz]);
+}
+
+size_t MutexPool::env_size(void)
+{
+	const char* env = getenv("OPENCOG_MUTEX_POOL_SIZE");
+	if (nullptr == env) return 0;
+	long sz = atol(env);
+	if (sz <= 0) return 0;
+	return sz;
+}
+
+std::vector<MutexStats> MutexPool::get_stats(void) const
+{
+	std::vector<MutexStats> stats;
+	stats.reserve(size());
+	for (size_t i = 0; i < size(); i++)
+		stats.push_back(_slots[i].get_stats());
+	return stats;
+}
+
+MutexStats MutexPool::get_total(void) const
+{
+	MutexStats total;
+	for (size_t i = 0; i < size(); i++)
+	{
+		MutexStats ms(_slots[i].get_stats());
+		total.acquired += ms.acquired;
+		total.contended += ms.contended;
+		total.wait_ns += ms.wait_ns;
+	}
+	return total;
+}
+
+void MutexPool::reset_stats(void)
+{
+	for (size_t i = 0; i < size(); i++)
+		_slots[i].reset_stats();
+}
+
+// ======================= END OF FILE =================
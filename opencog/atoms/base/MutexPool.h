@@ -0,0 +1,160 @@
+/*
+ * opencog/atoms/base/MutexPool.h
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_MUTEX_POOL_H
+#define _OPENCOG_MUTEX_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+namespace opencog
+{
+/** \addtogroup grp_atomspace
+ *  @{
+ */
+
+// Count lock acquisitions, and time spent waiting, for each mutex in
+// the pool. The uncontended path costs one relaxed increment; the
+// clock is read only when the lock is busy. Comment out the line
+// below to disable.
+#define USE_MUTEX_POOL_STATS 1
+
+/// Lock statistics, for one mutex or for a whole pool.
+struct MutexStats
+{
+	uint64_t acquired = 0;   // Number of times locked, shared or not.
+	uint64_t contended = 0;  // Number of those that had to wait.
+	uint64_t wait_ns = 0;    // Total time spent waiting, in nanosecs.
+};
+
+/**
+ * A reader-writer lock, with statistics. Meets the SharedMutex
+ * requirements, so it can be used with std::shared_lock and
+ * std::unique_lock. Each one gets its own cache lines, so that
+ * neighbors in the pool do not bounce each other.
+ */
+class alignas(64) PoolMutex
+{
+	std::shared_mutex _mtx;
+#if USE_MUTEX_POOL_STATS
+	std::atomic<uint64_t> _acquired;
+	std::atomic<uint64_t> _contended;
+	std::atomic<uint64_t> _wait_ns;
+
+	typedef std::chrono::steady_clock clock;
+	void waited(clock::time_point start)
+	{
+		uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>
+			(clock::now() - start).count();
+		_acquired.fetch_add(1, std::memory_order_relaxed);
+		_contended.fetch_add(1, std::memory_order_relaxed);
+		_wait_ns.fetch_add(ns, std::memory_order_relaxed);
+	}
+#endif
+
+public:
+#if USE_MUTEX_POOL_STATS
+	PoolMutex(void) : _acquired(0), _contended(0), _wait_ns(0) {}
+
+	void lock(void)
+	{
+		if (_mtx.try_lock())
+		{
+			_acquired.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		clock::time_point start = clock::now();
+		_mtx.lock();
+		waited(start);
+	}
+
+	void lock_shared(void)
+	{
+		if (_mtx.try_lock_shared())
+		{
+			_acquired.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		clock::time_point start = clock::now();
+		_mtx.lock_shared();
+		waited(start);
+	}
+#else
+	void lock(void) { _mtx.lock(); }
+	void lock_shared(void) { _mtx.lock_shared(); }
+#endif
+
+	bool try_lock(void) { return _mtx.try_lock(); }
+	bool try_lock_shared(void) { return _mtx.try_lock_shared(); }
+	void unlock(void) { _mtx.unlock(); }
+	void unlock_shared(void) { _mtx.unlock_shared(); }
+
+	MutexStats get_stats(void) const;
+	void reset_stats(void);
+};
+
+/**
+ * A fixed pool of locks, picked by hash. Atoms use these, rather than
+ * holding a lock of their own, which would cost 56 bytes per Atom.
+ * Two unrelated Atoms that land in the same slot contend with each
+ * other; the remedy is a bigger pool.
+ *
+ * The size is fixed when the pool is created, and is rounded up to a
+ * power of two. The default is four times the number of CPUs, but no
+ * less than 64. For the pools used by the Atoms, it can be set with
+ * the OPENCOG_MUTEX_POOL_SIZE environment variable.
+ */
+class MutexPool
+{
+	size_t _mask;
+	std::unique_ptr<PoolMutex[]> _slots;
+
+public:
+	MutexPool(size_t size = 0);
+
+	/// The size requested by OPENCOG_MUTEX_POOL_SIZE, if it is set,
+	/// else zero, meaning "use the default".
+	static size_t env_size(void);
+
+	PoolMutex& get_mutex(uint64_t hsh) const
+	{
+		return _slots[hsh & _mask];
+	}
+
+	size_t size(void) const { return _mask + 1; }
+
+	/// Statistics, one entry per slot.
+	std::vector<MutexStats> get_stats(void) const;
+
+	/// Statistics, summed over all slots.
+	MutexStats get_total(void) const;
+
+	void reset_stats(void);
+};
+
+/** @}*/
+} // namespace opencog
+
+#endif // _OPENCOG_MUTEX_POOL_H
@@ -0,0 +1,183 @@
+/*
+ * opencog/atoms/base/NamePool.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstring>
+
+#include <opencog/atoms/base/hash.h>
+
+#include "NamePool.h"
+
+using namespace opencog;
+
+// ================================================================
+
+uint64_t NamePool::hash(const char* s, size_t len)
+{
+	return name_hash(s, len);
+}
+
+size_t NamePool::Shard::home(const Entry* e) const
+{
+	return home(hash(e->_str.data(), e->_str.size()));
+}
+
+// Keep the tables at most half full.
+void NamePool::Shard::grow(void)
+{
+	size_t cap = _slots.empty() ? 16 : 2 * _slots.size();
+	std::vector<Entry*> old(cap, nullptr);
+	old.swap(_slots);
+	_shift = 64 - __builtin_ctzll(cap);
+
+	size_t mask = cap - 1;
+	for (Entry* e : old)
+	{
+		if (nullptr == e) continue;
+		size_t i = home(e);
+		while (_slots[i]) i = (i+1) & mask;
+		_slots[i] = e;
+	}
+}
+
+// Linear probing, with no tombstones: the entries after the hole
+// that would no longer be found are shifted back into it.
+void NamePool::Shard::erase(Entry* e)
+{
+	size_t mask = _slots.size() - 1;
+	size_t i = home(e);
+	while (_slots[i] != e) i = (i+1) & mask;
+	_slots[i] = nullptr;
+	_size--;
+
+	size_t j = i;
+	while (true)
+	{
+		j = (j+1) & mask;
+		Entry* f = _slots[j];
+		if (nullptr == f) return;
+
+		// Leave f alone if its home is cyclically in (i, j].
+		size_t k = home(f);
+		if (i < j ? (i < k and k <= j) : (i < k or k <= j)) continue;
+
+		_slots[i] = f;
+		_slots[j] = nullptr;
+		i = j;
+	}
+}
+
+// ================================================================
+
+NamePool::Entry* NamePool::intern(const char* s, size_t len,
+                                  std::string* movable)
+{
+	uint64_t hsh = hash(s, len);
+	Shard& sh = shard(hsh);
+	std::lock_guard<std::mutex> lck(sh._mtx);
+
+	if (sh._slots.size() < 2 * (sh._size + 1)) sh.grow();
+
+	size_t mask = sh._slots.size() - 1;
+	size_t i = sh.home(hsh);
+	for (; sh._slots[i]; i = (i+1) & mask)
+	{
+		Entry* e = sh._slots[i];
+		if (e->_str.size() == len and 0 == memcmp(e->_str.data(), s, len))
+		{
+			// Under the lock, so cannot race with the final release.
+			e->_refs.fetch_add(1, std::memory_order_relaxed);
+			return e;
+		}
+	}
+
+	Entry* e = movable ?
+		new Entry(std::move(*movable)) :
+		new Entry(std::string(s, len));
+	sh._slots[i] = e;
+	sh._size++;
+	return e;
+}
+
+void NamePool::release(Entry* e)
+{
+	// Dropping a reference that is not the last one takes no lock.
+	uint32_t refs = e->_refs.load(std::memory_order_relaxed);
+	while (1 < refs)
+	{
+		if (e->_refs.compare_exchange_weak(refs, refs - 1,
+		                                   std::memory_order_acq_rel))
+			return;
+	}
+
+	// Possibly the last one. Recheck under the lock, because
+	// someone may have interned the same name in the meanwhile.
+	Shard& sh = shard(hash(e->_str.data(), e->_str.size()));
+	{
+		std::lock_guard<std::mutex> lck(sh._mtx);
+		if (1 < e->_refs.fetch_sub(1, std::memory_order_acq_rel))
+			return;
+		sh.erase(e);
+	}
+	delete e;
+}
+
+// ================================================================
+
+size_t NamePool::size(void)
+{
+	size_t n = 0;
+	for (Shard& sh : _shards)
+	{
+		std::lock_guard<std::mutex> lck(sh._mtx);
+		n += sh._size;
+	}
+	return n;
+}
+
+size_t NamePool::bytes(void)
+{
+	size_t n = sizeof(NamePool);
+	for (Shard& sh : _shards)
+	{
+		std::lock_guard<std::mutex> lck(sh._mtx);
+		n += sh._slots.capacity() * sizeof(Entry*);
+		for (const Entry* e : sh._slots)
+		{
+			if (nullptr == e) continue;
+			n += sizeof(Entry);
+
+			// Short strings live inside the std::string itself.
+			const char* p = e->_str.data();
+			const char* base = reinterpret_cast<const char*>(e);
+			if (p < base or base + sizeof(Entry) <= p)
+				n += e->_str.capacity() + 1;
+		}
+	}
+	return n;
+}
+
+NamePool& opencog::namepool(void)
+{
+	static NamePool* pool = new NamePool();
+	return *pool;
+}
+
+// ======================= END OF FILE =================
@@ -0,0 +1,162 @@
+/*
+ * opencog/atoms/base/NamePool.h
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_NAME_POOL_H
+#define _OPENCOG_NAME_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace opencog
+{
+/** \addtogroup grp_atomspace
+ *  @{
+ */
+
+/**
+ * Intern pool for Node names.
+ *
+ * The same name often appears under several types: (WordNode "dog"),
+ * (ConceptNode "dog"), (PredicateNode "dog"). With the pool, all of
+ * these share one copy of the string. Each distinct name is held in
+ * an Entry, together with a reference count. When the last reference
+ * is released, the Entry is removed from the pool and freed.
+ *
+ * No hash is kept in the Entry; the Node hash is seeded with the type,
+ * so it could not be reused anyway. The pool hashes the name again
+ * when it needs to find its slot, which is cheap next to the lock.
+ *
+ * The pool is split into shards, picked by the hash, each with its
+ * own lock, so that threads creating Nodes do not all serialize on
+ * one mutex. Each shard is an open-addressing table of pointers.
+ */
+class NamePool
+{
+public:
+	struct Entry
+	{
+		std::string _str;
+		std::atomic<uint32_t> _refs;
+
+		Entry(std::string&& s) : _str(std::move(s)), _refs(1) {}
+	};
+
+private:
+	struct Shard
+	{
+		std::mutex _mtx;
+		std::vector<Entry*> _slots;
+		size_t _size = 0;
+		int _shift = 64;
+
+		size_t home(uint64_t hsh) const {
+			return (hsh * 0x9e3779b97f4a7c15ULL) >> _shift;
+		}
+		size_t home(const Entry*) const;
+		void grow(void);
+		void erase(Entry*);
+	};
+
+	static constexpr size_t NSHARDS = 64;
+	Shard _shards[NSHARDS];
+
+	Shard& shard(uint64_t hsh) { return _shards[hsh % NSHARDS]; }
+	static uint64_t hash(const char*, size_t);
+	Entry* intern(const char*, size_t, std::string*);
+
+public:
+	NamePool(void) {}
+	NamePool(const NamePool&) = delete;
+	NamePool& operator=(const NamePool&) = delete;
+
+	/// Return the Entry holding the given name, creating it if there
+	/// is none. Either way, the caller holds one reference to it.
+	Entry* intern(const char* s, size_t len)
+		{ return intern(s, len, nullptr); }
+	Entry* intern(std::string&& s)
+		{ return intern(s.data(), s.size(), &s); }
+
+	/// Drop one reference. The last one frees the Entry.
+	void release(Entry*);
+
+	/// Number of distinct names in the pool.
+	size_t size(void);
+
+	/// Bytes of heap used by the pool: the tables, the Entries, and
+	/// the strings too long for the small-string buffer.
+	size_t bytes(void);
+};
+
+/// The pool is never destroyed, so that Nodes that outlive main()
+/// can still release their names.
+NamePool& namepool(void);
+
+/**
+ * The name of a Node, held in the NamePool. Eight bytes, instead of
+ * the 32 of a std::string. Behaves enough like a const std::string
+ * that the Node classes need not care which they are holding.
+ */
+class NodeName
+{
+	NamePool::Entry* _e;
+
+public:
+	NodeName(const std::string& s) :
+		_e(namepool().intern(s.data(), s.size())) {}
+	NodeName(std::string&& s) : _e(namepool().intern(std::move(s))) {}
+	~NodeName() { namepool().release(_e); }
+
+	NodeName(const NodeName&) = delete;
+	NodeName& operator=(const NodeName&) = delete;
+
+	NodeName& operator=(const std::string& s)
+	{
+		NamePool::Entry* e = namepool().intern(s.data(), s.size());
+		namepool().release(_e);
+		_e = e;
+		return *this;
+	}
+	NodeName& operator=(std::string&& s)
+	{
+		NamePool::Entry* e = namepool().intern(std::move(s));
+		namepool().release(_e);
+		_e = e;
+		return *this;
+	}
+
+	const std::string& str(void) const { return _e->_str; }
+	operator const std::string&() const { return _e->_str; }
+
+	const char* c_str(void) const { return _e->_str.c_str(); }
+	const char* data(void) const { return _e->_str.data(); }
+	size_t size(void) const { return _e->_str.size(); }
+	size_t length(void) const { return _e->_str.size(); }
+	bool empty(void) const { return _e->_str.empty(); }
+	char operator[](size_t i) const { return _e->_str[i]; }
+};
+
+/** @}*/
+} // namespace opencog
+
+#endif // _OPENCOG_NAME_POOL_H
@@ -24,6 +24,7 @@
 #include <iomanip>
 
 #include <opencog/atoms/atom_types/NameServer.h>
+#include <opencog/atoms/base/hash.h>
 
 #include "Node.h"
 
@@ -128,7 +129,7 @@ std::string Node::to_string_esc() const
     std::stringstream ss;
 
     ss << "(" << nameserver().getTypeName(_type) << " "
-       << std::quoted(_name) << ")";
+       << std::quoted(get_name()) << ")";
 
     return ss.str();
 }
@@ -169,12 +170,16 @@ bool Node::operator<(const Atom& other) const
 
 ContentHash Node::compute_hash() const
 {
-	ContentHash hsh = std::hash<std::string>()(get_name());
+	const std::string& name(get_name());
+	return compute_hash(get_type(), name.data(), name.size());
+}
 
-	// 1<<43 - 369 is a prime number.
+ContentHash Node::compute_hash(Type t, const char* name, size_t len)
+{
 	// The nameserver().getTypeHash() returns hash of the type string name,
-	// and is thus independent of other types in the tree.
-	hsh += (hsh<<5) + ((1ULL<<43)-369) * nameserver().getTypeHash(get_type());
+	// and is thus independent of other types in the tree. Using it as
+	// the seed mixes it in with the name in one pass.
+	ContentHash hsh = name_hash(name, len, nameserver().getTypeHash(t));
 
 	// Nodes will never have the MSB set.
 	ContentHash mask = ~(((ContentHash) 1ULL) << (8*sizeof(ContentHash) - 1));
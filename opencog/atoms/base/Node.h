@@ -28,6 +28,7 @@
 
 #include <opencog/atoms/base/Atom.h>
 #include <opencog/atoms/base/ClassServer.h>
+#include <opencog/atoms/base/NamePool.h>
 
 namespace opencog
 {
@@ -35,6 +36,14 @@ namespace opencog
  *  @{
  */
 
+// Hold Node names in the global NamePool, so that Nodes of different
+// types, having the same name, share one copy of it. Saves 24 bytes
+// per Node, plus the string itself, when the name is shared; costs
+// about 40 bytes more when it is not, and a lock on every Node
+// creation. Whether this is a win depends on the dataset. Disabled
+// by default; configure with -DUSE_NAME_POOL=ON to enable it, so that
+// everything built against the AtomSpace sees the same Node layout.
+
 /**
  * This is a subclass of Atom. It represents the most basic kind of
  * pattern known to the OpenCog system.
@@ -43,12 +52,22 @@ class Node : public Atom
 {
 protected:
     // properties
+#if USE_NAME_POOL
+    NodeName _name;
+#else
     std::string _name;
+#endif
     void init();
 
     virtual ContentHash compute_hash() const;
 
 public:
+    /**
+     * The hash that a Node of type t, with the given name, would
+     * have. Lets lookups by name skip making a temporary Node.
+     */
+    static ContentHash compute_hash(Type t, const char* name, size_t len);
+
     /**
      * Constructor for this class.
      *
@@ -118,7 +137,7 @@ NODE_PTR_DECL(Node)
 template< class... Args >
 Handle createNode( Args&&... args )
 {
-   Handle tmp(std::make_shared<Node>(std::forward<Args>(args) ...));
+   Handle tmp(CREATE_DECL(Node)(std::forward<Args>(args) ...));
    return classserver().factory(tmp);
 }
 
@@ -0,0 +1,256 @@
+/*
+ * opencog/atoms/base/SlabAllocator.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <atomic>
+#include <mutex>
+
+#include "SlabAllocator.h"
+
+using namespace opencog;
+
+// Block sizes are rounded up to a multiple of this.
+static constexpr size_t GRAIN = 16;
+static constexpr size_t NUM_CLASSES = slab_max_size / GRAIN;
+
+// Size of the chunks carved into blocks.
+static constexpr size_t SLAB_SIZE = 64 * 1024;
+
+// Per-thread cache limits. When a thread's cache is empty, it takes
+// a batch from the shared free list; when it overflows, it gives a
+// batch back. Threads that only create (or only extract) Atoms thus
+// touch the lock once per batch.
+static constexpr size_t BATCH = 64;
+static constexpr size_t CACHE_MAX = 4 * BATCH;
+
+// Free blocks are chained through their first word.
+struct Block { Block* _next; };
+
+static inline size_t size_class(size_t sz)
+{
+	return (sz + GRAIN - 1) / GRAIN - 1;
+}
+
+// ================================================================
+
+namespace {
+
+/// The shared free list, and the slabs, for one size class.
+class SlabPool
+{
+	std::mutex _mtx;
+	size_t _block_size;
+	Block* _free;
+
+public:
+	std::atomic<size_t> _reserved;
+	std::atomic<size_t> _out;
+
+	SlabPool(void) :
+		_block_size(0), _free(nullptr), _reserved(0), _out(0)
+	{}
+	void set_size(size_t sz) { _block_size = sz; }
+
+	/// Pop up to `want` blocks, chained, into `head`. Return the count.
+	size_t take(Block*& head, size_t want);
+
+	/// Push a chain of `cnt` blocks.
+	void give(Block* head, Block* tail, size_t cnt);
+};
+
+size_t SlabPool::take(Block*& head, size_t want)
+{
+	std::lock_guard<std::mutex> lck(_mtx);
+	if (nullptr == _free)
+	{
+		// Out of blocks; carve a fresh slab. Slabs are never freed,
+		// so nothing needs to remember them.
+		char* slab = static_cast<char*>(::operator new(SLAB_SIZE));
+		size_t nblk = SLAB_SIZE / _block_size;
+		for (size_t i = nblk; 0 < i; i--)
+		{
+			Block* b = reinterpret_cast<Block*>(slab + (i-1) * _block_size);
+			b->_next = _free;
+			_free = b;
+		}
+		_reserved += nblk * _block_size;
+	}
+
+	size_t got = 0;
+	Block* tail = nullptr;
+	head = _free;
+	while (_free and got < want)
+	{
+		tail = _free;
+		_free = _free->_next;
+		got++;
+	}
+	tail->_next = nullptr;
+	_out += got;
+	return got;
+}
+
+void SlabPool::give(Block* head, Block* tail, size_t cnt)
+{
+	std::lock_guard<std::mutex> lck(_mtx);
+	tail->_next = _free;
+	_free = head;
+	_out -= cnt;
+}
+
+// The pools are never destroyed: Atoms are released during static
+// destruction, e.g. when some global AtomSpace goes away.
+SlabPool* pools(void)
+{
+	static SlabPool* _pools = []() {
+		SlabPool* p = new SlabPool[NUM_CLASSES];
+		for (size_t i = 0; i < NUM_CLASSES; i++)
+			p[i].set_size((i+1) * GRAIN);
+		return p;
+	}();
+	return _pools;
+}
+
+/// Per-thread cache. This is trivially destructible, so it remains
+/// usable (and zero-cost to reach) for the entire life of the thread.
+/// The flusher, below, empties it when the thread exits.
+struct Cache
+{
+	Block* _head[NUM_CLASSES];
+	size_t _count[NUM_CLASSES];
+	bool _registered;
+	bool _dead;
+};
+
+static thread_local Cache cache;
+
+/// Hand the cached blocks back to the shared pools, when the thread
+/// exits. Anything freed after that (by destructors of other thread
+/// locals, or of statics) goes straight to the shared pool.
+struct Flusher
+{
+	~Flusher()
+	{
+		SlabPool* p = pools();
+		for (size_t i = 0; i < NUM_CLASSES; i++)
+		{
+			Block* head = cache._head[i];
+			if (nullptr == head) continue;
+			Block* tail = head;
+			while (tail->_next) tail = tail->_next;
+			p[i].give(head, tail, cache._count[i]);
+			cache._head[i] = nullptr;
+			cache._count[i] = 0;
+		}
+		cache._dead = true;
+	}
+};
+
+void register_flusher(void)
+{
+	static thread_local Flusher flusher;
+	(void) flusher;
+	cache._registered = true;
+}
+
+} // anon namespace
+
+// ================================================================
+
+void* opencog::slab_allocate(size_t sz)
+{
+	if (slab_max_size < sz) return ::operator new(sz);
+
+	size_t c = size_class(sz);
+	Block* b = cache._head[c];
+	if (b)
+	{
+		cache._head[c] = b->_next;
+		cache._count[c]--;
+		return b;
+	}
+
+	if (cache._dead)
+	{
+		pools()[c].take(b, 1);
+		return b;
+	}
+
+	if (not cache._registered) register_flusher();
+	cache._count[c] = pools()[c].take(b, BATCH) - 1;
+	cache._head[c] = b->_next;
+	return b;
+}
+
+void opencog::slab_deallocate(void* p, size_t sz)
+{
+	if (nullptr == p) return;
+	if (slab_max_size < sz) { ::operator delete(p); return; }
+
+	size_t c = size_class(sz);
+	Block* b = static_cast<Block*>(p);
+
+	if (cache._dead)
+	{
+		b->_next = nullptr;
+		pools()[c].give(b, b, 1);
+		return;
+	}
+
+	if (not cache._registered) register_flusher();
+	b->_next = cache._head[c];
+	cache._head[c] = b;
+	if (++cache._count[c] <= CACHE_MAX) return;
+
+	// Overflow. Keep the most recently freed blocks; they're the
+	// ones most likely to still be in the CPU cache.
+	Block* tail = b;
+	for (size_t i = 1; i < CACHE_MAX - BATCH; i++) tail = tail->_next;
+	Block* extra = tail->_next;
+	tail->_next = nullptr;
+
+	Block* last = extra;
+	size_t cnt = 1;
+	while (last->_next) { last = last->_next; cnt++; }
+	cache._count[c] -= cnt;
+	pools()[c].give(extra, last, cnt);
+}
+
+// ================================================================
+
+size_t opencog::slab_bytes_reserved(void)
+{
+	size_t tot = 0;
+	SlabPool* p = pools();
+	for (size_t i = 0; i < NUM_CLASSES; i++)
+		tot += p[i]._reserved.load(std::memory_order_relaxed);
+	return tot;
+}
+
+size_t opencog::slab_bytes_in_use(void)
+{
+	size_t tot = 0;
+	SlabPool* p = pools();
+	for (size_t i = 0; i < NUM_CLASSES; i++)
+		tot += p[i]._out.load(std::memory_order_relaxed) * (i+1) * GRAIN;
+	return tot;
+}
+
+// ======================= END OF FILE =================
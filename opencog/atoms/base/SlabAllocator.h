@@ -0,0 +1,115 @@
+/*
+ * opencog/atoms/base/SlabAllocator.h
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_SLAB_ALLOCATOR_H
+#define _OPENCOG_SLAB_ALLOCATOR_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace opencog
+{
+/** \addtogroup grp_atomspace
+ *  @{
+ */
+
+/**
+ * Slab allocator for Atoms.
+ *
+ * Atoms are small, are created by the hundreds of millions, and all
+ * Atoms of the same C++ class have the same size. The general-purpose
+ * heap pays for per-block headers and size lookup on every malloc and
+ * free, and scatters the Atoms of a large load across the address
+ * space. Here, blocks are carved out of 64KB slabs, one set of slabs
+ * per size class (16-byte granularity). Each thread keeps a cache of
+ * free blocks, so that the common case takes no lock. Blocks freed by
+ * extraction go back onto a free list, and are re-used by the next
+ * Atom of the same size. Slabs are never returned to the OS.
+ *
+ * Blocks larger than `slab_max_size` go to the ordinary heap.
+ */
+
+/// Largest block that is served from a slab.
+static constexpr size_t slab_max_size = 512;
+
+void* slab_allocate(size_t);
+void slab_deallocate(void*, size_t);
+
+/// Bytes held in slabs, whether in use or free.
+size_t slab_bytes_reserved(void);
+
+/// Bytes handed out and not yet returned to the shared free lists.
+/// Blocks sitting in per-thread caches are counted as in use.
+size_t slab_bytes_in_use(void);
+
+/// Standard allocator interface, for use with std::allocate_shared.
+/// The allocator is stateless; the rebound type decides the size
+/// class, so that the shared_ptr control block and the Atom share
+/// one block.
+template<class T>
+class SlabAllocator
+{
+public:
+	typedef T value_type;
+
+	SlabAllocator(void) noexcept {}
+	template<class U>
+	SlabAllocator(const SlabAllocator<U>&) noexcept {}
+
+	T* allocate(size_t n)
+	{
+		// Over-aligned types are rare; let the heap deal with them.
+		if (alignof(T) > alignof(std::max_align_t))
+			return static_cast<T*>(::operator new(n * sizeof(T),
+				std::align_val_t(alignof(T))));
+		return static_cast<T*>(slab_allocate(n * sizeof(T)));
+	}
+
+	void deallocate(T* p, size_t n) noexcept
+	{
+		if (alignof(T) > alignof(std::max_align_t))
+			::operator delete(p, std::align_val_t(alignof(T)));
+		else
+			slab_deallocate(p, n * sizeof(T));
+	}
+};
+
+template<class T, class U>
+bool operator==(const SlabAllocator<T>&, const SlabAllocator<U>&)
+	{ return true; }
+
+template<class T, class U>
+bool operator!=(const SlabAllocator<T>&, const SlabAllocator<U>&)
+	{ return false; }
+
+/// Drop-in replacement for std::make_shared.
+template<class T, class... Args>
+std::shared_ptr<T> slab_create(Args&&... args)
+{
+	return std::allocate_shared<T>(SlabAllocator<T>(),
+	                               std::forward<Args>(args)...);
+}
+
+/** @}*/
+} // namespace opencog
+
+#endif // _OPENCOG_SLAB_ALLOCATOR_H
@@ -1,6 +1,9 @@
 #ifndef _OPENCOG_HASH_H
 #define _OPENCOG_HASH_H
 
+#include <cstring>
+#include <string>
+
 #include <opencog/atoms/base/Handle.h>
 
 namespace opencog {
@@ -61,6 +64,206 @@ typename std::enable_if<sizeof(ContentHash) < sizeof(T), ContentHash>::type fnv1
 	return hval;
 }
 
+
+// ---------------------------------------------------------------------
+// Content hashing for Atoms.
+//
+// Content hashes decide bucket placement in the TypeIndex, and the
+// sort order of unordered links, so they must not depend on the
+// platform, the compiler, or the version of the standard library.
+// Thus, std::hash is not used. The name hash below is after wyhash:
+// it reads the bytes eight at a time, in little-endian order on all
+// platforms, and uses a 64x64->128 bit multiply to mix them. Long
+// names are consumed in three independent lanes, so that the CPU can
+// overlap the multiplies. This runs at many GBytes/sec, without any
+// platform-specific intrinsics.
+//
+// Do not change any of the constants or the algorithm; doing so will
+// change the hash of every Atom. The HashUTest unit test checks this.
+
+namespace hash_detail {
+
+static constexpr uint64_t WYP0 = 0x2d358dccaa6c78a5ULL;
+static constexpr uint64_t WYP1 = 0x8bb84b93962eacc9ULL;
+static constexpr uint64_t WYP2 = 0x4b33a62ed433d4a3ULL;
+static constexpr uint64_t WYP3 = 0x4d5a2da51de1aa47ULL;
+
+static inline void mum(uint64_t& a, uint64_t& b)
+{
+#ifdef __SIZEOF_INT128__
+	__uint128_t r = a;
+	r *= b;
+	a = (uint64_t) r;
+	b = (uint64_t) (r >> 64);
+#else
+	uint64_t ha = a >> 32, hb = b >> 32, la = (uint32_t) a, lb = (uint32_t) b;
+	uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	uint64_t t = rl + (rm0 << 32), c = t < rl;
+	uint64_t lo = t + (rm1 << 32);
+	c += lo < t;
+	uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+	a = lo;
+	b = hi;
+#endif
+}
+
+static inline uint64_t mix(uint64_t a, uint64_t b)
+{
+	mum(a, b);
+	return a ^ b;
+}
+
+static inline uint64_t r8(const uint8_t* p)
+{
+	uint64_t v;
+	memcpy(&v, p, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	v = __builtin_bswap64(v);
+#endif
+	return v;
+}
+
+static inline uint64_t r4(const uint8_t* p)
+{
+	uint32_t v;
+	memcpy(&v, p, 4);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	v = __builtin_bswap32(v);
+#endif
+	return v;
+}
+
+static inline uint64_t r3(const uint8_t* p, size_t k)
+{
+	return (((uint64_t) p[0]) << 16) | (((uint64_t) p[k >> 1]) << 8) | p[k - 1];
+}
+
+} // namespace hash_detail
+
+/// Platform-stable hash of a string of bytes.
+static inline uint64_t name_hash(const void* key, size_t len, uint64_t seed = 0)
+{
+	using namespace hash_detail;
+	const uint8_t* p = (const uint8_t*) key;
+	seed ^= mix(seed ^ WYP0, WYP1);
+	uint64_t a, b;
+	if (len <= 16)
+	{
+		if (len >= 4)
+		{
+			a = (r4(p) << 32) | r4(p + ((len >> 3) << 2));
+			b = (r4(p + len - 4) << 32) | r4(p + len - 4 - ((len >> 3) << 2));
+		}
+		else if (len > 0)
+		{
+			a = r3(p, len);
+			b = 0;
+		}
+		else
+			a = b = 0;
+	}
+	else
+	{
+		size_t i = len;
+		if (i > 48)
+		{
+			uint64_t see1 = seed, see2 = seed;
+			do
+			{
+				seed = mix(r8(p) ^ WYP1, r8(p + 8) ^ seed);
+				see1 = mix(r8(p + 16) ^ WYP2, r8(p + 24) ^ see1);
+				see2 = mix(r8(p + 32) ^ WYP3, r8(p + 40) ^ see2);
+				p += 48;
+				i -= 48;
+			}
+			while (i > 48);
+			seed ^= see1 ^ see2;
+		}
+		while (i > 16)
+		{
+			seed = mix(r8(p) ^ WYP1, r8(p + 8) ^ seed);
+			i -= 16;
+			p += 16;
+		}
+		a = r8(p + i - 16);
+		b = r8(p + i - 8);
+	}
+	a ^= WYP1;
+	b ^= seed;
+	mum(a, b);
+	return mix(a ^ WYP0 ^ len, b ^ WYP1);
+}
+
+static inline uint64_t name_hash(const std::string& str)
+{
+	return name_hash(str.data(), str.size());
+}
+
+// The outgoing sets of Links are hashed by feeding the hashes of the
+// outgoing Atoms through the xxHash64 round function; this costs two
+// multiplies per Atom. Large outgoing sets are spread over four
+// independent lanes, so that the multiplies overlap. The result is
+// then avalanched once, with the murmur64 finalizer, so that the low
+// bits, which the TypeIndex uses to pick a bucket, depend on all of
+// the input bits.
+
+static constexpr uint64_t XXP1 = 0x9e3779b185ebca87ULL;
+static constexpr uint64_t XXP2 = 0xc2b2ae3d27d4eb4fULL;
+
+static inline uint64_t hash_rotl(uint64_t x, int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t hash_round(uint64_t acc, uint64_t in)
+{
+	acc += in * XXP2;
+	acc = hash_rotl(acc, 31);
+	return acc * XXP1;
+}
+
+static inline uint64_t hash_avalanche(uint64_t h)
+{
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+/// Combine a sequence of hashes, in order. `get(i)` must return the
+/// i'th hash.
+template<typename GET>
+static inline uint64_t hash_sequence(uint64_t seed, size_t n, GET get)
+{
+	size_t i = 0;
+	uint64_t hsh;
+	if (4 <= n)
+	{
+		uint64_t v1 = seed + XXP1 + XXP2;
+		uint64_t v2 = seed + XXP2;
+		uint64_t v3 = seed;
+		uint64_t v4 = seed - XXP1;
+		for (; i + 4 <= n; i += 4)
+		{
+			v1 = hash_round(v1, get(i));
+			v2 = hash_round(v2, get(i+1));
+			v3 = hash_round(v3, get(i+2));
+			v4 = hash_round(v4, get(i+3));
+		}
+		hsh = hash_rotl(v1, 1) + hash_rotl(v2, 7) +
+		      hash_rotl(v3, 12) + hash_rotl(v4, 18);
+	}
+	else
+		hsh = seed;
+
+	for (; i < n; i++)
+		hsh = hash_round(hsh, get(i));
+
+	return hash_avalanche(hsh + n);
+}
+
 } // namespace opencog
 
 #endif // _OPENCOG_HASH_H
@@ -368,6 +368,10 @@ ContentHash ScopeLink::scope_hash(const FreeVariables::IndexMap& index) const
 		fnv1a_hash(hsh, term_hash(h, index));
 	}
 
+	// FNV leaves the low bits, which pick the TypeIndex bucket,
+	// depending only on the low bits of the inputs. Mix them.
+	hsh = hash_avalanche(hsh);
+
 	// Links will always have the MSB set.
 	ContentHash mask = ((ContentHash) 1UL) << (8*sizeof(ContentHash) - 1);
 	hsh |= mask;
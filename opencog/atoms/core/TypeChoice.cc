@@ -406,6 +406,10 @@ ContentHash TypeChoice::compute_hash() const
 	fnv1a_hash(hsh, _glob_interval.first);
 	fnv1a_hash(hsh, _glob_interval.second);
 
+	// FNV leaves the low bits, which pick the TypeIndex bucket,
+	// depending only on the low bits of the inputs. Mix them.
+	hsh = hash_avalanche(hsh);
+
 	// Links will always have the MSB set.
 	ContentHash mask = ((ContentHash) 1UL) << (8*sizeof(ContentHash) - 1);
 	hsh |= mask;
@@ -21,6 +21,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <opencog/atoms/base/hash.h>
+
 #include "ForeignAST.h"
 
 using namespace opencog;
@@ -74,7 +76,7 @@ bool ForeignAST::operator==(const Atom& other) const
 ContentHash ForeignAST::compute_hash() const
 {
    ContentHash hsh = Link::compute_hash();
-	hsh += std::hash<std::string>()(_name);
+	hsh += name_hash(_name);
 
 	// Links will always have the MSB set.
 	ContentHash mask = ((ContentHash) 1ULL) << (8*sizeof(ContentHash) - 1);
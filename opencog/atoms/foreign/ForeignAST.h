@@ -54,7 +54,7 @@ LINK_PTR_DECL(ForeignAST)
 template< class... Args >
 Handle createForeignAST( Args&&... args )
 {
-	Handle tmp(std::make_shared<ForeignAST>(std::forward<Args>(args) ...));
+	Handle tmp(CREATE_DECL(ForeignAST)(std::forward<Args>(args) ...));
 	return classserver().factory(tmp);
 }
 
@@ -25,8 +25,11 @@
 #define _OPENCOG_PATTERN_H
 
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <stack>
+#include <typeindex>
 #include <unordered_map>
 #include <vector>
 
@@ -41,6 +44,41 @@ namespace opencog {
  *  @{
  */
 
+/// The place where a search of a Pattern was started, and the order
+/// in which the clauses were to be grounded after that. This is made
+/// by the query engine (see `InitiateSearchMixin::setup_neighbor_search()`)
+/// and kept with the Pattern, so that it need not be made again on
+/// every search. It is only good for the AtomSpace it was made for,
+/// and only while that AtomSpace stays about the same size.
+struct SearchPlan
+{
+	/// The UUID of the AtomSpace; unlike its address, this is never
+	/// handed out again after the AtomSpace is gone.
+	UUID aspace = 0;
+	size_t epoch = 0;
+
+	/// The dynamic type of the callback that made the plan; a
+	/// different callback might pick its starts differently.
+	std::type_index planner = typeid(void);
+
+	/// The clauses that the start was picked from.
+	PatternTermSeq clauses;
+
+	struct Start
+	{
+		PatternTermPtr clause;
+		PatternTermPtr term;
+		Handle atom;
+		size_t width;  // Size of the search set, when planned.
+		bool choice;   // One of the alternatives of a ChoiceLink.
+	};
+	std::vector<Start> starts;
+
+	/// Position of each clause in the planned order.
+	std::map<PatternTermPtr, size_t> rank;
+};
+typedef std::shared_ptr<const SearchPlan> SearchPlanPtr;
+
 /// The Pattern struct contains a low-level analysis of a search pattern,
 /// in a format that will make a subsequent search run faster.  It is
 /// effectively a "compiled" version of the pattern. Patterns only need
@@ -130,6 +168,10 @@ struct Pattern
 
 	ConnectTermMap   connected_terms_map;  // setup by make_term_trees()
 
+	/// The search plan used last time. Set by the query engine.
+	mutable std::mutex plan_mtx;
+	mutable SearchPlanPtr plan;
+
 	std::string to_string(const std::string& indent) const;
 };
 
@@ -42,6 +42,26 @@ PatternLinkPtr PatternLink::jit_analyze(void)
 	// If there are no definitions, there is nothing to do.
 	if (0 == _pat.defined_terms.size()) return jit;
 
+	// Reuse the last expansion, if the definitions are still the same.
+	// Rules get run over and over, and expanding them is not cheap.
+	{
+		std::lock_guard<std::mutex> lck(_jit_mtx);
+		if (_jit)
+		{
+			bool same = true;
+			for (const HandlePair& def : _jit_defs)
+			{
+				if (DefineLink::get_definition(def.first) == def.second)
+					continue;
+				same = false;
+				break;
+			}
+			if (same) return _jit;
+		}
+	}
+
+	HandlePairSeq defs;
+
 	// Now is the time to look up the definitions!
 	// We loop here, so that all recursive definitions are expanded
 	// as well.  XXX Except that this is wrong, if any of the
@@ -58,6 +78,7 @@ PatternLinkPtr PatternLink::jit_analyze(void)
 		for (const Handle& name : jit->_pat.defined_terms)
 		{
 			Handle defn = DefineLink::get_definition(name);
+			defs.push_back({name, defn});
 			if (not defn) continue;
 
 			// Extract the variables in the definition.
@@ -97,6 +118,10 @@ PatternLinkPtr PatternLink::jit_analyze(void)
 	jit->debug_log("JIT expanded!");
 #endif
 
+	std::lock_guard<std::mutex> lck(_jit_mtx);
+	_jit = jit;
+	_jit_defs.swap(defs);
+
 	return jit;
 }
 
@@ -23,6 +23,7 @@
 #ifndef _OPENCOG_PATTERN_LINK_H
 #define _OPENCOG_PATTERN_LINK_H
 
+#include <mutex>
 #include <unordered_map>
 
 #include <opencog/atoms/core/Quotation.h>
@@ -110,6 +111,12 @@ protected:
 	HandleSetSeq _component_vars;
 	HandleSeq _component_patterns;
 
+	/// The expansion made by jit_analyze(), and the definitions that
+	/// went into it. Reused until one of the definitions changes.
+	std::mutex _jit_mtx;
+	PatternLinkPtr _jit;
+	HandlePairSeq _jit_defs;
+
 	PatternTermPtr make_term_tree(const Handle&);
 	void make_ttree_recursive(const PatternTermPtr&,
 	                          PatternTermPtr&);
@@ -129,7 +129,7 @@ ContainerValuePtr QueryLink::do_execute(AtomSpace* as, bool silent)
 		throw RuntimeException(TRACE_INFO,
 			"Expecting QueueValue for results!");
 
-	Implicator impl(as, cvp);
+	DefaultImplicator impl(as, cvp);
 
 	try
 	{
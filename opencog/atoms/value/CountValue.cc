@@ -0,0 +1,69 @@
+/*
+ * opencog/atoms/value/CountValue.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <opencog/atoms/value/CountValue.h>
+
+using namespace opencog;
+
+// ==============================================================
+
+CountValue::CountValue(const std::vector<double>& v) :
+	FloatValue(COUNT_VALUE), _len(v.size()),
+	_counts(new std::atomic<double>[v.size()])
+{
+	for (size_t i = 0; i < _len; i++)
+		_counts[i].store(v[i], std::memory_order_relaxed);
+}
+
+// ==============================================================
+
+bool CountValue::add(const std::vector<double>& v)
+{
+	if (_len < v.size()) return false;
+	for (size_t i = 0; i < v.size(); i++)
+		add(i, v[i]);
+	return true;
+}
+
+// Each entry is read atomically, but the entries are not read all
+// at the same instant; a concurrent add() of a vector may be seen in
+// part. This is no worse than reading the counts one at a time.
+ValuePtr CountValue::snapshot() const
+{
+	std::vector<double> cnts(_len);
+	for (size_t i = 0; i < _len; i++)
+		cnts[i] = _counts[i].load(std::memory_order_relaxed);
+	return createFloatValue(std::move(cnts));
+}
+
+// ==============================================================
+
+std::string CountValue::to_string(const std::string& indent) const
+{
+	return FloatValueCast(snapshot())->to_string(indent, _type);
+}
+
+bool CountValue::operator==(const Value& other) const
+{
+	if (COUNT_VALUE == other.get_type())
+		return *snapshot() == *((const CountValue*) &other)->snapshot();
+	return *snapshot() == other;
+}
@@ -0,0 +1,98 @@
+/*
+ * opencog/atoms/value/CountValue.h
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_COUNT_VALUE_H
+#define _OPENCOG_COUNT_VALUE_H
+
+#include <atomic>
+#include <memory>
+#include <opencog/atoms/value/FloatValue.h>
+
+namespace opencog
+{
+
+/** \addtogroup grp_atomspace
+ *  @{
+ */
+
+/**
+ * CountValues are FloatValues that are incremented in place, without
+ * a lock, and without making a new Value for each increment. They are
+ * what Atom::incrementCount() stores on an Atom.
+ *
+ * The number of counts is fixed when the CountValue is created; to
+ * grow it, make a new, bigger one.
+ *
+ * Unlike all other Values, these change after they are created. So
+ * they are kept inside the Atom, and never handed out: getValue()
+ * returns a snapshot() instead, which is an ordinary FloatValue that
+ * does not change. There is no factory for them, so they cannot be
+ * made from scheme or python, either. The inherited value() is always
+ * empty; use snapshot() to read the counts.
+ */
+class CountValue
+	: public FloatValue
+{
+protected:
+	size_t _len;
+	std::unique_ptr<std::atomic<double>[]> _counts;
+
+public:
+	CountValue(const std::vector<double>&);
+	virtual ~CountValue() {}
+
+	size_t size() const { return _len; }
+
+	/// Add `count` to the entry at `idx`. Returns false, and does
+	/// nothing, if `idx` is out of range. Safe to call from many
+	/// threads at once.
+	bool add(size_t idx, double count)
+	{
+		if (_len <= idx) return false;
+		std::atomic<double>& cnt = _counts[idx];
+		double old = cnt.load(std::memory_order_relaxed);
+		while (not cnt.compare_exchange_weak(old, old + count,
+		                                     std::memory_order_relaxed))
+			;
+		return true;
+	}
+
+	/// Add the vector, element by element. Returns false, and does
+	/// nothing, if the vector is longer than this.
+	bool add(const std::vector<double>&);
+
+	/// A FloatValue holding the current counts.
+	ValuePtr snapshot() const;
+
+	/** Returns a string representation of the value. */
+	virtual std::string to_string(const std::string& indent = "") const;
+
+	/** Returns true if two values are equal. */
+	virtual bool operator==(const Value&) const;
+};
+
+VALUE_PTR_DECL(CountValue);
+CREATE_VALUE_DECL(CountValue);
+
+/** @}*/
+} // namespace opencog
+
+#endif // _OPENCOG_COUNT_VALUE_H
@@ -0,0 +1,205 @@
+/*
+ * opencog/atomspace/AtomIndex.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <opencog/atoms/atom_types/NameServer.h>
+#include <opencog/atoms/base/Atom.h>
+#include <opencog/util/exceptions.h>
+
+#include "AtomIndex.h"
+
+using namespace opencog;
+
+#define SHARED_LOCK std::shared_lock<std::shared_mutex> lck(_mtx)
+#define UNIQUE_LOCK std::unique_lock<std::shared_mutex> lck(_mtx)
+
+// ================================================================
+
+NameIndex::NameIndex(Type t, bool subclass) :
+	AtomIndex(NAME), _type(t), _subclass(subclass), _size(0)
+{
+	if (not nameserver().isNode(t))
+		throw InvalidParamException(TRACE_INFO,
+			"NameIndex: expecting a Node type, got %s",
+			nameserver().getTypeName(t).c_str());
+}
+
+bool NameIndex::covers(Type t) const
+{
+	if (_subclass) return nameserver().isA(t, _type);
+	return t == _type;
+}
+
+void NameIndex::insert(const Handle& h)
+{
+	if (not h->is_node() or not covers(h->get_type())) return;
+	UNIQUE_LOCK;
+	if (_names[h->get_name()].insert(h).second) _size++;
+}
+
+void NameIndex::remove(const Handle& h)
+{
+	if (not h->is_node() or not covers(h->get_type())) return;
+	UNIQUE_LOCK;
+	auto it = _names.find(h->get_name());
+	if (_names.end() == it) return;
+	if (0 == it->second.erase(h)) return;
+	_size--;
+	if (it->second.empty()) _names.erase(it);
+}
+
+void NameIndex::clear(void)
+{
+	UNIQUE_LOCK;
+	_names.clear();
+	_size = 0;
+}
+
+size_t NameIndex::size(void) const
+{
+	SHARED_LOCK;
+	return _size;
+}
+
+void NameIndex::get_by_prefix(HandleSeq& hseq, Type t,
+                              const std::string& prefix,
+                              bool subclass) const
+{
+	NameServer& ns = nameserver();
+	SHARED_LOCK;
+	for (auto it = _names.lower_bound(prefix); it != _names.end(); it++)
+	{
+		if (0 != it->first.compare(0, prefix.size(), prefix)) break;
+		for (const Handle& h : it->second)
+		{
+			Type ht = h->get_type();
+			if (ht == t or (subclass and ns.isA(ht, t)))
+				hseq.push_back(h);
+		}
+	}
+}
+
+// ================================================================
+
+KeyIndex::KeyIndex(const Handle& key) :
+	AtomIndex(KEY), _key(key)
+{
+	if (nullptr == key)
+		throw InvalidParamException(TRACE_INFO, "KeyIndex: null key");
+}
+
+void KeyIndex::insert(const Handle& h)
+{
+	if (nullptr == h->getValue(_key)) return;
+	UNIQUE_LOCK;
+	_atoms.insert(h);
+}
+
+void KeyIndex::remove(const Handle& h)
+{
+	UNIQUE_LOCK;
+	_atoms.erase(h);
+}
+
+void KeyIndex::update(const Handle& h, const Handle& key)
+{
+	if (key != _key and *key != *_key) return;
+	if (h->getValue(_key)) insert(h);
+	else remove(h);
+}
+
+void KeyIndex::clear(void)
+{
+	UNIQUE_LOCK;
+	_atoms.clear();
+}
+
+size_t KeyIndex::size(void) const
+{
+	SHARED_LOCK;
+	return _atoms.size();
+}
+
+void KeyIndex::get_atoms(HandleSeq& hseq) const
+{
+	SHARED_LOCK;
+	hseq.insert(hseq.end(), _atoms.begin(), _atoms.end());
+}
+
+// ================================================================
+
+PositionIndex::PositionIndex(Type t, size_t pos) :
+	AtomIndex(POSITION), _type(t), _pos(pos), _size(0)
+{
+	NameServer& ns = nameserver();
+	if (not ns.isLink(t) or ns.isA(t, UNORDERED_LINK))
+		throw InvalidParamException(TRACE_INFO,
+			"PositionIndex: expecting an ordered Link type, got %s",
+			ns.getTypeName(t).c_str());
+}
+
+void PositionIndex::insert(const Handle& h)
+{
+	if (h->get_type() != _type or h->get_arity() <= _pos) return;
+	UNIQUE_LOCK;
+	if (_links[h->getOutgoingAtom(_pos)].insert(h).second) _size++;
+}
+
+void PositionIndex::remove(const Handle& h)
+{
+	if (h->get_type() != _type or h->get_arity() <= _pos) return;
+	UNIQUE_LOCK;
+	auto it = _links.find(h->getOutgoingAtom(_pos));
+	if (_links.end() == it) return;
+	if (0 == it->second.erase(h)) return;
+	_size--;
+	if (it->second.empty()) _links.erase(it);
+}
+
+void PositionIndex::clear(void)
+{
+	UNIQUE_LOCK;
+	_links.clear();
+	_size = 0;
+}
+
+size_t PositionIndex::size(void) const
+{
+	SHARED_LOCK;
+	return _size;
+}
+
+void PositionIndex::get_links(HandleSeq& hseq, const Handle& h) const
+{
+	SHARED_LOCK;
+	auto it = _links.find(h);
+	if (_links.end() == it) return;
+	hseq.insert(hseq.end(), it->second.begin(), it->second.end());
+}
+
+size_t PositionIndex::count(const Handle& h) const
+{
+	SHARED_LOCK;
+	auto it = _links.find(h);
+	if (_links.end() == it) return 0;
+	return it->second.size();
+}
+
+// ======================= END OF FILE =================
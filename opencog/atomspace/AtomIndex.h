@@ -0,0 +1,164 @@
+/*
+ * opencog/atomspace/AtomIndex.h
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_ATOM_INDEX_H
+#define _OPENCOG_ATOM_INDEX_H
+
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include <opencog/atoms/base/Handle.h>
+#include <opencog/atoms/atom_types/types.h>
+
+namespace opencog
+{
+/** \addtogroup grp_atomspace
+ *  @{
+ */
+
+/**
+ * Secondary indexes, declared by the user, and maintained by the
+ * AtomSpace alongside the TypeIndex. Each index covers the Atoms in
+ * one AtomSpace (one frame); it knows nothing about the frames under
+ * it. Each index has its own reader-writer lock.
+ *
+ * The AtomSpace calls `insert()` for each Atom added, `remove()` for
+ * each Atom extracted, and `update()` each time a Value changes.
+ * Calls are idempotent: inserting an Atom twice, or removing an Atom
+ * that is not there, is harmless.
+ */
+class AtomIndex
+{
+public:
+	enum Kind
+	{
+		NAME,        // Nodes, sorted by name.
+		KEY,         // Atoms holding a Value on a given key.
+		POSITION,    // Links, by the Atom at a given outgoing position.
+	};
+
+protected:
+	Kind _kind;
+	mutable std::shared_mutex _mtx;
+
+public:
+	AtomIndex(Kind k) : _kind(k) {}
+	virtual ~AtomIndex() {}
+
+	Kind get_kind(void) const { return _kind; }
+
+	virtual void insert(const Handle&) = 0;
+	virtual void remove(const Handle&) = 0;
+	virtual void update(const Handle&, const Handle& key) {}
+	virtual void clear(void) = 0;
+	virtual size_t size(void) const = 0;
+};
+
+typedef std::shared_ptr<AtomIndex> AtomIndexPtr;
+
+/**
+ * Nodes of a given type (and, optionally, its subtypes), sorted by
+ * name, so that all names starting with a given prefix are adjacent.
+ */
+class NameIndex : public AtomIndex
+{
+	Type _type;
+	bool _subclass;
+	std::map<std::string, HandleSet> _names;
+	size_t _size;
+
+public:
+	NameIndex(Type, bool subclass);
+
+	Type get_type(void) const { return _type; }
+	bool get_subclass(void) const { return _subclass; }
+	bool covers(Type) const;
+
+	virtual void insert(const Handle&);
+	virtual void remove(const Handle&);
+	virtual void clear(void);
+	virtual size_t size(void) const;
+
+	/// Append the Nodes of type `t` (or its subtypes, if `subclass`)
+	/// whose name starts with `prefix`.
+	void get_by_prefix(HandleSeq&, Type t, const std::string& prefix,
+	                   bool subclass) const;
+};
+
+/**
+ * All Atoms holding a Value on the given key.
+ */
+class KeyIndex : public AtomIndex
+{
+	Handle _key;
+	UnorderedHandleSet _atoms;
+
+public:
+	KeyIndex(const Handle& key);
+
+	const Handle& get_key(void) const { return _key; }
+
+	virtual void insert(const Handle&);
+	virtual void remove(const Handle&);
+	virtual void update(const Handle&, const Handle& key);
+	virtual void clear(void);
+	virtual size_t size(void) const;
+
+	void get_atoms(HandleSeq&) const;
+};
+
+/**
+ * Links of exactly the given type, by the Atom at the given position
+ * in their outgoing set. Unordered links have no positions, and so
+ * cannot be indexed this way.
+ */
+class PositionIndex : public AtomIndex
+{
+	Type _type;
+	size_t _pos;
+	std::unordered_map<Handle, UnorderedHandleSet> _links;
+	size_t _size;
+
+public:
+	PositionIndex(Type, size_t pos);
+
+	Type get_type(void) const { return _type; }
+	size_t get_position(void) const { return _pos; }
+
+	virtual void insert(const Handle&);
+	virtual void remove(const Handle&);
+	virtual void clear(void);
+	virtual size_t size(void) const;
+
+	/// Append the links that have `h` at this position.
+	void get_links(HandleSeq&, const Handle& h) const;
+
+	/// Number of links that have `h` at this position.
+	size_t count(const Handle& h) const;
+};
+
+/** @}*/
+} //namespace opencog
+
+#endif // _OPENCOG_ATOM_INDEX_H
@@ -21,16 +21,19 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
 #include <string>
 #include <iostream>
 #include <fstream>
 #include <list>
+#include <thread>
 
 #include <stdlib.h>
 
 #include <opencog/atoms/atom_types/types.h>
 #include <opencog/atoms/atom_types/NameServer.h>
 #include <opencog/atoms/base/Link.h>
+#include <opencog/atoms/base/hash.h>
 #include <opencog/atoms/base/Node.h>
 #include <opencog/atoms/value/LinkValue.h>
 #include <opencog/atoms/value/ValueFactory.h>
@@ -224,7 +227,7 @@ bool AtomSpace::operator<(const Atom& other) const
 ContentHash AtomSpace::compute_hash() const
 {
 	if (_name.empty()) return _uuid;
-	ContentHash hsh = std::hash<std::string>()(get_name());
+	ContentHash hsh = name_hash(get_name());
 
 	// Nodes will never have the MSB set.
 	ContentHash mask = ~(((ContentHash) 1ULL) << (8*sizeof(ContentHash) - 1));
@@ -378,6 +381,165 @@ Handle AtomSpace::add_atom(const Handle& h)
     return Handle::UNDEFINED;
 }
 
+// Compute the hashes up front. Computing the hash of a Link requires
+// the hashes of everything under it, and so this can be a fair amount
+// of work, for a large batch. Threads are started afresh for each
+// batch; hashing a few thousand atoms takes less time than that, so
+// only huge batches are split up.
+static void prehash(const HandleSeq& batch)
+{
+    // Atoms per thread, at the least.
+    static constexpr size_t CHUNK = 65536;
+    size_t sz = batch.size();
+    size_t nthr = std::min<size_t>(std::thread::hardware_concurrency(),
+                                   sz / CHUNK);
+    if (nthr < 2)
+    {
+        for (const Handle& h : batch)
+            if (h) h->get_hash();
+        return;
+    }
+
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < nthr; t++)
+    {
+        pool.push_back(std::thread([&batch, t, nthr, sz](void)
+        {
+            for (size_t i = sz * t / nthr; i < sz * (t+1) / nthr; i++)
+                if (batch[i]) batch[i]->get_hash();
+        }));
+    }
+    for (std::thread& th : pool) th.join();
+}
+
+// Atoms whose setAtomSpace() looks at, or alters, the contents of
+// the AtomSpace. These must see every atom that came before them in
+// the batch, and so are added one at a time.
+static bool needs_single_add(Type t)
+{
+    NameServer& ns = nameserver();
+    return ns.isA(t, UNIQUE_LINK) or ns.isA(t, DELETE_LINK) or
+        ns.isA(t, PATTERN_LINK) or ns.isA(t, VALUE_SHIM_LINK) or
+        ns.isA(t, FRAME);
+}
+
+// Hashes of the staged atoms. Open addressing, no deletion, and no
+// allocation after the first use; this is on the hot path.
+struct StagedHashes
+{
+    std::vector<ContentHash> _slots;
+    size_t _mask;
+    StagedHashes(size_t n) : _slots(2*n, 0), _mask(2*n - 1) {}
+    void clear(void) { std::fill(_slots.begin(), _slots.end(), 0); }
+    bool contains(ContentHash hsh) const
+    {
+        if (0 == hsh) hsh = 1;
+        for (size_t i = hsh & _mask; 0 != _slots[i]; i = (i+1) & _mask)
+            if (hsh == _slots[i]) return true;
+        return false;
+    }
+    void insert(ContentHash hsh)
+    {
+        if (0 == hsh) hsh = 1;
+        size_t i = hsh & _mask;
+        while (0 != _slots[i] and hsh != _slots[i]) i = (i+1) & _mask;
+        _slots[i] = hsh;
+    }
+};
+
+// Return true if the atom, or anything under it, might be equal to
+// some staged atom. Only the hashes are compared; a hash collision
+// costs an early flush, but nothing worse.
+static bool overlaps(const Handle& h, const StagedHashes& staged)
+{
+    if (staged.contains(h->get_hash())) return true;
+    if (not h->is_link()) return false;
+    for (const Handle& ho : h->getOutgoingSet())
+    {
+        // Atoms already in an AtomSpace cannot contain staged atoms.
+        if (ho->getAtomSpace())
+        {
+            if (staged.contains(ho->get_hash())) return true;
+            continue;
+        }
+        if (overlaps(ho, staged)) return true;
+    }
+    return false;
+}
+
+HandleSeq AtomSpace::add_batch(HandleSeq&& batch)
+{
+    size_t sz = batch.size();
+    HandleSeq result(sz);
+
+    // Same as add_atom(): if it's already in the atomspace, return it.
+    if (_read_only)
+    {
+        for (size_t i = 0; i < sz; i++)
+            if (batch[i]) result[i] = get_atom(batch[i]);
+        return result;
+    }
+
+    prehash(batch);
+
+    // Atoms are staged, and then added as a group. Anything that is
+    // equal to, or contains, a staged atom has to wait until the
+    // group is in; otherwise it would not be found, and duplicates
+    // would be resolved differently than in add_atom().
+    static constexpr size_t MAX_STAGED = 4096;
+    HandleSeq staged;
+    std::vector<size_t> where;
+    StagedHashes pending(MAX_STAGED);
+    auto flush = [&](void)
+    {
+        if (staged.empty()) return;
+        add_staged(staged);
+        for (size_t j = 0; j < staged.size(); j++)
+            result[where[j]] = staged[j];
+        staged.clear();
+        where.clear();
+        pending.clear();
+    };
+
+    for (size_t i = 0; i < sz; i++)
+    {
+        const Handle& h(batch[i]);
+        if (nullptr == h) continue;
+
+        if (not staged.empty() and overlaps(h, pending))
+            flush();
+
+        if (needs_single_add(h->get_type()))
+        {
+            flush();
+            result[i] = add_atom(h);
+            continue;
+        }
+
+        // See add_atom() for the exceptions.
+        try {
+            bool fresh;
+            Handle atom(stage(h, false, false, false, fresh));
+            if (not fresh)
+            {
+                result[i] = atom;
+                continue;
+            }
+            pending.insert(atom->get_hash());
+            staged.emplace_back(atom);
+            where.push_back(i);
+        }
+        catch (const DeleteException& ex) {}
+        catch (const SilentException& ex) {
+            result[i] = lookupHide(h, false);
+        }
+
+        if (MAX_STAGED <= staged.size()) flush();
+    }
+    flush();
+    return result;
+}
+
 ValuePtr AtomSpace::add_atoms(const ValuePtr& vptr)
 {
     if (nullptr == vptr) return vptr;
@@ -447,7 +609,7 @@ Handle AtomSpace::set_value(const Handle& h,
                             const Handle& key,
                             const ValuePtr& value)
 {
-   #define SETV(atm) atm->setValue(key, value);
+   #define SETV(atm) atm->setValue(key, value); value_changed(atm, key);
 	COWBOY_CODE(SETV);
 }
 
@@ -455,7 +617,7 @@ Handle AtomSpace::set_value(const Handle& h,
 Handle AtomSpace::increment_count(const Handle& h, const Handle& key,
                                   const std::vector<double>& count)
 {
-	#define INCR_CNT(atm) atm->incrementCount(key, count);
+	#define INCR_CNT(atm) atm->incrementCount(key, count); value_changed(atm, key);
 	COWBOY_CODE(INCR_CNT);
 }
 
@@ -463,10 +625,61 @@ Handle AtomSpace::increment_count(const Handle& h, const Handle& key,
 Handle AtomSpace::increment_count(const Handle& h, const Handle& key,
                                   size_t ref, double count)
 {
-	#define INCR_LOC(atm) atm->incrementCount(key, ref, count);
+	#define INCR_LOC(atm) atm->incrementCount(key, ref, count); value_changed(atm, key);
 	COWBOY_CODE(INCR_LOC);
 }
 
+// ====================================================================
+
+// The atom might be in a frame under this one; the change is reported,
+// and indexed, by the frame that holds it.
+void AtomSpace::value_changed(const Handle& atm, const Handle& key)
+{
+    AtomSpace* as = atm->getAtomSpace();
+    if (nullptr == as) return;
+    if (as->_indexed.load(std::memory_order_relaxed))
+    {
+        std::shared_lock<std::shared_mutex> lck(as->_idx_mtx);
+        for (const AtomIndexPtr& idx : as->_indexes)
+            idx->update(atm, key);
+    }
+
+    ChangeFeed* cf = as->_feed.load(std::memory_order_acquire);
+    if (nullptr == cf or not cf->active()) return;
+    cf->publish(AtomEvent::VALUE, atm, key, atm->getValue(key));
+}
+
+uint64_t AtomSpace::subscribe_changes(const FeedFilter& filter,
+                                      const ChangeFeed::Callback& cb)
+{
+    ChangeFeed* cf = _feed.load(std::memory_order_acquire);
+    if (nullptr == cf)
+    {
+        std::lock_guard<std::mutex> lck(_feed_mtx);
+        cf = _feed.load(std::memory_order_acquire);
+        if (nullptr == cf)
+        {
+            cf = new ChangeFeed();
+            _feed.store(cf, std::memory_order_release);
+        }
+    }
+    return cf->subscribe(filter, cb);
+}
+
+void AtomSpace::unsubscribe_changes(uint64_t id)
+{
+    ChangeFeed* cf = _feed.load(std::memory_order_acquire);
+    if (cf) cf->unsubscribe(id);
+}
+
+void AtomSpace::flush_changes(void)
+{
+    ChangeFeed* cf = _feed.load(std::memory_order_acquire);
+    if (cf) cf->flush();
+}
+
+// ====================================================================
+
 std::string AtomSpace::to_string(void) const
 {
 	std::stringstream ss;
@@ -25,6 +25,9 @@
 #ifndef _OPENCOG_ATOMSPACE_H
 #define _OPENCOG_ATOMSPACE_H
 
+#include <cstring>
+#include <initializer_list>
+
 #include <opencog/util/async_method_caller.h>
 #include <opencog/util/exceptions.h>
 
@@ -33,7 +36,11 @@
 #include <opencog/atoms/base/Node.h>
 #include <opencog/atoms/base/Link.h>
 
+#include <opencog/atomspace/AtomIndex.h>
+#include <opencog/atomspace/ChangeFeed.h>
 #include <opencog/atomspace/Frame.h>
+#include <opencog/atomspace/HandleCursor.h>
+#include <opencog/atomspace/MemoryUsage.h>
 #include <opencog/atomspace/TypeIndex.h>
 
 class AtomTableUTest;
@@ -55,6 +62,7 @@ typedef std::shared_ptr<AtomSpace> AtomSpacePtr;
 class AtomSpace : public Frame
 {
     friend class StorageNode;     // Needs to call add() directly.
+    friend class TypeCursor;      // Needs to walk the typeIndex.
 
     // Debug tools
     static const bool EMIT_DIAGNOSTICS = true;
@@ -102,6 +110,39 @@ private:
     // between the two different pointer types (its significant).
     std::vector<AtomSpacePtr> _environ;
 
+    /// Change feed; created on the first subscription. Publishing
+    /// costs one load and a branch when no one is listening.
+    std::atomic<ChangeFeed*> _feed{nullptr};
+    std::mutex _feed_mtx;
+    void publish(AtomEvent::Kind kind, const Handle& h,
+                 const Handle& key = Handle::UNDEFINED,
+                 const ValuePtr& value = nullptr)
+    {
+        ChangeFeed* cf = _feed.load(std::memory_order_acquire);
+        if (nullptr == cf or not cf->active()) return;
+        cf->publish(kind, h, key, value);
+    }
+
+    /// Secondary indexes declared by the user; see AtomIndex.h.
+    /// Maintaining them costs one load and a branch when there are
+    /// none.
+    std::vector<AtomIndexPtr> _indexes;
+    mutable std::shared_mutex _idx_mtx;
+    std::atomic<bool> _indexed{false};
+    void index_insert(const Handle& h)
+    {
+        if (_indexed.load(std::memory_order_relaxed)) update_indexes(h, true);
+    }
+    void index_remove(const Handle& h)
+    {
+        if (_indexed.load(std::memory_order_relaxed)) update_indexes(h, false);
+    }
+    void update_indexes(const Handle&, bool insert);
+    void add_index(const AtomIndexPtr&);
+
+    /// Called after a Value changes, for the indexes and the feed.
+    static void value_changed(const Handle&, const Handle& key);
+
     /** Find out about atom type additions in the NameServer. */
     NameServer& _nameserver;
     int addedTypeConnection;
@@ -125,8 +166,15 @@ private:
      */
     Handle add(const Handle&, bool force=false,
                bool recurse=false, bool absent = false);
+    Handle stage(const Handle&, bool force, bool recurse,
+                 bool absent, bool& fresh);
+    void add_staged(HandleSeq&);
+    bool extract_closure(const Handle&);
+    void extract_batch(const HandleSeq&);
     Handle check(const Handle&, bool force=false);
     Handle lookupHide(const Handle&, bool hide=false) const;
+    template<typename FIND> Handle lookupWith(const FIND&) const;
+    Handle find_link(Type, const Handle*, size_t) const;
 
     virtual ContentHash compute_hash() const;
 
@@ -137,9 +185,15 @@ private:
                         bool parent,
                         const AtomSpace*) const;
 
+    bool foreach_shadow(Type, bool subclass, bool parent,
+                        const AtomSpace*,
+                        const std::function<bool(const Handle&)>&) const;
+
     void get_absent_atoms(HandleSeq&) const;
     void get_atoms_in_frame(HandleSeq&) const;
 
+    std::vector<AtomSpacePtr> squash_range(const AtomSpace*) const;
+
 public:
     /**
      * Constructor and destructor for this class.
@@ -211,6 +265,43 @@ public:
     bool in_environ(const Handle&) const;
     bool in_environ(const AtomSpace*) const;
 
+    /**
+     * Collapse the chain of frames below this one, down to and
+     * including `bottom`, into this frame. Afterwards, this AtomSpace
+     * sits directly on top of whatever `bottom` was sitting on, and
+     * lookups no longer have to walk through the collapsed frames.
+     * Everything visible from this AtomSpace remains visible, with
+     * the same Values: for each atom, the shallowest version wins,
+     * and absent markers keep hiding whatever they hid before. Absent
+     * markers that no longer hide anything are dropped.
+     *
+     * The collapsed frames themselves are not altered; the atoms in
+     * them are copied. Thus, other frames built on top of them, as
+     * well as Handles to atoms in them, remain valid. Handles to atoms
+     * in this frame remain valid, and remain in this frame.
+     *
+     * Every frame from this one down to `bottom` must have exactly
+     * one base; else an exception is thrown. This must not run
+     * concurrently with changes to any of the frames involved.
+     */
+    void squash(const AtomSpacePtr& bottom);
+
+    /**
+     * Report the approximate RAM used by the atoms in this frame, not
+     * counting the frames under it, broken down by atom type and by
+     * key. See MemoryUsage.h for what is counted. This takes no
+     * global locks and copies nothing; it is a single walk over the
+     * atoms, and is safe to call on a live, busy AtomSpace. Atoms
+     * added or removed during the walk may or may not be counted.
+     */
+    FrameMemory memory_usage() const;
+
+    /**
+     * Same as above, for this frame and every frame under it, each
+     * one reported once, starting with this one.
+     */
+    std::vector<FrameMemory> memory_usage_by_frame() const;
+
     /* AtomSpaces are Atoms; provide virtual methods of base class. */
     virtual const std::string& get_name() const;
     virtual Arity get_arity() const { return _environ.size(); }
@@ -266,6 +357,21 @@ public:
      */
     Handle add_atom(const Handle&);
 
+    /**
+     * Add many atoms at once. This returns the same thing as calling
+     * add_atom() on each of them, in order, would have: the i'th
+     * returned Handle is the atom in the AtomSpace that is equal to
+     * the i'th atom in the batch. Duplicates, both within the batch
+     * and with atoms already in the AtomSpace, are resolved exactly
+     * as add_atom() would resolve them.
+     *
+     * This is faster than adding atoms one at a time, for large
+     * batches: hashes are computed in parallel, and the locks on
+     * the TypeIndex and on the incoming sets are taken once per
+     * group of atoms that share them, rather than once per atom.
+     */
+    HandleSeq add_batch(HandleSeq&&);
+
     /**
      * Add a node to the Atom Table.  If the atom already exists
      * then that is returned.
@@ -289,8 +395,15 @@ public:
      *                  the outgoing set of the link
      */
     inline Handle add_link(Type t, HandleSeq&& outgoing) {
+        Handle h(find_link(t, outgoing.data(), outgoing.size()));
+        if (h) return h;
         return add_atom(createLink(std::move(outgoing), t));
     }
+    inline Handle add_link(Type t, std::initializer_list<Handle> outgoing) {
+        Handle h(find_link(t, outgoing.begin(), outgoing.size()));
+        if (h) return h;
+        return add_atom(createLink(HandleSeq(outgoing), t));
+    }
     inline Handle xadd_link(Type t, HandleSeq seq) {
         return add_link(t, std::move(seq));
     }
@@ -302,7 +415,7 @@ public:
 
     inline Handle add_link(Type t, Handle h)
     {
-	    return add_link(t, HandleSeq({h}));
+	    return add_link(t, {h});
     }
 
     inline Handle add_link(Type t, Handle ha, Handle hb)
@@ -423,6 +536,66 @@ public:
     Handle increment_count(const Handle&, const Handle&, const std::vector<double>&);
     Handle increment_count(const Handle&, const Handle&, size_t, double);
 
+    /**
+     * Subscribe to changes made to this AtomSpace: atoms added and
+     * extracted, and values changed through `set_value()` and
+     * `increment_count()`. Changes made to the frames under this one
+     * are not reported; subscribe to those directly. Values set on
+     * Atoms directly, with `Atom::setValue()`, bypass the AtomSpace,
+     * and are not reported either.
+     *
+     * The callback is invoked with batches of events, in order, on
+     * a thread belonging to the feed; see ChangeFeed.h for details.
+     * Returns an id, to be passed to `unsubscribe_changes()`.
+     */
+    uint64_t subscribe_changes(const FeedFilter&, const ChangeFeed::Callback&);
+    void unsubscribe_changes(uint64_t);
+
+    /**
+     * Wait until all changes made so far have been delivered to the
+     * subscribers. Must not be called from within a callback.
+     */
+    void flush_changes(void);
+
+    /**
+     * Declare a secondary index on this AtomSpace. The index is built
+     * from the atoms already present, and is then maintained as atoms
+     * are added and extracted, and as Values change. Declaring the
+     * same index twice is harmless. An index covers the atoms in this
+     * AtomSpace only, not those in the frames under it. Indexes should
+     * not be declared while other threads are extracting atoms.
+     *
+     * A name index sorts Nodes of the given type (and its subtypes,
+     * if `subclass` is set) by name, for prefix lookups. A key index
+     * tracks which atoms hold a Value on the given key. A position
+     * index finds Links of the given (ordered) type by the Atom at
+     * the given position in their outgoing set; the pattern matcher
+     * uses these to start searches.
+     */
+    void add_name_index(Type, bool subclass=true);
+    void add_key_index(const Handle& key);
+    void add_position_index(Type, size_t pos);
+
+    /** Remove all secondary indexes from this AtomSpace. */
+    void drop_indexes(void);
+
+    /**
+     * Lookups on the secondary indexes. Like the indexes themselves,
+     * these cover the atoms in this AtomSpace only. If there is no
+     * suitable index, the lookup falls back to a scan over the atoms
+     * of the given type; the results are the same, just slower.
+     */
+    void get_handles_by_name_prefix(HandleSeq&, Type,
+                                    const std::string& prefix,
+                                    bool subclass=false) const;
+    void get_handles_by_key(HandleSeq&, const Handle& key) const;
+    void get_links_by_position(HandleSeq&, Type, size_t pos,
+                               const Handle&) const;
+
+    /** The position index for this type and position, if any. */
+    std::shared_ptr<const PositionIndex>
+    get_position_index(Type, size_t pos) const;
+
     /**
      * Find an equivalent Atom that is exactly the same as the arg.
      * If such an atom is in the AtomSpace, or in any of it's parent
@@ -441,6 +614,17 @@ public:
     inline Handle get_node(Type t, std::string&& name) const {
         return lookupHandle(createNode(t, std::move(name)));
     }
+
+    /**
+     * Same as above, but without making a temporary Node: the name
+     * is hashed and compared in place. Node types that have their own
+     * C++ class, which might rewrite the name, take the slow path.
+     */
+    Handle get_node(Type t, const char* name, size_t len) const;
+    inline Handle get_node(Type t, const char* name) const {
+        return get_node(t, name, strlen(name));
+    }
+
     inline Handle xget_handle(Type t, std::string str) const {
         return get_node(t, std::move(str));
     }
@@ -459,8 +643,20 @@ public:
      *        the outgoing set of the link.
      */
     inline Handle get_link(Type t, HandleSeq&& outgoing) const {
-        return lookupHandle(createLink(std::move(outgoing), t));
+        return get_link(t, outgoing.data(), outgoing.size());
     }
+    inline Handle get_link(Type t, std::initializer_list<Handle> outgoing) const {
+        return get_link(t, outgoing.begin(), outgoing.size());
+    }
+
+    /**
+     * Same as above, but without making a temporary Link: the hash
+     * is computed from the type and the outgoing hashes, and the
+     * TypeIndex is probed with that. Link types that have their own
+     * C++ class, which might rewrite the outgoing set, take the slow
+     * path.
+     */
+    Handle get_link(Type t, const Handle* outgoing, size_t arity) const;
     inline Handle xget_handle(Type t, HandleSeq outgoing) const {
         return get_link(t, std::move(outgoing));
     }
@@ -511,6 +707,66 @@ public:
                         bool parent=true,
                         const AtomSpace* = nullptr) const;
 
+    /**
+     * Invoke the callback on each atom of the given type (subclasses
+     * optionally), until one of them returns true, in which case the
+     * loop stops and returns true. Otherwise, false is returned.
+     *
+     * Unlike get_handles_by_type(), this does not copy the atoms into
+     * a temporary container, and it does not block other threads that
+     * are adding or extracting atoms while the walk is in progress.
+     * Atoms added or extracted during the walk may or may not be seen.
+     * The callback is free to add or extract atoms itself.
+     *
+     * For copy-on-write spaces, only the shallowest version of each
+     * atom is reported, and hidden atoms are skipped. Unlike
+     * get_handles_by_type(), StateLinks and DefineLinks are reported
+     * as-is, and are not resolved to the current frame.
+     *
+     * Example of call to this method, which would count all
+     * ConceptNodes in the AtomSpace:
+     * @code
+     *         size_t n = 0;
+     *         atomSpace.foreach_handle_by_type(CONCEPT_NODE,
+     *             [&](const Handle& h) { n++; return false; });
+     * @endcode
+     */
+    bool
+    foreach_handle_by_type(Type type,
+                           const std::function<bool(const Handle&)>&,
+                           bool subclass=false,
+                           bool parent=true) const;
+
+    /**
+     * Return a cursor over the atoms of the given type (subclasses
+     * optionally), handing them out a chunk at a time. The atoms are
+     * the same ones that foreach_handle_by_type() reports. Unlike
+     * get_handles_by_type(), nothing is copied until it is asked for,
+     * and so a consumer that stops early pays only for what it read.
+     * See HandleCursor.h for the details.
+     *
+     * Example of call to this method, which would print the first
+     * hundred ConceptNodes in the AtomSpace:
+     * @code
+     *         HandleSeq chunk;
+     *         atomSpace.cursor_by_type(CONCEPT_NODE)->next(chunk, 100);
+     *         for (const Handle& h : chunk) printf("%s\n", h->to_string().c_str());
+     * @endcode
+     */
+    HandleCursorPtr
+    cursor_by_type(Type type,
+                   bool subclass=false,
+                   bool parent=true) const;
+
+    /**
+     * Return a cursor over the incoming set of the atom (only the
+     * Links of the given type, if it is not NOTYPE), as seen from
+     * this AtomSpace. The Links are the same ones that
+     * Atom::getIncomingSet() reports.
+     */
+    HandleCursorPtr
+    cursor_incoming(const Handle&, Type type=NOTYPE) const;
+
     /**
      * Gets a set of handles that matches with the given type,
      * but ONLY if they have an empty incoming set! 
@@ -29,7 +29,9 @@
 #include "AtomSpace.h"
 
 #include <atomic>
+#include <functional>
 #include <stdlib.h>
+#include <unordered_map>
 
 #include <opencog/atoms/atom_types/NameServer.h>
 #include <opencog/atoms/base/Link.h>
@@ -126,6 +128,9 @@ AtomSpace::AtomSpace(const HandleSeq& bases) :
 AtomSpace::~AtomSpace()
 {
     _nameserver.typeAddedSignal().disconnect(addedTypeConnection);
+
+    // Stop the feed first; the callbacks must not see the atoms go.
+    delete _feed.exchange(nullptr);
     clear_all_atoms();
 }
 
@@ -162,11 +167,16 @@ void AtomSpace::clear_all_atoms()
     incomeIndex.clear();
 #endif
     typeIndex.clear();
+
+    std::shared_lock<std::shared_mutex> lck(_idx_mtx);
+    for (const AtomIndexPtr& idx : _indexes)
+        idx->clear();
 }
 
 void AtomSpace::clear()
 {
     clear_all_atoms();
+    publish(AtomEvent::CLEAR, Handle::UNDEFINED);
 }
 
 /// Find an equivalent atom that is exactly the same as the arg. If
@@ -180,6 +190,12 @@ void AtomSpace::clear()
 /// cases of ambiguous multiple inheritance.
 Handle AtomSpace::lookupHide(const Handle& a, bool hide) const
 {
+#if USE_CONCURRENT_TYPESET
+    // One guard for the entire walk. The ones taken by findAtom(),
+    // in each frame, then nest, and cost almost nothing.
+    EpochGuard guard;
+#endif
+
     const Handle& h(typeIndex.findAtom(a));
     if (h) {
         if (hide and h->isAbsent()) return Handle::UNDEFINED;
@@ -237,6 +253,109 @@ Handle AtomSpace::lookupHide(const Handle& a, bool hide) const
     return Handle::UNDEFINED;
 }
 
+/// Same as lookupHide(a, true), except that the atom is looked for
+/// with `find(typeIndex)`, so that there need not be an Atom to look
+/// for. Used by get_node() and get_link().
+template<typename FIND>
+Handle AtomSpace::lookupWith(const FIND& find) const
+{
+#if USE_CONCURRENT_TYPESET
+    EpochGuard guard;
+#endif
+
+    const AtomSpace* as = this;
+    while (true)
+    {
+        const Handle& h(find(as->typeIndex));
+        if (h) {
+            if (h->isAbsent()) return Handle::UNDEFINED;
+            return h;
+        }
+
+        size_t esz = as->_environ.size();
+        if (0 == esz) return Handle::UNDEFINED;
+        if (1 == esz) { as = as->_environ[0].get(); continue; }
+
+        // Multiple inheritance; the first one found wins.
+        for (const AtomSpacePtr& base: as->_environ)
+        {
+            const Handle& found = base->lookupWith(find);
+            if (found) return found;
+        }
+        return Handle::UNDEFINED;
+    }
+}
+
+Handle AtomSpace::get_node(Type t, const char* name, size_t len) const
+{
+    // Factories may rewrite the name (NumberNode, TypeNode) and
+    // validators may reject it; let createNode() deal with those,
+    // and with types that are not Nodes at all.
+    if (not nameserver().isA(t, NODE) or
+        classserver().hasFactory(t) or classserver().getValidator(t))
+        return get_node(t, std::string(name, len));
+
+    ContentHash hsh = Node::compute_hash(t, name, len);
+    return lookupWith([&](const TypeIndex& tidx) {
+        return tidx.findNode(t, name, len, hsh); });
+}
+
+// As for Nodes, above: factories may rewrite the outgoing set
+// (UnorderedLink sorts it, ScopeLink alpha-converts it) and
+// validators may reject it.
+static inline bool plain_link(Type t, const Handle* outgoing, size_t arity)
+{
+    if (not nameserver().isA(t, LINK) or
+        classserver().hasFactory(t) or classserver().getValidator(t))
+        return false;
+    for (size_t i = 0; i < arity; i++)
+        if (nullptr == outgoing[i]) return false;
+    return true;
+}
+
+Handle AtomSpace::get_link(Type t, const Handle* outgoing, size_t arity) const
+{
+    if (not plain_link(t, outgoing, arity))
+        return lookupHandle(createLink(
+            HandleSeq(outgoing, outgoing + arity), t));
+
+    ContentHash hsh = Link::compute_hash(t, outgoing, arity);
+    return lookupWith([&](const TypeIndex& tidx) {
+        return tidx.findLink(t, outgoing, arity, hsh); });
+}
+
+/// The part of add_link() that does not need the Link: if check()
+/// would find the Link, return it. Returns Handle::UNDEFINED if the
+/// Link is not there, and also whenever it is not obvious what add()
+/// would do; the caller then makes the Link and calls add_atom().
+Handle AtomSpace::find_link(Type t, const Handle* outgoing, size_t arity) const
+{
+    if (not plain_link(t, outgoing, arity)) return Handle::UNDEFINED;
+
+    // Absent atoms are unhidden by check(); leave that to it.
+    ContentHash hsh = Link::compute_hash(t, outgoing, arity);
+    const Handle& hc(typeIndex.findLink(t, outgoing, arity, hsh));
+    if (hc) return hc->isAbsent() ? Handle::UNDEFINED : hc;
+
+    if (0 == _environ.size()) return Handle::UNDEFINED;
+
+    const Handle& cand(lookupWith([&](const TypeIndex& tidx) {
+        return tidx.findLink(t, outgoing, arity, hsh); }));
+    if (not cand or not _copy_on_write or _transient) return cand;
+
+    // Copy-on-write: respect the AtomSpace membership of the given
+    // outgoing set, exactly as check() does.
+    const HandleSeq& cset(cand->getOutgoingSet());
+    for (size_t i = 0; i < arity; i++) {
+        AtomSpace* oa = outgoing[i]->getAtomSpace();
+        if (nullptr == oa)
+            return cand;
+        if (oa != cset[i]->getAtomSpace())
+            return Handle::UNDEFINED;
+    }
+    return cand;
+}
+
 /// Helper utility for adding atoms to the atomspace. Checks to see
 /// if the indicated atom already is in the atomspace. If it is, it
 /// returns that atom. Copies over values in the process.
@@ -249,6 +368,8 @@ Handle AtomSpace::check(const Handle& orig, bool force)
         if (hc->isAbsent()) {
             if (_read_only) return Handle::UNDEFINED;
             hc->setPresent();
+            index_insert(hc);
+            publish(AtomEvent::ADD, hc);
         }
         return hc;
     }
@@ -291,9 +412,15 @@ Handle AtomSpace::check(const Handle& orig, bool force)
     return cand;
 }
 
-Handle AtomSpace::add(const Handle& orig, bool force,
-                      bool recurse, bool absent)
+/// First half of add(): find the atom, if we already have it, else
+/// prepare it for insertion. If `fresh` is set on return, then the
+/// returned atom has not yet been placed in the incoming sets of its
+/// outgoing set, nor in the TypeIndex; the caller must do that.
+Handle AtomSpace::stage(const Handle& orig, bool force,
+                        bool recurse, bool absent, bool& fresh)
 {
+    fresh = false;
+
     // Can be null, if its a Value
     if (nullptr == orig) return Handle::UNDEFINED;
 
@@ -387,6 +514,16 @@ Handle AtomSpace::add(const Handle& orig, bool force,
     // up the incoming set.
     atom->setAtomSpace(this);
     atom->keep_incoming_set();
+    fresh = true;
+    return atom;
+}
+
+Handle AtomSpace::add(const Handle& orig, bool force,
+                      bool recurse, bool absent)
+{
+    bool fresh;
+    Handle atom(stage(orig, force, recurse, absent, fresh));
+    if (not fresh) return atom;
 
     // Set up the incoming set. We have to do this before the typeIndex
     // insert, because that is when this atom becomes visible to other
@@ -416,9 +553,53 @@ Handle AtomSpace::add(const Handle& orig, bool force,
         atom->remove();
         return oldh;
     }
+
+    // Absent markers are reported by extract_atom(), as extractions.
+    if (not absent)
+    {
+        index_insert(atom);
+        publish(AtomEvent::ADD, atom);
+    }
     return atom;
 }
 
+/// Second half of add(), for many staged atoms at once. On return,
+/// each staged atom is replaced by the one that is actually in the
+/// AtomSpace; almost always, this is the same atom.
+void AtomSpace::add_staged(HandleSeq& staged)
+{
+    // As in add(), the incoming sets must be set up before the atoms
+    // become visible in the TypeIndex.
+    HandleSeq links;
+    for (const Handle& h : staged)
+        if (h->is_link()) links.push_back(h);
+    Atom::install_links(links);
+
+    HandleSeq found;
+    typeIndex.insertAtoms(staged, found);
+
+    size_t sz = staged.size();
+    for (size_t i = 0; i < sz; i++)
+    {
+        const Handle& oldh(found[i]);
+        if (nullptr == oldh)
+        {
+            index_insert(staged[i]);
+            publish(AtomEvent::ADD, staged[i]);
+            continue;
+        }
+
+        // Some other thread raced us. Undo, exactly as in add().
+        Handle& atom(staged[i]);
+#if USE_INCOME_INDEX
+        incomeIndex.swapInset(atom, oldh);
+#endif
+        atom->setAtomSpace(nullptr);
+        atom->remove();
+        atom = oldh;
+    }
+}
+
 void AtomSpace::barrier()
 {
 }
@@ -446,6 +627,144 @@ size_t AtomSpace::get_num_atoms_of_type(Type type, bool subclass) const
     return result;
 }
 
+// Recursive extraction of an Atom with more than this many Atoms in
+// its incoming set is done in bulk, by extract_closure().
+static constexpr size_t BULK_EXTRACT_SIZE = 1024;
+
+/// Extract the entire incoming closure of `root`, that is, all of the
+/// Links that hold `root`, and all of the Links that hold those, and
+/// so on; but not `root` itself. The result is the same as extracting
+/// them one at a time; only the order in which the extractions are
+/// reported is different.
+///
+/// Returns false, having done nothing, if this does not apply: for
+/// small incoming sets, for copy-on-write spaces, and when some part
+/// of the closure lies in some other AtomSpace, or is an absent marker.
+/// The caller must then recurse one Atom at a time.
+bool AtomSpace::extract_closure(const Handle& root)
+{
+    if (_copy_on_write or root->getAtomSpace() != this) return false;
+    if (root->getIncomingSetSize() < BULK_EXTRACT_SIZE) return false;
+
+    // Collect the closure. The level of each atom is filled in below;
+    // SIZE_MAX means "not yet known".
+    std::unordered_map<const Atom*, size_t> level;
+    HandleSeq closure;
+    level[root.operator->()] = 0;
+    HandleSeq todo({root});
+    while (not todo.empty())
+    {
+        Handle h(std::move(todo.back()));
+        todo.pop_back();
+        for (const Handle& his : h->getIncomingSet())
+        {
+            if (his->isMarkedForRemoval()) continue;
+            if (not level.emplace(his.operator->(), SIZE_MAX).second) continue;
+            if (his->getAtomSpace() != this or his->isAbsent()) return false;
+            closure.push_back(his);
+            todo.push_back(his);
+        }
+    }
+
+    // The level of a Link is the length of the longest path from it
+    // down to the root. Links are extracted from the top level down,
+    // so that no Link is ever left holding an Atom that is gone.
+    // The paths are walked with a stack of our own, and not by
+    // recursion; closures can be far deeper than the call stack.
+    std::vector<std::pair<Handle, size_t>> stack;
+    for (const Handle& top : closure)
+    {
+        if (SIZE_MAX != level[top.operator->()]) continue;
+        stack.emplace_back(top, 0);
+        while (not stack.empty())
+        {
+            const Handle h(stack.back().first);
+            const HandleSeq& oset(h->getOutgoingSet());
+
+            // Do the members in the closure first.
+            size_t& next = stack.back().second;
+            Handle down;
+            while (nullptr == down and next < oset.size())
+            {
+                const Handle& o(oset[next++]);
+                auto it = level.find(o.operator->());
+                if (level.end() != it and SIZE_MAX == it->second) down = o;
+            }
+            if (nullptr != down)
+            {
+                stack.emplace_back(down, 0);
+                continue;
+            }
+
+            size_t d = 0;
+            for (const Handle& o : oset)
+            {
+                auto it = level.find(o.operator->());
+                if (level.end() != it) d = std::max(d, it->second + 1);
+            }
+            level[h.operator->()] = d;
+            stack.pop_back();
+        }
+    }
+
+    std::vector<HandleSeq> levels;
+    for (const Handle& h : closure)
+    {
+        size_t d = level[h.operator->()];
+        if (levels.size() <= d) levels.resize(d+1);
+        levels[d].push_back(h);
+    }
+
+    for (size_t lv = levels.size() - 1; 0 < lv; lv--)
+        extract_batch(levels[lv]);
+    return true;
+}
+
+/// Extract a batch of Links, none of which holds any of the others.
+/// This does the same steps as extract_atom() does for one Atom, but
+/// each step is done for the whole batch at once: the TypeIndex sets,
+/// and the incoming sets, are each locked only once.
+void AtomSpace::extract_batch(const HandleSeq& batch)
+{
+    // Skip those that some other thread is already extracting.
+    HandleSeq mine;
+    mine.reserve(batch.size());
+    for (const Handle& h : batch)
+        if (not h->markForRemoval()) mine.push_back(h);
+
+    // See extract_atom() for why the removal flag must be unset,
+    // if the atom is not in the index.
+    std::vector<char> gone;
+    typeIndex.removeAtoms(mine, gone);
+
+    HandleSeq extracted;
+    HandleSeq plain;
+    for (size_t i = 0; i < mine.size(); i++)
+    {
+        const Handle& h(mine[i]);
+        if (not gone[i])
+        {
+            h->unsetRemovalFlag();
+            continue;
+        }
+        extracted.push_back(h);
+        if (_nameserver.isA(h->get_type(), FRAME))
+            h->remove();
+        else
+            plain.push_back(h);
+    }
+
+    // Remove handles from other incoming sets.
+    Atom::remove_links(plain);
+
+    for (const Handle& h : extracted)
+    {
+        h->drop_incoming_set();
+        index_remove(h);
+        publish(AtomEvent::EXTRACT, h);
+    }
+}
+
 bool AtomSpace::extract_atom(const Handle& h, bool recursive)
 {
     if (nullptr == h) return false;
@@ -460,10 +779,12 @@ bool AtomSpace::extract_atom(const Handle& h, bool recursive)
     // If the recursive-flag is set, then extract all the links in the
     // atom's incoming set. This might not succeed, if those atoms are
     // in other (higher) atomspaces (because recursion must not reach up
-    // into those).
+    // into those). Large incoming sets are extracted in bulk.
     if (recursive)
     {
-        HandleSeq is(handle->getIncomingSet());
+        HandleSeq is;
+        if (not extract_closure(handle))
+            is = handle->getIncomingSet();
         for (const Handle& his : is)
         {
             AtomSpace* other = his->getAtomSpace();
@@ -505,6 +826,8 @@ bool AtomSpace::extract_atom(const Handle& h, bool recursive)
         // If we are here, then mask.
         const Handle& hide(add(handle, true, true, true));
         hide->setAbsent();
+        index_remove(hide);
+        publish(AtomEvent::EXTRACT, handle);
         return true;
     }
 
@@ -526,6 +849,8 @@ bool AtomSpace::extract_atom(const Handle& h, bool recursive)
         if (_copy_on_write) {
             const Handle& hide(add(handle, true, true, true));
             hide->setAbsent();
+            index_remove(hide);
+            publish(AtomEvent::EXTRACT, handle);
             return true;
         }
 
@@ -544,6 +869,8 @@ bool AtomSpace::extract_atom(const Handle& h, bool recursive)
             {
                 const Handle& hide(add(handle, true, true, true));
                 hide->setAbsent();
+                index_remove(hide);
+                publish(AtomEvent::EXTRACT, handle);
                 return true;
             }
         }
@@ -579,6 +906,8 @@ bool AtomSpace::extract_atom(const Handle& h, bool recursive)
     // Remove handle from other incoming sets.
     handle->remove();
     handle->drop_incoming_set();
+    index_remove(handle);
+    publish(AtomEvent::EXTRACT, handle);
     return true;
 }
 
@@ -745,6 +1074,60 @@ void AtomSpace::get_handles_by_type(UnorderedHandleSet& hset,
     shadow_by_type(hset, type, subclass, parent, cas);
 }
 
+/// Walk the atoms of the given type, in this space and, optionally,
+/// in the spaces below. The `top` space is the one that the user
+/// asked about; it determines which atoms are visible.
+bool AtomSpace::foreach_shadow(Type type,
+                               bool subclass,
+                               bool parent,
+                               const AtomSpace* top,
+                               const std::function<bool(const Handle&)>& cb) const
+{
+    bool found;
+    if (top->_copy_on_write)
+    {
+        // Report only the shallowest version of each atom. Deeper
+        // versions, and hidden atoms, will not compare equal.
+        found = typeIndex.foreach_atom(type, subclass,
+            [&](const Handle& h) -> bool
+            {
+                if (top->lookupHandle(h) != h) return false;
+                return cb(h);
+            });
+    }
+    else
+        found = typeIndex.foreach_atom(type, subclass, cb);
+
+    if (found) return true;
+    if (not parent) return false;
+
+    for (const AtomSpacePtr& base : _environ)
+        if (base->foreach_shadow(type, subclass, parent, top, cb))
+            return true;
+    return false;
+}
+
+bool AtomSpace::foreach_handle_by_type(Type type,
+                               const std::function<bool(const Handle&)>& cb,
+                               bool subclass,
+                               bool parent) const
+{
+    if (not subclass and type < ATOM) return false;
+    return foreach_shadow(type, subclass, parent, this, cb);
+}
+
+HandleCursorPtr AtomSpace::cursor_by_type(Type type,
+                                          bool subclass,
+                                          bool parent) const
+{
+    return std::make_shared<TypeCursor>(this, type, subclass, parent);
+}
+
+HandleCursorPtr AtomSpace::cursor_incoming(const Handle& h, Type type) const
+{
+    return std::make_shared<IncomingCursor>(h, this, type);
+}
+
 /**
  * Returns the set of atoms of a given type, but only if they have
  * and empty outgoing set.
@@ -0,0 +1,265 @@
+/*
+ * opencog/atomspace/ChangeFeed.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <opencog/atoms/atom_types/NameServer.h>
+#include <opencog/atoms/base/Atom.h>
+#include <opencog/util/exceptions.h>
+
+#include "ChangeFeed.h"
+
+using namespace opencog;
+
+// Largest batch handed to the subscribers in one go.
+static constexpr size_t MAX_BATCH = 1024;
+
+ChangeFeed::ChangeFeed(size_t capacity) :
+	_tail(0),
+	_head(0),
+	_next_id(1),
+	_nsubs(0),
+	_sleeping(false),
+	_delivered(0),
+	_stop(false)
+{
+	size_t cap = 2;
+	while (cap < capacity) cap <<= 1;
+	_mask = cap - 1;
+	_ring = new Slot[cap];
+	for (size_t i = 0; i < cap; i++)
+		_ring[i]._seq.store(i, std::memory_order_relaxed);
+
+	_consumer = std::thread(&ChangeFeed::run, this);
+	_consumer_id = _consumer.get_id();
+}
+
+/// Events still in the ring are dropped; the AtomSpace that owns
+/// this feed is going away, and the callbacks must not see it.
+ChangeFeed::~ChangeFeed()
+{
+	{
+		std::lock_guard<std::mutex> lck(_wake_mtx);
+		_stop = true;
+	}
+	_wake.notify_all();
+	_drained.notify_all();
+	_consumer.join();
+	delete[] _ring;
+}
+
+// ================================================================
+
+uint64_t ChangeFeed::subscribe(const FeedFilter& filter, const Callback& cb)
+{
+	// Callbacks run with the lock held.
+	std::unique_lock<std::mutex> lck(_sub_mtx, std::defer_lock);
+	if (std::this_thread::get_id() != _consumer_id) lck.lock();
+
+	uint64_t id = _next_id++;
+	_subs[id] = Subscriber{filter, cb};
+	_nsubs.store(_subs.size(), std::memory_order_relaxed);
+	return id;
+}
+
+void ChangeFeed::unsubscribe(uint64_t id)
+{
+	std::unique_lock<std::mutex> lck(_sub_mtx, std::defer_lock);
+	if (std::this_thread::get_id() != _consumer_id) lck.lock();
+
+	_subs.erase(id);
+	_nsubs.store(_subs.size(), std::memory_order_relaxed);
+}
+
+// ================================================================
+
+void ChangeFeed::publish(AtomEvent::Kind kind, const Handle& atom,
+                         const Handle& key, const ValuePtr& value)
+{
+	uint64_t pos = _tail.load(std::memory_order_relaxed);
+	Slot* slot;
+	while (true)
+	{
+		slot = &_ring[pos & _mask];
+		uint64_t seq = slot->_seq.load(std::memory_order_acquire);
+		int64_t dif = (int64_t) seq - (int64_t) pos;
+		if (0 == dif)
+		{
+			if (_tail.compare_exchange_weak(pos, pos + 1,
+			                                std::memory_order_relaxed))
+				break;
+		}
+		else if (dif < 0)
+		{
+			// The ring is full. If this is a callback, publishing
+			// more changes, then there is no one to make room but
+			// ourselves. Move the oldest events aside; they will be
+			// delivered next, ahead of everything still in the ring.
+			if (std::this_thread::get_id() == _consumer_id)
+			{
+				if (0 == drain(_backlog))
+					std::this_thread::yield();
+			}
+			else
+			{
+				_wake.notify_one();
+				std::this_thread::yield();
+			}
+			pos = _tail.load(std::memory_order_relaxed);
+		}
+		else
+			pos = _tail.load(std::memory_order_relaxed);
+	}
+
+	slot->_ev.seq = pos;
+	slot->_ev.kind = kind;
+	slot->_ev.atom = atom;
+	slot->_ev.key = key;
+	slot->_ev.value = value;
+	slot->_seq.store(pos + 1, std::memory_order_release);
+
+	// Pairs with the fence in run(); either the consumer sees the
+	// event, or we see that it is sleeping.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (_sleeping.load(std::memory_order_relaxed))
+	{
+		std::lock_guard<std::mutex> lck(_wake_mtx);
+		_wake.notify_one();
+	}
+}
+
+// ================================================================
+
+/// Move up to MAX_BATCH ready events out of the ring. Only the
+/// consumer thread calls this.
+size_t ChangeFeed::drain(std::vector<AtomEvent>& batch)
+{
+	size_t n = 0;
+	while (n < MAX_BATCH)
+	{
+		Slot& slot = _ring[_head & _mask];
+		if (slot._seq.load(std::memory_order_acquire) != _head + 1) break;
+
+		batch.emplace_back(std::move(slot._ev));
+		slot._ev.atom = Handle::UNDEFINED;
+		slot._ev.key = Handle::UNDEFINED;
+		slot._ev.value = nullptr;
+		slot._seq.store(_head + _mask + 1, std::memory_order_release);
+		_head++;
+		n++;
+	}
+	return n;
+}
+
+bool ChangeFeed::wanted(const FeedFilter& filter, const AtomEvent& ev)
+{
+	if (AtomEvent::CLEAR == ev.kind) return true;
+
+	if (filter.key)
+	{
+		if (AtomEvent::VALUE != ev.kind) return false;
+		if (filter.key != ev.key and *filter.key != *ev.key) return false;
+	}
+
+	Type t = ev.atom->get_type();
+	if (filter.subclass) return nameserver().isA(t, filter.type);
+	return t == filter.type;
+}
+
+void ChangeFeed::deliver(const std::vector<AtomEvent>& batch)
+{
+	std::lock_guard<std::mutex> lck(_sub_mtx);
+
+	// Callbacks may unsubscribe, so look each one up again.
+	std::vector<uint64_t> ids;
+	for (const auto& pr : _subs) ids.push_back(pr.first);
+
+	std::vector<AtomEvent> mine;
+	for (uint64_t id : ids)
+	{
+		auto it = _subs.find(id);
+		if (_subs.end() == it) continue;
+
+		// Unfiltered subscribers get the batch as it is.
+		const FeedFilter& filter(it->second.filter);
+		if (ATOM == filter.type and filter.subclass and nullptr == filter.key)
+		{
+			Callback cb(it->second.cb);
+			cb(batch);
+			continue;
+		}
+
+		mine.clear();
+		for (const AtomEvent& ev : batch)
+			if (wanted(filter, ev)) mine.push_back(ev);
+		if (mine.empty()) continue;
+
+		Callback cb(it->second.cb);
+		cb(mine);
+	}
+
+	_delivered.store(batch.back().seq + 1, std::memory_order_release);
+}
+
+// ================================================================
+
+void ChangeFeed::run(void)
+{
+	std::vector<AtomEvent> batch;
+	while (true)
+	{
+		// Anything set aside by publish() is older than what is
+		// still in the ring.
+		batch.clear();
+		batch.swap(_backlog);
+		drain(batch);
+		if (not batch.empty())
+		{
+			deliver(batch);
+			std::lock_guard<std::mutex> lck(_wake_mtx);
+			_drained.notify_all();
+			if (_stop) return;
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lck(_wake_mtx);
+		if (_stop) return;
+		_sleeping.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		Slot& slot = _ring[_head & _mask];
+		if (slot._seq.load(std::memory_order_acquire) != _head + 1)
+			_wake.wait_for(lck, std::chrono::milliseconds(100));
+		_sleeping.store(false, std::memory_order_relaxed);
+	}
+}
+
+void ChangeFeed::flush(void)
+{
+	if (std::this_thread::get_id() == _consumer_id)
+		throw RuntimeException(TRACE_INFO,
+			"ChangeFeed::flush() - cannot wait from within a callback!");
+
+	uint64_t target = _tail.load(std::memory_order_acquire);
+	std::unique_lock<std::mutex> lck(_wake_mtx);
+	while (not _stop and
+	       _delivered.load(std::memory_order_acquire) < target)
+		_drained.wait_for(lck, std::chrono::milliseconds(100));
+}
+
+// ======================= END OF FILE =================
@@ -0,0 +1,172 @@
+/*
+ * opencog/atomspace/ChangeFeed.h
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_CHANGE_FEED_H
+#define _OPENCOG_CHANGE_FEED_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <opencog/atoms/base/Handle.h>
+#include <opencog/atoms/value/Value.h>
+
+namespace opencog
+{
+/** \addtogroup grp_atomspace
+ *  @{
+ */
+
+/// One change to the contents of an AtomSpace.
+struct AtomEvent
+{
+	enum Kind
+	{
+		ADD,       // Atom was added.
+		EXTRACT,   // Atom was extracted, or hidden by an absent marker.
+		VALUE,     // Value on `key` was set to `value` (null if removed).
+		CLEAR,     // Everything was removed; `atom` is null.
+	};
+
+	/// Position in the feed. Starts at zero, and increases by one for
+	/// each event published, without gaps.
+	uint64_t seq;
+	Kind kind;
+	Handle atom;
+	Handle key;
+	ValuePtr value;
+};
+
+/// Which events a subscriber wants. Events are delivered if the atom
+/// is of type `type` (or a subtype, if `subclass` is set). If `key`
+/// is set, then only value changes on that key are delivered. CLEAR
+/// events are always delivered.
+struct FeedFilter
+{
+	Type type = ATOM;
+	bool subclass = true;
+	Handle key;
+};
+
+/**
+ * An ordered stream of AtomEvents, published by an AtomSpace, and
+ * delivered, in batches, to subscribers, on a thread belonging to the
+ * feed.
+ *
+ * Publishers write into a bounded, lock-free, multi-producer ring
+ * buffer; each slot carries its own sequence number, and publishers
+ * claim slots with a single compare-and-swap. If the ring is full,
+ * publishers wait for the consumer thread to make room; the feed
+ * never drops events. The consumer thread drains the ring, filters
+ * each batch for each subscriber, and invokes the callbacks.
+ *
+ * Callbacks run on the consumer thread, one at a time, in sequence
+ * order. They may read and modify the AtomSpace, and they may call
+ * `unsubscribe()`, but they must not wait on `flush()`.
+ */
+class ChangeFeed
+{
+public:
+	typedef std::function<void(const std::vector<AtomEvent>&)> Callback;
+
+private:
+	struct Slot
+	{
+		std::atomic<uint64_t> _seq;
+		AtomEvent _ev;
+	};
+
+	// Ring buffer. _tail is the next slot to be claimed by a
+	// publisher; _head is the next slot to be read by the consumer.
+	size_t _mask;
+	Slot* _ring;
+	alignas(64) std::atomic<uint64_t> _tail;
+	alignas(64) uint64_t _head;
+
+	// Events moved out of the ring, but not yet delivered. Only the
+	// consumer thread touches this.
+	std::vector<AtomEvent> _backlog;
+
+	struct Subscriber
+	{
+		FeedFilter filter;
+		Callback cb;
+	};
+
+	// Subscribers; guarded by _sub_mtx. The consumer holds this while
+	// delivering, so that unsubscribe() can promise that the callback
+	// is no longer running.
+	std::mutex _sub_mtx;
+	std::map<uint64_t, Subscriber> _subs;
+	uint64_t _next_id;
+	std::atomic<size_t> _nsubs;
+
+	// Consumer thread, and its wakeups.
+	std::thread _consumer;
+	std::thread::id _consumer_id;
+	std::mutex _wake_mtx;
+	std::condition_variable _wake;
+	std::condition_variable _drained;
+	std::atomic<bool> _sleeping;
+	std::atomic<uint64_t> _delivered;
+	bool _stop;
+
+	void run(void);
+	size_t drain(std::vector<AtomEvent>&);
+	void deliver(const std::vector<AtomEvent>&);
+	static bool wanted(const FeedFilter&, const AtomEvent&);
+
+public:
+	ChangeFeed(size_t capacity = 65536);
+	~ChangeFeed();
+
+	/// Register a callback; returns an id for unsubscribe().
+	uint64_t subscribe(const FeedFilter&, const Callback&);
+
+	/// Remove a subscription. When this returns, the callback is not
+	/// running, and will not be called again, unless this is called
+	/// from within a callback, in which case the callback will not be
+	/// called again after it returns.
+	void unsubscribe(uint64_t);
+
+	/// True if anyone is subscribed. Publishers check this first.
+	bool active(void) const
+	{
+		return 0 < _nsubs.load(std::memory_order_relaxed);
+	}
+
+	/// Append an event. Safe to call from any number of threads.
+	void publish(AtomEvent::Kind, const Handle& atom,
+	             const Handle& key = Handle::UNDEFINED,
+	             const ValuePtr& value = nullptr);
+
+	/// Wait until every event published so far has been delivered.
+	void flush(void);
+};
+
+/** @}*/
+} //namespace opencog
+
+#endif // _OPENCOG_CHANGE_FEED_H
@@ -0,0 +1,197 @@
+/*
+ * opencog/atomspace/ConcurrentAtomSet.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "ConcurrentAtomSet.h"
+
+using namespace opencog;
+
+// Smallest table. Most of the sets in a TypeIndex are empty, and are
+// never allocated; of the rest, many hold only a handful of Atoms.
+static constexpr size_t MIN_CAPACITY = 16;
+
+// Serial numbers for tables. A table might be allocated at the same
+// address as one that was freed, so the address cannot be used to
+// tell them apart.
+static std::atomic<uint64_t> table_serial(0);
+
+ConcurrentAtomSet::Table::Table(size_t cap) :
+	_mask(cap - 1),
+	_shift(64),
+	_used(0),
+	_serial(table_serial.fetch_add(1, std::memory_order_relaxed) + 1),
+	_slots(new Slot[cap])
+{
+	while (cap > 1) { cap >>= 1; _shift--; }
+}
+
+void ConcurrentAtomSet::free_table(void* t)
+{
+	delete (Table*) t;
+}
+
+ConcurrentAtomSet::~ConcurrentAtomSet()
+{
+	delete _table.load();
+}
+
+/// Rebuild the table, large enough that it is no more than half-full.
+/// This also purges tombstones; if there are many of them, the new
+/// table might be the same size as the old one.
+void ConcurrentAtomSet::grow(void)
+{
+	Table* old = _table.load(std::memory_order_relaxed);
+
+	size_t live = _size.load(std::memory_order_relaxed);
+	size_t cap = MIN_CAPACITY;
+	while (cap < 2 * (live + 1)) cap <<= 1;
+
+	Table* nt = new Table(cap);
+	if (old)
+	{
+		for (size_t i = 0; i <= old->_mask; i++)
+		{
+			Slot& os = old->_slots[i];
+			Atom* a = os._atom.load(std::memory_order_relaxed);
+			if (not is_live(a)) continue;
+
+			size_t j = nt->home(a->get_hash());
+			while (nullptr != nt->_slots[j]._atom.load(std::memory_order_relaxed))
+				j = (j+1) & nt->_mask;
+
+			// Readers still in the old table keep seeing the bare
+			// pointer; ownership moves to the new table. (Handle has
+			// no move ctor; swap avoids touching the use count.)
+			nt->_slots[j]._owner.swap(os._owner);
+			nt->_slots[j]._atom.store(a, std::memory_order_relaxed);
+			nt->_used++;
+		}
+	}
+
+	_table.store(nt, std::memory_order_release);
+	if (old) epoch_manager().retire(old, free_table);
+}
+
+Handle ConcurrentAtomSet::insert(const Handle& h)
+{
+	Table* t = _table.load(std::memory_order_relaxed);
+
+	// Keep the load factor, including tombstones, under 3/4. This
+	// guarantees that probing always finds an empty slot.
+	if (nullptr == t or 4 * (t->_used + 1) > 3 * t->capacity())
+	{
+		grow();
+		t = _table.load(std::memory_order_relaxed);
+	}
+
+	const Atom* ha = h.const_atom_ptr();
+	ContentHash hsh = ha->get_hash();
+	Slot* grave = nullptr;
+	size_t i = t->home(hsh);
+	while (true)
+	{
+		Slot& s = t->_slots[i];
+		Atom* a = s._atom.load(std::memory_order_relaxed);
+		if (nullptr == a) break;
+		if (not is_live(a))
+		{
+			if (nullptr == grave) grave = &s;
+		}
+		else if (a == ha or (a->get_hash() == hsh and *a == *ha))
+			return s._owner;
+		i = (i+1) & t->_mask;
+	}
+
+	// Not found. Re-use the first tombstone, if we passed one.
+	Slot* s = grave;
+	if (nullptr == s)
+	{
+		s = &t->_slots[i];
+		t->_used++;
+	}
+
+	// Set the owner first; the atom becomes visible to readers
+	// at the store.
+	s->_owner = h;
+	s->_atom.store(h.get(), std::memory_order_release);
+	_size.fetch_add(1, std::memory_order_relaxed);
+	return Handle::UNDEFINED;
+}
+
+Handle ConcurrentAtomSet::erase(const Handle& h)
+{
+	Table* t = _table.load(std::memory_order_relaxed);
+	if (nullptr == t) return Handle::UNDEFINED;
+
+	const Atom* ha = h.const_atom_ptr();
+	ContentHash hsh = ha->get_hash();
+	size_t i = t->home(hsh);
+	for (size_t n = 0; n <= t->_mask; n++, i = (i+1) & t->_mask)
+	{
+		Slot& s = t->_slots[i];
+		Atom* a = s._atom.load(std::memory_order_relaxed);
+		if (nullptr == a) break;
+		if (not is_live(a)) continue;
+		if (a == ha or (a->get_hash() == hsh and *a == *ha))
+		{
+			Handle gone;
+			gone.swap(s._owner);
+			s._atom.store(tombstone(), std::memory_order_release);
+			_size.fetch_sub(1, std::memory_order_relaxed);
+			return gone;
+		}
+	}
+	return Handle::UNDEFINED;
+}
+
+void ConcurrentAtomSet::clear(void)
+{
+	Table* t = _table.exchange(nullptr);
+	_size.store(0);
+	if (t) epoch_manager().retire(t, free_table);
+}
+
+bool ConcurrentAtomSet::resume(Position& pos, size_t n,
+                               HandleSeq& out, bool& moved) const
+{
+	const Table* t = _table.load(std::memory_order_acquire);
+	uint64_t serial = t ? t->_serial : 0;
+	if (pos._serial != serial)
+	{
+		// A fresh Position has not been anywhere yet.
+		moved = (0 != pos._serial);
+		pos._serial = serial;
+		pos._slot = 0;
+	}
+	if (nullptr == t) return false;
+
+	size_t i = pos._slot;
+	for (; i <= t->_mask and 0 < n; i++)
+	{
+		Atom* a = t->_slots[i]._atom.load(std::memory_order_acquire);
+		if (not is_live(a)) continue;
+		out.emplace_back(make_handle(a));
+		n--;
+	}
+	pos._slot = i;
+	return i <= t->_mask;
+}
+
+// ======================= END OF FILE =================
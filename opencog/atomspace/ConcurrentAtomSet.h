@@ -0,0 +1,321 @@
+/*
+ * opencog/atomspace/ConcurrentAtomSet.h
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_CONCURRENT_ATOM_SET_H
+#define _OPENCOG_CONCURRENT_ATOM_SET_H
+
+#include <atomic>
+#include <cstring>
+#include <iterator>
+#include <thread>
+
+#include <opencog/atoms/base/Atom.h>
+#include <opencog/atoms/base/Handle.h>
+#include <opencog/atomspace/Epoch.h>
+
+namespace opencog
+{
+/** \addtogroup grp_atomspace
+ *  @{
+ */
+
+/// Tiny writer lock. One byte, instead of the 40 or 56 of the std
+/// mutexes. Critical sections are a few dozen instructions long, so
+/// spinning is almost always cheaper than sleeping.
+class AtomSetLock
+{
+	std::atomic<bool> _flag;
+public:
+	AtomSetLock(void) : _flag(false) {}
+	void lock(void)
+	{
+		while (_flag.exchange(true, std::memory_order_acquire))
+		{
+			int spins = 0;
+			while (_flag.load(std::memory_order_relaxed))
+				if (64 < ++spins) std::this_thread::yield();
+		}
+	}
+	bool try_lock(void)
+	{
+		return not _flag.exchange(true, std::memory_order_acquire);
+	}
+	void unlock(void)
+	{
+		_flag.store(false, std::memory_order_release);
+	}
+};
+
+/**
+ * Open-addressing hash set of Atoms, with lock-free lookup and
+ * iteration. Writers (insert, erase) must hold `_mtx`. Readers
+ * (find, iteration) must hold an EpochGuard, and take no locks.
+ *
+ * Each slot holds an atomic bare pointer, which is all that readers
+ * ever look at, and the owning Handle, which only writers touch.
+ * Erased slots become tombstones; the owning Handle is retired to
+ * the EpochManager, so that readers that are still looking at the
+ * Atom do not see it vanish out from under them. When the table
+ * grows, the old table is likewise retired.
+ *
+ * Linear probing is used. The home slot is taken from the high bits
+ * of the (Fibonacci-scrambled) content hash, because the TypeIndex
+ * already uses the low bits to pick the set.
+ */
+class ConcurrentAtomSet
+{
+	struct Slot
+	{
+		std::atomic<Atom*> _atom;
+		Handle _owner;
+		Slot(void) : _atom(nullptr) {}
+	};
+
+	struct Table
+	{
+		size_t _mask;
+		int _shift;
+		size_t _used;  // Live plus tombstones. Writers only.
+		uint64_t _serial;  // Unique to this table, never reused.
+		Slot* _slots;
+
+		Table(size_t cap);
+		~Table() { delete[] _slots; }
+		size_t capacity(void) const { return _mask + 1; }
+		size_t home(ContentHash hsh) const {
+			return (hsh * 0x9e3779b97f4a7c15ULL) >> _shift;
+		}
+	};
+
+	static inline Atom* tombstone(void) {
+		return reinterpret_cast<Atom*>(uintptr_t(1));
+	}
+	static inline bool is_live(const Atom* a) {
+		return uintptr_t(1) < reinterpret_cast<uintptr_t>(a);
+	}
+
+	// The aliasing ctor avoids the dynamic_cast in get_handle().
+	static inline Handle make_handle(Atom* a) {
+		return Handle(AtomPtr(a->shared_from_this(), a));
+	}
+
+	std::atomic<Table*> _table;
+	std::atomic<size_t> _size;
+
+	void grow(void);
+	static void free_table(void*);
+
+public:
+	mutable AtomSetLock _mtx;
+
+	ConcurrentAtomSet(void) : _table(nullptr), _size(0) {}
+	ConcurrentAtomSet(ConcurrentAtomSet&& other) noexcept :
+		_table(other._table.exchange(nullptr)),
+		_size(other._size.exchange(0))
+	{}
+	ConcurrentAtomSet(const ConcurrentAtomSet&) = delete;
+	ConcurrentAtomSet& operator=(const ConcurrentAtomSet&) = delete;
+	~ConcurrentAtomSet();
+
+	/// Return the Atom in the set that is equal to `h`, else return
+	/// Handle::UNDEFINED. Lock-free; caller must hold an EpochGuard.
+	Handle find(const Handle& h) const
+	{
+		const Table* t = _table.load(std::memory_order_acquire);
+		if (nullptr == t) return Handle::UNDEFINED;
+
+		const Atom* ha = h.const_atom_ptr();
+		ContentHash hsh = ha->get_hash();
+		size_t i = t->home(hsh);
+		for (size_t n = 0; n <= t->_mask; n++, i = (i+1) & t->_mask)
+		{
+			Atom* a = t->_slots[i]._atom.load(std::memory_order_acquire);
+			if (nullptr == a) break;
+			if (not is_live(a)) continue;
+			if (a == ha or (a->get_hash() == hsh and *a == *ha))
+				return make_handle(a);
+		}
+		return Handle::UNDEFINED;
+	}
+
+	/// Return the Node of type `t` with the given name, else return
+	/// Handle::UNDEFINED. Same as find(), but without needing a Node
+	/// to compare to; `hsh` must be what Node::compute_hash() gives.
+	/// Lock-free; caller must hold an EpochGuard.
+	Handle find_node(Type t, const char* name, size_t len,
+	                 ContentHash hsh) const
+	{
+		const Table* tab = _table.load(std::memory_order_acquire);
+		if (nullptr == tab) return Handle::UNDEFINED;
+
+		size_t i = tab->home(hsh);
+		for (size_t n = 0; n <= tab->_mask; n++, i = (i+1) & tab->_mask)
+		{
+			Atom* a = tab->_slots[i]._atom.load(std::memory_order_acquire);
+			if (nullptr == a) break;
+			if (not is_live(a)) continue;
+			if (a->get_hash() != hsh or a->get_type() != t) continue;
+			const std::string& an(a->get_name());
+			if (an.size() == len and 0 == memcmp(an.data(), name, len))
+				return make_handle(a);
+		}
+		return Handle::UNDEFINED;
+	}
+
+	/// Return the Link of type `t` with the given outgoing set, else
+	/// return Handle::UNDEFINED. Same as find(), but without needing
+	/// a Link to compare to; `hsh` must be what Link::compute_hash()
+	/// gives. Lock-free; caller must hold an EpochGuard.
+	Handle find_link(Type t, const Handle* outgoing, size_t arity,
+	                 ContentHash hsh) const
+	{
+		const Table* tab = _table.load(std::memory_order_acquire);
+		if (nullptr == tab) return Handle::UNDEFINED;
+
+		size_t i = tab->home(hsh);
+		for (size_t n = 0; n <= tab->_mask; n++, i = (i+1) & tab->_mask)
+		{
+			Atom* a = tab->_slots[i]._atom.load(std::memory_order_acquire);
+			if (nullptr == a) break;
+			if (not is_live(a)) continue;
+			if (a->get_hash() != hsh or a->get_type() != t) continue;
+			const HandleSeq& oset(a->getOutgoingSet());
+			if (oset.size() != arity) continue;
+			size_t j = 0;
+			for (; j < arity; j++)
+				if (oset[j] != outgoing[j] and *oset[j] != *outgoing[j])
+					break;
+			if (j == arity) return make_handle(a);
+		}
+		return Handle::UNDEFINED;
+	}
+
+	/// If an equal Atom is already in the set, return it. Otherwise,
+	/// insert `h` and return Handle::UNDEFINED. Caller must hold `_mtx`.
+	Handle insert(const Handle&);
+
+	/// Remove the Atom equal to `h`. Return the Handle that the set
+	/// was holding, else Handle::UNDEFINED. The caller should retire
+	/// the returned Handle, after dropping the lock. Caller must hold
+	/// `_mtx`.
+	Handle erase(const Handle&);
+
+	/// Remove everything. The tables are retired, not freed; use
+	/// EpochManager::synchronize() to wait for them to go away.
+	/// Caller must hold `_mtx`.
+	void clear(void);
+
+	/// Exchange the contents with `other`. Caller must hold the locks
+	/// of both, unless one of them is not yet shared. Readers of either
+	/// set may briefly see the contents of the other.
+	void swap(ConcurrentAtomSet& other)
+	{
+		Table* t = _table.load(std::memory_order_relaxed);
+		_table.store(other._table.load(std::memory_order_relaxed),
+		             std::memory_order_release);
+		other._table.store(t, std::memory_order_release);
+		size_t n = _size.load(std::memory_order_relaxed);
+		_size.store(other._size.load(std::memory_order_relaxed),
+		            std::memory_order_relaxed);
+		other._size.store(n, std::memory_order_relaxed);
+	}
+
+	size_t size(void) const { return _size.load(std::memory_order_relaxed); }
+
+	/// Bytes of heap used by the table. Caller must hold an EpochGuard.
+	size_t bytes(void) const
+	{
+		const Table* t = _table.load(std::memory_order_acquire);
+		if (nullptr == t) return 0;
+		return sizeof(Table) + t->capacity() * sizeof(Slot);
+	}
+	bool empty(void) const { return 0 == size(); }
+
+	/// Iterator over a snapshot of the table. Safe against concurrent
+	/// insertion and removal, as long as the caller holds an EpochGuard
+	/// for the entire lifetime of the iterator. Atoms inserted or
+	/// removed during the iteration may or may not be seen.
+	class const_iterator
+	{
+		const Table* _t;
+		size_t _i;
+		Handle _h;
+
+		void settle(void)
+		{
+			for (; _t and _i <= _t->_mask; _i++)
+			{
+				Atom* a = _t->_slots[_i]._atom.load(std::memory_order_acquire);
+				if (is_live(a)) { _h = make_handle(a); return; }
+			}
+			_t = nullptr;
+			_i = 0;
+			_h = Handle::UNDEFINED;
+		}
+
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef Handle value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const Handle* pointer;
+		typedef const Handle& reference;
+
+		const_iterator(void) : _t(nullptr), _i(0) {}
+		const_iterator(const Table* t) : _t(t), _i(0) { settle(); }
+
+		reference operator*() const { return _h; }
+		pointer operator->() const { return &_h; }
+		const_iterator& operator++() { _i++; settle(); return *this; }
+		const_iterator operator++(int)
+			{ const_iterator tmp(*this); ++(*this); return tmp; }
+		bool operator==(const const_iterator& other) const
+			{ return _t == other._t and _i == other._i; }
+		bool operator!=(const const_iterator& other) const
+			{ return not operator==(other); }
+	};
+	typedef const_iterator iterator;
+
+	const_iterator begin(void) const
+		{ return const_iterator(_table.load(std::memory_order_acquire)); }
+	const_iterator end(void) const { return const_iterator(); }
+
+	/// Where a walk left off, for walks that cannot hold an EpochGuard
+	/// from start to finish. Slot numbers are meaningful only in the
+	/// table they were taken from; the serial number identifies it.
+	struct Position
+	{
+		uint64_t _serial = 0;
+		size_t _slot = 0;
+	};
+
+	/// Copy up to `n` Atoms into `out`, resuming the walk at `pos`,
+	/// and leave `pos` where the next call should resume. Returns
+	/// false once the walk is finished. If the table was replaced
+	/// since `pos` was taken (because it grew, or was cleared), then
+	/// `moved` is set, and the walk starts over at the beginning of
+	/// the new table. Caller must hold an EpochGuard.
+	bool resume(Position& pos, size_t n, HandleSeq& out, bool& moved) const;
+};
+
+/** @}*/
+} // namespace opencog
+
+#endif // _OPENCOG_CONCURRENT_ATOM_SET_H
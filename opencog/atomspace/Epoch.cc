@@ -0,0 +1,251 @@
+/*
+ * opencog/atomspace/Epoch.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <thread>
+
+#include <opencog/atoms/base/Atom.h>
+#include "Epoch.h"
+
+using namespace opencog;
+
+// The manager is never destroyed. Atoms can be extracted (and thus
+// retired) during static destruction, e.g. when some global AtomSpace
+// goes away. A function-local static might already be gone by then.
+EpochManager& opencog::epoch_manager(void)
+{
+	static EpochManager* _instance = new EpochManager();
+	return *_instance;
+}
+
+EpochManager::EpochManager(void) :
+	_global_epoch(STEP),
+	_records(nullptr),
+	_num_retired(0)
+{
+}
+
+// ================================================================
+// Thread records.
+
+EpochManager::Record* EpochManager::acquire_record(void)
+{
+	// Recycle a record from some thread that has exited.
+	for (Record* r = _records.load(); r; r = r->_next)
+	{
+		bool expect = false;
+		if (not r->_in_use.load() and
+		    r->_in_use.compare_exchange_strong(expect, true))
+			return r;
+	}
+
+	// Nothing to recycle. Push a new one onto the list.
+	Record* r = new Record();
+	Record* head = _records.load();
+	do { r->_next = head; }
+	while (not _records.compare_exchange_weak(head, r));
+	return r;
+}
+
+void EpochManager::release_record(Record* r)
+{
+	r->_depth = 0;
+	r->_epoch.store(0);
+	r->_in_use.store(false);
+
+	// The exiting thread may have been the last one holding up
+	// reclamation.
+	if (0 < _num_retired.load()) collect();
+}
+
+EpochManager::Record* EpochManager::my_record(void)
+{
+	struct Holder
+	{
+		Record* _rec;
+		Holder(void) : _rec(epoch_manager().acquire_record()) {}
+		~Holder() { epoch_manager().release_record(_rec); }
+	};
+	static thread_local Holder holder;
+	return holder._rec;
+}
+
+// ================================================================
+// Read-side critical sections.
+
+void EpochManager::enter(Record* r)
+{
+	if (0 < r->_depth++) return;
+
+	// Announce the epoch, and then verify that it did not move
+	// while we were announcing it. If it moved, some advancer
+	// might not have seen us, so try again.
+	uint64_t e = _global_epoch.load();
+	while (true)
+	{
+		r->_epoch.store(e | ACTIVE);
+		uint64_t again = _global_epoch.load();
+		if (again == e) break;
+		e = again;
+	}
+}
+
+void EpochManager::leave(Record* r)
+{
+	if (0 < --r->_depth) return;
+	r->_epoch.store(0);
+
+	// If we were holding up reclamation, then try to unblock it.
+	if (0 < _num_retired.load(std::memory_order_relaxed))
+		collect();
+}
+
+bool EpochManager::in_critical_section(void) const
+{
+	return 0 < my_record()->_depth;
+}
+
+EpochGuard::EpochGuard(void) :
+	_rec(EpochManager::my_record())
+{
+	epoch_manager().enter(_rec);
+}
+
+EpochGuard::~EpochGuard()
+{
+	epoch_manager().leave(_rec);
+}
+
+// ================================================================
+// Reclamation.
+
+void EpochManager::Limbo::release(void)
+{
+	_atoms.clear();
+	for (const auto& pr : _blocks)
+		pr.second(pr.first);
+	_blocks.clear();
+}
+
+void EpochManager::Limbo::append(Limbo& other)
+{
+	// Handle has no move ctor; swap instead of copying.
+	for (Handle& h : other._atoms)
+	{
+		_atoms.emplace_back();
+		_atoms.back().swap(h);
+	}
+	other._atoms.clear();
+	_blocks.insert(_blocks.end(), other._blocks.begin(), other._blocks.end());
+	other._blocks.clear();
+}
+
+/// Advance the global epoch, if every active reader has caught up
+/// with it. Whatever was retired two epochs ago is moved to `freed`.
+/// Must be called with the limbo lock held.
+bool EpochManager::try_advance(Limbo& freed)
+{
+	uint64_t e = _global_epoch.load();
+	for (Record* r = _records.load(); r; r = r->_next)
+	{
+		uint64_t re = r->_epoch.load();
+		if ((re & ACTIVE) and (re & ~ACTIVE) != e) return false;
+	}
+
+	// Everyone is caught up. Advancing is safe.
+	uint64_t ne = e + STEP;
+	_global_epoch.store(ne);
+
+	// Objects retired during epoch ne-2 share the slot with ne+1.
+	freed.append(_limbo[(ne / STEP + 1) % 3]);
+	return true;
+}
+
+/// Release everything that can be released. Does not wait on the
+/// lock; if someone else is collecting, they'll get it.
+void EpochManager::collect(void)
+{
+	Limbo freed;
+	{
+		std::unique_lock<std::mutex> lck(_limbo_mtx, std::try_to_lock);
+		if (not lck.owns_lock()) return;
+
+		// Three advances drain all three lists.
+		for (int i=0; i<3; i++)
+		{
+			if (_limbo[0].empty() and _limbo[1].empty() and _limbo[2].empty())
+				break;
+			if (not try_advance(freed)) break;
+		}
+	}
+
+	// Release outside of the lock. Atom destructors can run here,
+	// and those might cascade into yet more destructors.
+	size_t cnt = freed.size();
+	freed.release();
+	_num_retired -= cnt;
+}
+
+void EpochManager::retire(Handle&& h)
+{
+	{
+		std::lock_guard<std::mutex> lck(_limbo_mtx);
+		auto& atoms = _limbo[(_global_epoch.load() / STEP) % 3]._atoms;
+		atoms.emplace_back();
+		atoms.back().swap(h);
+		_num_retired++;
+	}
+
+	// In the common case, there are no readers, and the Atom
+	// is released right away.
+	collect();
+}
+
+void EpochManager::retire(void* blk, Deleter del)
+{
+	std::lock_guard<std::mutex> lck(_limbo_mtx);
+	_limbo[(_global_epoch.load() / STEP) % 3]._blocks.emplace_back(blk, del);
+	_num_retired++;
+}
+
+/// Wait until everything retired before this call has been released.
+/// This is a no-op if called from within a critical section (as it
+/// would otherwise deadlock, waiting on itself.)
+void EpochManager::synchronize(void)
+{
+	if (in_critical_section()) return;
+
+	uint64_t target = _global_epoch.load() + 2*STEP;
+	while (_global_epoch.load() < target)
+	{
+		Limbo freed;
+		bool moved;
+		{
+			std::lock_guard<std::mutex> lck(_limbo_mtx);
+			moved = try_advance(freed);
+		}
+		size_t cnt = freed.size();
+		freed.release();
+		_num_retired -= cnt;
+		if (not moved) std::this_thread::yield();
+	}
+}
+
+// ======================= END OF FILE =================
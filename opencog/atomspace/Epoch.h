@@ -0,0 +1,146 @@
+/*
+ * opencog/atomspace/Epoch.h
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_EPOCH_H
+#define _OPENCOG_EPOCH_H
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include <opencog/atoms/base/Handle.h>
+
+namespace opencog
+{
+/** \addtogroup grp_atomspace
+ *  @{
+ */
+
+/**
+ * Epoch-based reclamation (EBR). This allows readers to walk shared
+ * data structures without taking any locks, while writers continue
+ * to modify them. Writers never free anything directly; instead,
+ * they "retire" it. Retired objects are freed only after every
+ * reader that might have seen them has left its critical section.
+ *
+ * The classic three-epoch scheme is used. There is a global epoch
+ * counter; each reader thread announces the epoch it entered in.
+ * The global epoch can advance only when all active readers have
+ * caught up to it. Anything retired during epoch E is freed when
+ * the global epoch reaches E+2.
+ *
+ * Readers pay for two stores and a fence on entry, and one store on
+ * exit. Critical sections nest; only the outermost one counts.
+ *
+ * The primary user is the TypeIndex, which hands out Atoms that are
+ * concurrently being extracted. Retired Atoms are held (by Handle)
+ * until they can no longer be seen by any reader; in the common case,
+ * where there are no concurrent readers, they are released immediately.
+ */
+class EpochManager
+{
+	friend class EpochGuard;
+
+	// Per-thread record. These are never freed; when a thread exits,
+	// the record is returned to the pool, for use by the next thread.
+	struct Record
+	{
+		std::atomic<uint64_t> _epoch;
+		std::atomic<bool> _in_use;
+		unsigned int _depth;
+		Record* _next;
+		Record() : _epoch(0), _in_use(true), _depth(0), _next(nullptr) {}
+	};
+
+	// The lowest bit flags an active reader; the epoch is in the
+	// remaining bits.
+	static constexpr uint64_t ACTIVE = 1;
+	static constexpr uint64_t STEP = 2;
+
+	std::atomic<uint64_t> _global_epoch;
+	std::atomic<Record*> _records;
+
+	typedef void (*Deleter)(void*);
+	struct Limbo
+	{
+		std::vector<Handle> _atoms;
+		std::vector<std::pair<void*, Deleter>> _blocks;
+		bool empty(void) const { return _atoms.empty() and _blocks.empty(); }
+		size_t size(void) const { return _atoms.size() + _blocks.size(); }
+		void append(Limbo&);
+		void release(void);
+	};
+	std::mutex _limbo_mtx;
+	Limbo _limbo[3];
+	std::atomic<size_t> _num_retired;
+
+	Record* acquire_record(void);
+	void release_record(Record*);
+	static Record* my_record(void);
+
+	bool try_advance(Limbo&);
+	void collect(void);
+
+	void enter(Record*);
+	void leave(Record*);
+
+public:
+	EpochManager(void);
+	EpochManager(const EpochManager&) = delete;
+	EpochManager& operator=(const EpochManager&) = delete;
+
+	/// Release the Atom when no reader can see it any longer.
+	void retire(Handle&&);
+
+	/// Free the block of memory when no reader can see it any longer.
+	void retire(void*, Deleter);
+
+	/// Wait until everything retired so far has been released.
+	void synchronize(void);
+
+	/// Return true if the calling thread is in a critical section.
+	bool in_critical_section(void) const;
+
+	/// Number of retired objects not yet released.
+	size_t pending(void) const { return _num_retired.load(); }
+};
+
+EpochManager& epoch_manager(void);
+
+/**
+ * RAII guard marking a read-side critical section. While any guard
+ * is live, nothing that this thread can reach through a concurrent
+ * container will be freed. Guards nest.
+ */
+class EpochGuard
+{
+	EpochManager::Record* _rec;
+public:
+	EpochGuard(void);
+	~EpochGuard();
+	EpochGuard(const EpochGuard&) = delete;
+	EpochGuard& operator=(const EpochGuard&) = delete;
+};
+
+/** @}*/
+} // namespace opencog
+
+#endif // _OPENCOG_EPOCH_H
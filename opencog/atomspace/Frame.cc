@@ -98,21 +98,6 @@ void Frame::scrub_incoming_set(void)
 	nameserver().getChildrenRecursive(FRAME, back_inserter(framet));
 	InSetMap& iset = get_inset_map();
 	for (Type t : framet)
-	{
-		auto bucket = iset.find(t);
-		if (bucket == iset.end()) continue;
-		for (auto bi = bucket->second.begin(); bi != bucket->second.end();)
-		{
-			if (0 == bi->use_count())
-#if HAVE_SPARSEHASH
-				// sparsehash erase does not invalidate iterators.
-				bucket->second.erase(bi);
-			bi++;
-#else
-				bi = bucket->second.erase(bi);
-			else bi++;
-#endif
-		}
-	}
+		iset.erase_expired(t);
 #endif
 }
@@ -0,0 +1,167 @@
+/*
+ * opencog/atomspace/HandleCursor.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <opencog/atoms/atom_types/NameServer.h>
+
+#include "AtomSpace.h"
+#include "HandleCursor.h"
+
+using namespace opencog;
+
+// ================================================================
+
+// Same order as AtomSpace::foreach_shadow(): this space first, then
+// the ones under it, depth first.
+static void collect_spaces(const AtomSpacePtr& as, bool parent,
+                           std::vector<AtomSpacePtr>& spaces)
+{
+	spaces.push_back(as);
+	if (not parent) return;
+	for (const AtomSpacePtr& base : as->getEnviron())
+		collect_spaces(base, parent, spaces);
+}
+
+TypeCursor::TypeCursor(const AtomSpace* as, Type type,
+                       bool subclass, bool parent) :
+	_top(AtomSpaceCast(const_cast<AtomSpace*>(as))),
+	_ispace(0),
+	_itype(0),
+	_started(false)
+{
+	// Value types are not in the TypeIndex.
+	if (not subclass)
+	{
+		if (nameserver().isA(type, ATOM)) _types.push_back(type);
+	}
+	else
+	{
+		for (Type t : nameserver().getSubtypes(type))
+			if (nameserver().isA(t, ATOM)) _types.push_back(t);
+	}
+
+	if (not _types.empty())
+		collect_spaces(_top, parent, _spaces);
+}
+
+size_t TypeCursor::next(HandleSeq& chunk, size_t n)
+{
+	size_t start = chunk.size();
+	while (chunk.size() - start < n and _ispace < _spaces.size())
+	{
+		if (_types.size() <= _itype)
+		{
+			_ispace++;
+			_itype = 0;
+			continue;
+		}
+
+		const TypeIndex& tidx(_spaces[_ispace]->typeIndex);
+		Type t = _types[_itype];
+
+		// Skip over the empty types, without visiting all the sets.
+		if (not _started and 0 == tidx.size(t))
+		{
+			_itype++;
+			continue;
+		}
+		_started = true;
+
+		size_t base = chunk.size();
+		bool more = tidx.next_of_type(t, _where, n - (base - start), chunk);
+
+		// Report only the shallowest version of each atom. Deeper
+		// versions, and hidden atoms, will not compare equal.
+		if (_top->_copy_on_write)
+		{
+			size_t j = base;
+			for (size_t i = base; i < chunk.size(); i++)
+			{
+				if (_top->lookupHandle(chunk[i]) != chunk[i]) continue;
+				if (i != j) chunk[j] = chunk[i];
+				j++;
+			}
+			chunk.resize(j);
+		}
+
+		if (not more)
+		{
+			_itype++;
+			_started = false;
+			_where = TypeIndex::Resume();
+		}
+	}
+	return chunk.size() - start;
+}
+
+// ================================================================
+
+IncomingCursor::IncomingCursor(const Handle& h, const AtomSpace* as,
+                               Type type) :
+	_atom(h),
+	_next(0)
+{
+	if (as) _as = AtomSpaceCast(const_cast<AtomSpace*>(as));
+
+	// Same as Atom::getIncomingSet(): Frames hold only Frames, and
+	// are not filtered.
+	if (as and nameserver().isA(h->get_type(), FRAME))
+		_as = nullptr;
+
+#if USE_BARE_BACKPOINTER
+	// Bare pointers can dangle, once the lock is dropped.
+	bool snapshot = true;
+#else
+	bool snapshot = _as and _as->get_copy_on_write();
+#endif
+	if (snapshot)
+	{
+		if (NOTYPE == type)
+			_links = h->getIncomingSet(_as.get());
+		else
+			_links = h->getIncomingSetByType(type, _as.get());
+		_as = nullptr;
+		return;
+	}
+
+	h->getIncomingWinks(_winks, type);
+}
+
+size_t IncomingCursor::next(HandleSeq& chunk, size_t n)
+{
+	size_t start = chunk.size();
+	if (not _links.empty())
+	{
+		for (; _next < _links.size() and chunk.size() - start < n; _next++)
+			chunk.emplace_back(_links[_next]);
+		return chunk.size() - start;
+	}
+
+	for (; _next < _winks.size() and chunk.size() - start < n; _next++)
+	{
+		WEAKLY_DO(l, _winks[_next], {
+			if (nullptr == _as or _as->in_environ(l))
+				chunk.emplace_back(l);
+		})
+	}
+	return chunk.size() - start;
+}
+
+// ======================= END OF FILE =================
@@ -0,0 +1,160 @@
+/*
+ * opencog/atomspace/HandleCursor.h
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_HANDLE_CURSOR_H
+#define _OPENCOG_HANDLE_CURSOR_H
+
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include <opencog/atoms/base/Atom.h>
+#include <opencog/atoms/base/Handle.h>
+#include <opencog/atomspace/TypeIndex.h>
+
+namespace opencog
+{
+/** \addtogroup grp_atomspace
+ *  @{
+ */
+
+class AtomSpace;
+typedef std::shared_ptr<AtomSpace> AtomSpacePtr;
+
+/**
+ * A cursor hands out Handles a chunk at a time, without first
+ * gathering all of them into one big HandleSeq. A consumer that
+ * stops early pays only for the chunks that it asked for.
+ *
+ * No locks are held between chunks, so a cursor that is not being
+ * read does not hold up anyone else, and the cursor may be read
+ * while atoms are being added and extracted. Atoms added or extracted
+ * while the cursor is open may or may not be reported; the others
+ * are reported exactly once.
+ *
+ * A cursor is not thread-safe; each thread should have its own.
+ */
+class HandleCursor
+{
+public:
+	static constexpr size_t DEFAULT_CHUNK = 1024;
+
+	virtual ~HandleCursor() {}
+
+	/// Append up to `n` more Handles to `chunk`, and return how many
+	/// were appended. Zero means that the cursor is used up.
+	virtual size_t next(HandleSeq& chunk, size_t n = DEFAULT_CHUNK) = 0;
+
+	/// Input iterator, fetching `n` Handles at a time from the cursor.
+	class iterator
+	{
+		HandleCursor* _cur;
+		size_t _n;
+		HandleSeq _buf;
+		size_t _i;
+
+		void fill(void)
+		{
+			_buf.clear();
+			_i = 0;
+			if (0 == _cur->next(_buf, _n)) _cur = nullptr;
+		}
+
+	public:
+		typedef std::input_iterator_tag iterator_category;
+		typedef Handle value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const Handle* pointer;
+		typedef const Handle& reference;
+
+		iterator(void) : _cur(nullptr), _n(0), _i(0) {}
+		iterator(HandleCursor* cur, size_t n) : _cur(cur), _n(n), _i(0)
+			{ fill(); }
+
+		reference operator*() const { return _buf[_i]; }
+		pointer operator->() const { return &_buf[_i]; }
+		iterator& operator++()
+		{
+			if (++_i == _buf.size()) fill();
+			return *this;
+		}
+		bool operator==(const iterator& other) const
+			{ return _cur == other._cur and
+			         (nullptr == _cur or _i == other._i); }
+		bool operator!=(const iterator& other) const
+			{ return not operator==(other); }
+	};
+
+	/// Walk the remainder of the cursor, `n` Handles at a time.
+	iterator begin(size_t n = DEFAULT_CHUNK) { return iterator(this, n); }
+	iterator end(void) { return iterator(); }
+};
+
+typedef std::shared_ptr<HandleCursor> HandleCursorPtr;
+
+/**
+ * Cursor over the atoms of a given type, as seen from a given
+ * AtomSpace. Reports the same atoms as foreach_handle_by_type()
+ * does: for copy-on-write spaces, only the shallowest version of
+ * each atom, and none of the hidden ones.
+ */
+class TypeCursor : public HandleCursor
+{
+	AtomSpacePtr _top;
+	std::vector<AtomSpacePtr> _spaces;
+	std::vector<Type> _types;
+	size_t _ispace;
+	size_t _itype;
+	bool _started;
+	TypeIndex::Resume _where;
+
+public:
+	TypeCursor(const AtomSpace*, Type, bool subclass, bool parent);
+	virtual size_t next(HandleSeq&, size_t n = DEFAULT_CHUNK);
+};
+
+/**
+ * Cursor over the incoming set of an atom, as seen from a given
+ * AtomSpace; the same Links that Atom::getIncomingSet() reports.
+ *
+ * The incoming set is copied as weak pointers when the cursor is
+ * made; Handles are made only as the chunks are read, and Links that
+ * are gone by then are skipped. The exception is copy-on-write
+ * spaces: there, the Links are gathered up front, because the copies
+ * held in the different frames have to be deduplicated.
+ */
+class IncomingCursor : public HandleCursor
+{
+	Handle _atom;
+	AtomSpacePtr _as;
+	std::vector<WinkPtr> _winks;
+	HandleSeq _links;
+	size_t _next;
+
+public:
+	IncomingCursor(const Handle&, const AtomSpace*, Type = NOTYPE);
+	virtual size_t next(HandleSeq&, size_t n = DEFAULT_CHUNK);
+};
+
+/** @}*/
+} // namespace opencog
+
+#endif // _OPENCOG_HANDLE_CURSOR_H
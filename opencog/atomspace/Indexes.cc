@@ -0,0 +1,186 @@
+/*
+ * opencog/atomspace/Indexes.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "AtomSpace.h"
+
+// Secondary indexes on the AtomSpace. The index classes themselves
+// are in AtomIndex.cc; this file holds the AtomSpace side: declaring
+// indexes, keeping them current, and looking things up in them.
+
+using namespace opencog;
+
+#define SHARED_LOCK std::shared_lock<std::shared_mutex> lck(_idx_mtx)
+#define UNIQUE_LOCK std::unique_lock<std::shared_mutex> lck(_idx_mtx)
+
+void AtomSpace::update_indexes(const Handle& h, bool insert)
+{
+    SHARED_LOCK;
+    if (insert)
+        for (const AtomIndexPtr& idx : _indexes) idx->insert(h);
+    else
+        for (const AtomIndexPtr& idx : _indexes) idx->remove(h);
+}
+
+/// Publish the index first, and then fill it. Atoms added while it is
+/// being filled are inserted twice, which is harmless.
+void AtomSpace::add_index(const AtomIndexPtr& idx)
+{
+    {
+        UNIQUE_LOCK;
+        _indexes.push_back(idx);
+        _indexed.store(true, std::memory_order_relaxed);
+    }
+
+    HandleSeq hs;
+    get_atoms_in_frame(hs);
+    for (const Handle& h : hs)
+        if (not h->isAbsent()) idx->insert(h);
+}
+
+void AtomSpace::add_name_index(Type t, bool subclass)
+{
+    AtomIndexPtr idx(std::make_shared<NameIndex>(t, subclass));
+    {
+        SHARED_LOCK;
+        for (const AtomIndexPtr& have : _indexes)
+        {
+            if (AtomIndex::NAME != have->get_kind()) continue;
+            NameIndex* ni = static_cast<NameIndex*>(have.get());
+            if (ni->get_type() == t and ni->get_subclass() == subclass)
+                return;
+        }
+    }
+    add_index(idx);
+}
+
+void AtomSpace::add_key_index(const Handle& key)
+{
+    AtomIndexPtr idx(std::make_shared<KeyIndex>(key));
+    {
+        SHARED_LOCK;
+        for (const AtomIndexPtr& have : _indexes)
+        {
+            if (AtomIndex::KEY != have->get_kind()) continue;
+            if (*static_cast<KeyIndex*>(have.get())->get_key() == *key)
+                return;
+        }
+    }
+    add_index(idx);
+}
+
+void AtomSpace::add_position_index(Type t, size_t pos)
+{
+    if (get_position_index(t, pos)) return;
+    add_index(std::make_shared<PositionIndex>(t, pos));
+}
+
+void AtomSpace::drop_indexes(void)
+{
+    UNIQUE_LOCK;
+    _indexed.store(false, std::memory_order_relaxed);
+    _indexes.clear();
+}
+
+// ====================================================================
+
+void AtomSpace::get_handles_by_name_prefix(HandleSeq& hseq, Type t,
+                                           const std::string& prefix,
+                                           bool subclass) const
+{
+    {
+        // Any index covering every type asked for will do.
+        SHARED_LOCK;
+        for (const AtomIndexPtr& idx : _indexes)
+        {
+            if (AtomIndex::NAME != idx->get_kind()) continue;
+            NameIndex* ni = static_cast<NameIndex*>(idx.get());
+            if (not ni->covers(t)) continue;
+            if (subclass and not ni->get_subclass()) continue;
+            ni->get_by_prefix(hseq, t, prefix, subclass);
+            return;
+        }
+    }
+
+    HandleSeq all;
+    typeIndex.get_handles_by_type(all, t, subclass);
+    for (const Handle& h : all)
+        if (h->is_node() and not h->isAbsent() and
+            0 == h->get_name().compare(0, prefix.size(), prefix))
+            hseq.push_back(h);
+}
+
+void AtomSpace::get_handles_by_key(HandleSeq& hseq, const Handle& key) const
+{
+    {
+        SHARED_LOCK;
+        for (const AtomIndexPtr& idx : _indexes)
+        {
+            if (AtomIndex::KEY != idx->get_kind()) continue;
+            KeyIndex* ki = static_cast<KeyIndex*>(idx.get());
+            if (*ki->get_key() != *key) continue;
+            ki->get_atoms(hseq);
+            return;
+        }
+    }
+
+    HandleSeq all;
+    get_atoms_in_frame(all);
+    for (const Handle& h : all)
+        if (not h->isAbsent() and h->getValue(key))
+            hseq.push_back(h);
+}
+
+void AtomSpace::get_links_by_position(HandleSeq& hseq, Type t, size_t pos,
+                                      const Handle& h) const
+{
+    std::shared_ptr<const PositionIndex> pi(get_position_index(t, pos));
+    if (pi)
+    {
+        pi->get_links(hseq, h);
+        return;
+    }
+
+    HandleSeq all;
+    typeIndex.get_handles_by_type(all, t, false);
+    for (const Handle& l : all)
+        if (not l->isAbsent() and pos < l->get_arity() and
+            *l->getOutgoingAtom(pos) == *h)
+            hseq.push_back(l);
+}
+
+std::shared_ptr<const PositionIndex>
+AtomSpace::get_position_index(Type t, size_t pos) const
+{
+    if (not _indexed.load(std::memory_order_relaxed)) return nullptr;
+
+    SHARED_LOCK;
+    for (const AtomIndexPtr& idx : _indexes)
+    {
+        if (AtomIndex::POSITION != idx->get_kind()) continue;
+        std::shared_ptr<const PositionIndex> pi(
+            std::static_pointer_cast<const PositionIndex>(idx));
+        if (pi->get_type() == t and pi->get_position() == pos)
+            return pi;
+    }
+    return nullptr;
+}
+
+// ======================= END OF FILE =================
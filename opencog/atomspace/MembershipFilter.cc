@@ -0,0 +1,79 @@
+/*
+ * opencog/atomspace/MembershipFilter.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "Epoch.h"
+#include "MembershipFilter.h"
+
+using namespace opencog;
+
+// Smallest filter; 64 bytes, enough for 32 Atoms. Most frames in a
+// deep stack are small.
+static constexpr size_t MIN_WORDS = 8;
+
+MembershipFilter::Table::Table(size_t nwords) :
+	_mask(nwords - 1),
+	_shift(64),
+	_words(new std::atomic<uint64_t>[nwords])
+{
+	for (size_t i = 0; i < nwords; i++)
+		_words[i].store(0, std::memory_order_relaxed);
+	while (nwords > 1) { nwords >>= 1; _shift--; }
+}
+
+void MembershipFilter::free_table(void* t)
+{
+	delete (Table*) t;
+}
+
+MembershipFilter::MembershipFilter(void) :
+	_table(new Table(MIN_WORDS)),
+	_added(0)
+{
+}
+
+MembershipFilter::~MembershipFilter()
+{
+	delete _table.load();
+}
+
+void MembershipFilter::rebuild(const std::vector<ContentHash>& hashes)
+{
+	// Size for twice as many Atoms as there are now, so that the
+	// next rebuild doesn't come too soon.
+	size_t nwords = MIN_WORDS;
+	while (4 * nwords < 2 * hashes.size()) nwords <<= 1;
+
+	Table* nt = new Table(nwords);
+	for (ContentHash hsh : hashes)
+		nt->_words[word(nt, hsh)].fetch_or(bits(hsh), std::memory_order_relaxed);
+
+	Table* old = _table.exchange(nt, std::memory_order_acq_rel);
+	_added.store(hashes.size(), std::memory_order_relaxed);
+	epoch_manager().retire(old, free_table);
+}
+
+size_t MembershipFilter::bytes(void) const
+{
+	const Table* t = _table.load();
+	return sizeof(Table) + (t->_mask + 1) * sizeof(uint64_t);
+}
+
+// ======================= END OF FILE =================
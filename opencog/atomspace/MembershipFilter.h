@@ -0,0 +1,133 @@
+/*
+ * opencog/atomspace/MembershipFilter.h
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_MEMBERSHIP_FILTER_H
+#define _OPENCOG_MEMBERSHIP_FILTER_H
+
+#include <atomic>
+#include <vector>
+
+#include <opencog/atoms/base/Handle.h>
+
+namespace opencog
+{
+/** \addtogroup grp_atomspace
+ *  @{
+ */
+
+/**
+ * Bloom filter over Atom content hashes. It answers the question
+ * "might this AtomSpace hold this Atom?" with either "no", which is
+ * always right, or "maybe". This lets lookups through deep stacks of
+ * frames skip the frames that definitely do not hold the Atom, at the
+ * cost of one memory access per frame.
+ *
+ * The filter is register-blocked: all of the bits for one hash land
+ * in the same 64-bit word. About 16 bits are used per Atom, with four
+ * bits set per Atom, for a false-positive rate of well under 1%.
+ *
+ * Bits are never cleared; removing Atoms from the AtomSpace leaves
+ * stale bits behind, which only cost false positives. The filter is
+ * rebuilt, from scratch, when more Atoms have been added to it than
+ * it was sized for.
+ *
+ * Readers take no locks. They must hold an EpochGuard, or a lock that
+ * excludes `rebuild()`. Writers must hold a lock that excludes
+ * `rebuild()`; the TypeIndex uses its set locks for this.
+ */
+class MembershipFilter
+{
+	struct Table
+	{
+		size_t _mask;
+		int _shift;
+		std::atomic<uint64_t>* _words;
+
+		Table(size_t nwords);
+		~Table() { delete[] _words; }
+		size_t capacity(void) const { return 4 * (_mask + 1); }
+	};
+
+	static inline uint64_t bits(ContentHash hsh)
+	{
+		// The TypeIndex and the AtomSets use the low and high bits
+		// of the hash; scramble it, so that the filter doesn't see
+		// the same patterns.
+		uint64_t x = hsh ^ (hsh >> 29);
+		x *= 0xbf58476d1ce4e5b9ULL;
+		x ^= x >> 32;
+		return (1ULL << (x & 63)) | (1ULL << ((x >> 6) & 63)) |
+		       (1ULL << ((x >> 12) & 63)) | (1ULL << ((x >> 18) & 63));
+	}
+	static inline size_t word(const Table* t, ContentHash hsh)
+	{
+		return (hsh * 0x9e3779b97f4a7c15ULL) >> t->_shift;
+	}
+
+	std::atomic<Table*> _table;
+	std::atomic<size_t> _added;
+
+	static void free_table(void*);
+
+public:
+	MembershipFilter(void);
+	MembershipFilter(const MembershipFilter&) = delete;
+	MembershipFilter& operator=(const MembershipFilter&) = delete;
+	~MembershipFilter();
+
+	/// Record the hash. Caller must hold a lock that excludes rebuild().
+	void insert(ContentHash hsh)
+	{
+		Table* t = _table.load(std::memory_order_relaxed);
+		t->_words[word(t, hsh)].fetch_or(bits(hsh), std::memory_order_release);
+		_added.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/// Return false if the hash was never inserted. Return true if it
+	/// might have been.
+	bool may_contain(ContentHash hsh) const
+	{
+		const Table* t = _table.load(std::memory_order_acquire);
+		uint64_t b = bits(hsh);
+		return b == (t->_words[word(t, hsh)].load(std::memory_order_acquire) & b);
+	}
+
+	/// True, if the false-positive rate has gotten bad enough that
+	/// a rebuild is called for.
+	bool crowded(void) const
+	{
+		return _table.load(std::memory_order_relaxed)->capacity() <
+			_added.load(std::memory_order_relaxed);
+	}
+
+	/// Replace the contents with exactly the given hashes. Caller must
+	/// exclude all writers. Readers may run concurrently; the old table
+	/// is retired to the EpochManager.
+	void rebuild(const std::vector<ContentHash>&);
+
+	/// Bytes used by the filter.
+	size_t bytes(void) const;
+};
+
+/** @}*/
+} // namespace opencog
+
+#endif // _OPENCOG_MEMBERSHIP_FILTER_H
@@ -0,0 +1,160 @@
+/*
+ * opencog/atomspace/MemoryUsage.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <unordered_set>
+
+#include <opencog/atoms/value/FloatValue.h>
+#include <opencog/atoms/value/LinkValue.h>
+#include <opencog/atoms/value/StringValue.h>
+
+#include "AtomSpace.h"
+#include "MemoryUsage.h"
+
+using namespace opencog;
+
+// The control block that make_shared puts in front of every Atom and
+// Value: the use count and the weak count.
+static constexpr size_t CONTROL_BLOCK = 2 * sizeof(long);
+
+static size_t string_bytes(const std::string& s)
+{
+    // Short strings live inside the std::string itself.
+    const char* p = s.data();
+    const char* obj = (const char*) &s;
+    if (obj <= p and p < obj + sizeof(std::string)) return 0;
+    return s.capacity() + 1;
+}
+
+/// Bytes used by a Value. Atoms are not counted; they are counted
+/// where they live. Streaming values are not sampled, since that
+/// might block or have side effects; only the object is counted.
+static size_t value_bytes(const ValuePtr& v)
+{
+    if (nullptr == v or v->is_atom()) return 0;
+
+    // The streams are subtypes of FloatValue and LinkValue; asking
+    // for their value() would sample them.
+    if (v->is_type(FLOAT_VALUE) and not v->is_type(RANDOM_STREAM) and
+        not v->is_type(FORMULA_STREAM))
+    {
+        const FloatValuePtr& fv(FloatValueCast(v));
+        return CONTROL_BLOCK + sizeof(FloatValue) +
+            fv->value().capacity() * sizeof(double);
+    }
+    if (v->is_type(STRING_VALUE))
+    {
+        const StringValuePtr& sv(StringValueCast(v));
+        size_t sz = CONTROL_BLOCK + sizeof(StringValue) +
+            sv->value().capacity() * sizeof(std::string);
+        for (const std::string& s : sv->value())
+            sz += string_bytes(s);
+        return sz;
+    }
+    if (v->is_type(LINK_VALUE) and not v->is_type(STREAM_VALUE))
+    {
+        const LinkValuePtr& lv(LinkValueCast(v));
+        size_t sz = CONTROL_BLOCK + sizeof(LinkValue) +
+            lv->value().capacity() * sizeof(ValuePtr);
+        for (const ValuePtr& vp : lv->value())
+            sz += value_bytes(vp);
+        return sz;
+    }
+
+    // Everything else: at least the size of a simple Value.
+    return CONTROL_BLOCK + sizeof(FloatValue);
+}
+
+/// Bytes used by the Atom object itself.
+static size_t atom_bytes(const Handle& h)
+{
+    if (h->is_type(FRAME))
+        return CONTROL_BLOCK + sizeof(AtomSpace);
+    if (h->is_link())
+        return CONTROL_BLOCK + sizeof(Link) +
+            h->getOutgoingSet().capacity() * sizeof(Handle);
+    if (h->is_node())
+        return CONTROL_BLOCK + sizeof(Node) + string_bytes(h->get_name());
+    return CONTROL_BLOCK + sizeof(Atom);
+}
+
+// ====================================================================
+
+FrameMemory AtomSpace::memory_usage() const
+{
+    // Indexed by type, to keep the per-atom work down to a few adds.
+    std::vector<MemoryCounts> counts(_nameserver.getNumberOfClasses());
+    std::map<Handle, MemoryCounts> by_key;
+
+    typeIndex.foreach_atom(ATOM, true,
+        [&](const Handle& h) -> bool
+    {
+        MemoryCounts& mc(counts[h->get_type()]);
+        mc.atoms++;
+        mc.atom_bytes += atom_bytes(h);
+        mc.incoming_bytes += h->getIncomingSetBytes();
+        size_t kvp_bytes = h->foreachValue(
+            [&](const Handle& key, const ValuePtr& v)
+        {
+            size_t vb = value_bytes(v);
+            mc.value_bytes += vb;
+            MemoryCounts& kc(by_key[key]);
+            kc.atoms++;
+            kc.value_bytes += vb;
+        });
+        mc.value_bytes += kvp_bytes;
+        return false;
+    });
+
+    FrameMemory fm;
+    fm.frame = Atom::get_handle();
+    fm.by_key.swap(by_key);
+    for (Type t = 0; t < counts.size(); t++)
+    {
+        if (0 == counts[t].atoms) continue;
+        counts[t].index_bytes = typeIndex.bytes(t);
+        fm.by_type[t] = counts[t];
+        fm.total += counts[t];
+    }
+
+    // The per-type numbers count only the tables for types that are
+    // in use; the total counts all of them.
+    fm.total.index_bytes = typeIndex.bytes();
+    return fm;
+}
+
+std::vector<FrameMemory> AtomSpace::memory_usage_by_frame() const
+{
+    std::vector<FrameMemory> frames;
+    std::unordered_set<const AtomSpace*> seen({this});
+    std::vector<const AtomSpace*> todo({this});
+
+    // Breadth-first, so that frames come out top to bottom.
+    for (size_t i = 0; i < todo.size(); i++)
+    {
+        frames.emplace_back(todo[i]->memory_usage());
+        for (const AtomSpacePtr& base : todo[i]->_environ)
+            if (seen.insert(base.get()).second)
+                todo.push_back(base.get());
+    }
+    return frames;
+}
+
+// ======================= END OF FILE =================
@@ -0,0 +1,97 @@
+/*
+ * opencog/atomspace/MemoryUsage.h
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_MEMORY_USAGE_H
+#define _OPENCOG_MEMORY_USAGE_H
+
+#include <map>
+
+#include <opencog/atoms/base/Handle.h>
+
+namespace opencog
+{
+/** \addtogroup grp_atomspace
+ *  @{
+ */
+
+/**
+ * Approximate RAM usage of some collection of Atoms. The numbers are
+ * estimates: they are computed from object sizes and container
+ * capacities, and not from the malloc arena, and so they do not
+ * include allocator overhead or fragmentation. They are good enough
+ * for capacity planning, and for spotting which types or keys are
+ * the expensive ones.
+ */
+struct MemoryCounts
+{
+    /// Number of Atoms. In the per-key breakdown, this is the number
+    /// of Atoms holding a Value on that key.
+    size_t atoms = 0;
+
+    /// The Atom objects themselves: the C++ object, the shared_ptr
+    /// control block, the outgoing set of Links and the names of
+    /// Nodes.
+    size_t atom_bytes = 0;
+
+    /// Incoming sets, beyond what is inline in the Atom.
+    size_t incoming_bytes = 0;
+
+    /// Key-Value maps, plus the Values in them. Values that are
+    /// shared by several Atoms are counted once per Atom.
+    size_t value_bytes = 0;
+
+    /// Hash tables of the TypeIndex.
+    size_t index_bytes = 0;
+
+    size_t total(void) const
+    {
+        return atom_bytes + incoming_bytes + value_bytes + index_bytes;
+    }
+
+    MemoryCounts& operator+=(const MemoryCounts& other)
+    {
+        atoms += other.atoms;
+        atom_bytes += other.atom_bytes;
+        incoming_bytes += other.incoming_bytes;
+        value_bytes += other.value_bytes;
+        index_bytes += other.index_bytes;
+        return *this;
+    }
+};
+
+/**
+ * Memory used by one AtomSpace frame, not counting the frames under
+ * it. Only types and keys that are actually in use are listed. The
+ * `total` includes the index overhead for all types, including the
+ * empty hash tables that every AtomSpace reserves for each type.
+ */
+struct FrameMemory
+{
+    Handle frame;
+    std::map<Type, MemoryCounts> by_type;
+    std::map<Handle, MemoryCounts> by_key;
+    MemoryCounts total;
+};
+
+/** @}*/
+} //namespace opencog
+
+#endif // _OPENCOG_MEMORY_USAGE_H
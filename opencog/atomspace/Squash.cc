@@ -0,0 +1,186 @@
+/*
+ * opencog/atomspace/Squash.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <functional>
+#include <unordered_set>
+
+#include <opencog/atoms/atom_types/NameServer.h>
+#include <opencog/util/exceptions.h>
+#include <opencog/util/oc_assert.h>
+
+#include "AtomSpace.h"
+
+using namespace opencog;
+
+// ====================================================================
+
+/// Return the frames from just below this one, down to and including
+/// `bottom`, in top-down order. Throws if `bottom` is not reachable
+/// along a chain of single-inheritance frames.
+std::vector<AtomSpacePtr> AtomSpace::squash_range(const AtomSpace* bottom) const
+{
+    std::vector<AtomSpacePtr> range;
+    const AtomSpace* as = this;
+    while (as != bottom)
+    {
+        if (1 != as->_environ.size())
+            throw RuntimeException(TRACE_INFO,
+                "AtomSpace::squash() - %s is not above %s in a single chain!",
+                _name.c_str(), bottom->_name.c_str());
+        range.push_back(as->_environ[0]);
+        as = as->_environ[0].get();
+    }
+    return range;
+}
+
+/// Collapse all of the frames below this one, down to and including
+/// `bottom`, into this frame. See the header file for the description.
+void AtomSpace::squash(const AtomSpacePtr& bottom)
+{
+    if (nullptr == bottom or this == bottom.get()) return;
+    if (_read_only)
+        throw RuntimeException(TRACE_INFO, "Read-only AtomSpace!");
+
+    std::vector<AtomSpacePtr> range(squash_range(bottom.get()));
+    std::unordered_set<const AtomSpace*> in_range;
+    for (const AtomSpacePtr& as : range) in_range.insert(as.get());
+
+    // Pick out the shallowest version of each atom in the range. The
+    // frames are visited top-down, so the first version seen is the
+    // one that is visible from here. Atoms already in this frame
+    // cover all of the deeper versions, and stay as they are.
+    // Absent markers are picked out just like any other atom; they
+    // might be covering something even deeper.
+    UnorderedHandleSet chosen;
+    for (const AtomSpacePtr& as : range)
+    {
+        HandleSeq hs;
+        as->get_atoms_in_frame(hs);
+        for (const Handle& h : hs)
+        {
+            // AtomSpaces cannot be in two places at once; they are
+            // not carried over.
+            if (h->is_type(FRAME)) continue;
+            if (typeIndex.findAtom(h)) continue;
+            chosen.insert(h);
+        }
+    }
+
+    // Copy the chosen atoms into this frame. Outgoing sets are copied
+    // first, so that each link points at the merged versions of the
+    // atoms under it; atoms below the range are used as they are.
+    // The originals are not touched: other frames built on top of
+    // the range, and Handles held by the user, remain valid.
+    std::function<Handle(const Handle&)> resolve;
+    auto copy_in = [&](const Handle& orig) -> Handle
+    {
+        Handle atom;
+        if (orig->is_link())
+        {
+            HandleSeq oset;
+            oset.reserve(orig->get_arity());
+            for (const Handle& ho : orig->getOutgoingSet())
+                oset.emplace_back(resolve(ho));
+            atom = createLink(std::move(oset), orig->get_type());
+        }
+        else
+        {
+            std::string name(orig->get_name());
+            atom = createNode(orig->get_type(), std::move(name));
+        }
+
+        // The shallowest version holds every value that is visible
+        // from here; the copy-on-write copied them up when it was
+        // created. So these are exactly the right values.
+        atom->copyValues(orig);
+        if (orig->isAbsent()) atom->setAbsent();
+
+        atom->setAtomSpace(this);
+        atom->keep_incoming_set();
+        atom->install();
+        typeIndex.insertAtom(atom);
+        if (not atom->isAbsent()) index_insert(atom);
+        return atom;
+    };
+    resolve = [&](const Handle& h) -> Handle
+    {
+        Handle have(typeIndex.findAtom(h));
+        if (have) return have;
+
+        auto it = chosen.find(h);
+        if (chosen.end() == it) return h;
+        return copy_in(*it);
+    };
+    for (const Handle& h : chosen)
+        resolve(h);
+
+    // Links that were already in this frame may point into the range.
+    // Re-point them at the merged versions. The contents don't change,
+    // so neither does the hash, nor the placement in the TypeIndex,
+    // and the user's Handles to these links remain good.
+    HandleSeq mine;
+    get_atoms_in_frame(mine);
+    for (const Handle& h : mine)
+    {
+        if (not h->is_link()) continue;
+        LinkPtr l(LinkCast(h));
+        for (Handle& ho : l->_outgoing)
+        {
+            if (0 == in_range.count(ho->getAtomSpace())) continue;
+            Handle merged(typeIndex.findAtom(ho));
+            OC_ASSERT(nullptr != merged, "Internal Error!");
+            ho->remove_atom(h);
+            merged->insert_atom(h);
+            ho.swap(merged);
+        }
+    }
+
+    // Sit directly on top of whatever was under the range.
+    Handle self(HandleCast(this));
+    for (Handle& h : _outgoing)
+        h->remove_atom(self);
+    _environ = bottom->_environ;
+    _outgoing = bottom->_outgoing;
+    for (Handle& h : _outgoing)
+        h->insert_atom(self);
+
+    // Absent markers that no longer cover anything can go, unless
+    // some link still points at them.
+    for (const Handle& h : chosen)
+    {
+        Handle merged(typeIndex.findAtom(h));
+        if (nullptr == merged or not merged->isAbsent()) continue;
+        if (not merged->isIncomingSetEmpty()) continue;
+
+        bool covers = false;
+        for (const AtomSpacePtr& base : _environ)
+            if (base->lookupHandle(merged)) { covers = true; break; }
+        if (covers) continue;
+
+        merged->markForRemoval();
+        typeIndex.removeAtom(merged);
+        index_remove(merged);
+        merged->remove();
+        merged->drop_incoming_set();
+    }
+}
+
+// ======================= END OF FILE =================
@@ -19,6 +19,9 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
+#include <thread>
+
 #include "TypeIndex.h"
 #include <opencog/atoms/atom_types/NameServer.h>
 
@@ -27,7 +30,8 @@ using namespace opencog;
 TypeIndex::TypeIndex(void) :
 	_reserved(TYPE_RESERVE_SIZE),
 	_nameserver(nameserver()),
-	_idx(VEC_SIZE)
+	_idx(VEC_SIZE),
+	_counts(TYPE_RESERVE_SIZE)
 {
 	_num_types = nameserver().getNumberOfClasses();
 	_offset_to_atom = ATOM;
@@ -44,6 +48,18 @@ TypeIndex::TypeIndex(void) :
 		AtomSet& s(vec[ibu]); \
 		s._mtx.unlock(); }
 
+#if USE_CONCURRENT_TYPESET
+static void free_sets(void* v)
+{
+	delete (std::vector<AtomSet>*) v;
+}
+
+static void free_counts(void* v)
+{
+	delete (std::vector<std::atomic<size_t>>*) v;
+}
+#endif
+
 void TypeIndex::resize(void) const
 {
 	int newsz = nameserver().getNumberOfClasses();
@@ -55,17 +71,44 @@ void TypeIndex::resize(void) const
 		_reserved *= 2;
 
 	std::vector<AtomSet> newvec(_reserved * POOL_SIZE);
+	std::vector<std::atomic<size_t>> newcnt(_reserved);
 	GET_BFL(_idx)
+
+	// Move the atoms, and their counts, into the new vectors. Each
+	// type starts at the same place in both; there is only more room
+	// at the end.
+	for (size_t i = 0; i < _idx.size(); i++)
+		newvec[i].swap(_idx[i]);
+	for (size_t i = 0; i < _counts.size(); i++)
+		newcnt[i].store(_counts[i].load(std::memory_order_relaxed),
+		                std::memory_order_relaxed);
+
 	newvec.swap(_idx);
+	newcnt.swap(_counts);
 	_num_types = newsz;
 	DROP_BFL(newvec)
+
+#if USE_CONCURRENT_TYPESET
+	// Lock-free readers may still be walking the old sets, or reading
+	// the old counts, and writers may be waiting on the old locks.
+	// Moving the vectors leaves their contents where they are.
+	epoch_manager().retire(
+		new std::vector<AtomSet>(std::move(newvec)), free_sets);
+	epoch_manager().retire(
+		new std::vector<std::atomic<size_t>>(std::move(newcnt)), free_counts);
+#endif
 }
 
 void TypeIndex::clear(void)
 {
 	std::vector<AtomSet> dead(_reserved * POOL_SIZE);
+	std::vector<std::atomic<size_t>> zero(_reserved);
 	GET_BFL(_idx)
 	dead.swap(_idx);
+	zero.swap(_counts);
+#if USE_MEMBERSHIP_FILTER
+	_filter.rebuild({});
+#endif
 
 	// Clear the AtomSpace before releasing the lock.
 	for (auto& s : dead)
@@ -89,6 +132,313 @@ void TypeIndex::clear(void)
 			h->remove();
 		s.clear();
 	}
+
+#if USE_CONCURRENT_TYPESET
+	// Lock-free readers may still be walking the dead sets. Wait for
+	// them to finish, before the dead sets are destroyed.
+	epoch_manager().synchronize();
+#endif
+}
+
+// ================================================================
+
+static size_t set_bytes(const AtomSet& s)
+{
+#if USE_CONCURRENT_TYPESET
+	return s.bytes();
+#else
+	// A bucket pointer, plus a chain link and cached hash per atom.
+	return s.bucket_count() * sizeof(void*) +
+		s.size() * (2 * sizeof(void*) + sizeof(Handle));
+#endif
+}
+
+size_t TypeIndex::bytes(Type t) const
+{
+	if (t < _offset_to_atom) return 0;
+	size_t sz = 0;
+	int start = get_bucket_start(t);
+	for (int ibu = start; ibu < start + POOL_SIZE; ibu++)
+	{
+		TYPE_INDEX_SHARED_LOCK(_idx[ibu]);
+		sz += set_bytes(_idx[ibu]);
+	}
+	return sz;
+}
+
+size_t TypeIndex::bytes(void) const
+{
+#if USE_CONCURRENT_TYPESET
+	EpochGuard guard;
+#endif
+	size_t sz = _idx.capacity() * sizeof(AtomSet);
+	for (const AtomSet& s : _idx)
+	{
+		TYPE_INDEX_SHARED_LOCK(s);
+		sz += set_bytes(s);
+	}
+#if USE_MEMBERSHIP_FILTER
+	sz += _filter.bytes();
+#endif
+	return sz;
+}
+
+// ================================================================
+
+void TypeIndex::insertAtoms(const HandleSeq& atoms, HandleSeq& found)
+{
+	size_t sz = atoms.size();
+	found.resize(sz);
+
+	// Sort by set. The index is the tie-breaker, so that atoms land
+	// in the same order that they would have, one at a time.
+	std::vector<std::pair<int, size_t>> order;
+	order.reserve(sz);
+	for (size_t i = 0; i < sz; i++)
+		order.emplace_back(get_bucket(atoms[i]), i);
+	std::sort(order.begin(), order.end());
+
+	TYPE_INDEX_WRITE_GUARD
+	size_t j = 0;
+	while (j < sz)
+	{
+		int ibu = order[j].first;
+		AtomSet& s(lock_set(ibu));
+		std::lock_guard<decltype(s._mtx)> lck(s._mtx, std::adopt_lock);
+		for (; j < sz and order[j].first == ibu; j++)
+		{
+			size_t i = order[j].second;
+#if USE_CONCURRENT_TYPESET
+			found[i] = s.insert(atoms[i]);
+			if (found[i]) continue;
+#else
+			auto iter = s.find(atoms[i]);
+			if (s.end() != iter) { found[i] = *iter; continue; }
+			s.insert(atoms[i]);
+			found[i] = Handle::UNDEFINED;
+#endif
+#if USE_MEMBERSHIP_FILTER
+			_filter.insert(atoms[i]->get_hash());
+#endif
+			type_count(atoms[i]->get_type())
+				.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+#if USE_MEMBERSHIP_FILTER
+	if (_filter.crowded()) rebuild_filter();
+#endif
+}
+
+/// Same as removeAtom(), for many atoms at once. The atoms are
+/// grouped by set, and each set is locked only once. Very large
+/// batches are split up among several threads, each taking its own
+/// sets, so that the threads do not contend with one-another. The
+/// threads are started for each call, so each must have plenty to
+/// do; most batches are done in this thread. On return, `gone[i]`
+/// is non-zero if `atoms[i]` was removed.
+void TypeIndex::removeAtoms(const HandleSeq& atoms, std::vector<char>& gone)
+{
+	// Atoms per thread, at the least.
+	static constexpr size_t CHUNK = 65536;
+	size_t sz = atoms.size();
+	gone.assign(sz, 0);
+
+	std::vector<std::pair<int, size_t>> order;
+	order.reserve(sz);
+	for (size_t i = 0; i < sz; i++)
+		order.emplace_back(get_bucket(atoms[i]), i);
+	std::sort(order.begin(), order.end());
+
+	// Remove the atoms in order[begin..end), which must not split
+	// any set between two threads.
+	auto remove_range = [&](size_t begin, size_t end)
+	{
+		TYPE_INDEX_WRITE_GUARD
+		size_t j = begin;
+		while (j < end)
+		{
+			int ibu = order[j].first;
+			AtomSet& s(lock_set(ibu));
+#if USE_CONCURRENT_TYPESET
+			HandleSeq retired;
+			{
+				std::lock_guard<AtomSetLock> lck(s._mtx, std::adopt_lock);
+				for (; j < end and order[j].first == ibu; j++)
+				{
+					size_t i = order[j].second;
+					Handle was(s.erase(atoms[i]));
+					if (nullptr == was) continue;
+					gone[i] = 1;
+					type_count(atoms[i]->get_type())
+						.fetch_sub(1, std::memory_order_relaxed);
+					retired.emplace_back(std::move(was));
+				}
+			}
+			for (Handle& h : retired)
+				epoch_manager().retire(std::move(h));
+#else
+			std::unique_lock<std::shared_mutex> lck(s._mtx, std::adopt_lock);
+			for (; j < end and order[j].first == ibu; j++)
+			{
+				size_t i = order[j].second;
+				if (0 == s.erase(atoms[i])) continue;
+				gone[i] = 1;
+				type_count(atoms[i]->get_type())
+					.fetch_sub(1, std::memory_order_relaxed);
+			}
+#endif
+		}
+	};
+
+	size_t nthr = std::min<size_t>(std::thread::hardware_concurrency(),
+	                               sz / CHUNK);
+	if (nthr < 2)
+	{
+		remove_range(0, sz);
+		return;
+	}
+
+	// Cut at set boundaries.
+	std::vector<size_t> cuts({0});
+	for (size_t t = 1; t < nthr; t++)
+	{
+		size_t c = std::max(cuts.back(), sz * t / nthr);
+		while (0 < c and c < sz and order[c].first == order[c-1].first) c++;
+		cuts.push_back(c);
+	}
+	cuts.push_back(sz);
+
+	std::vector<std::thread> pool;
+	for (size_t t = 0; t < nthr; t++)
+		pool.push_back(std::thread(remove_range, cuts[t], cuts[t+1]));
+	for (std::thread& th : pool) th.join();
+}
+
+#if USE_MEMBERSHIP_FILTER
+/// Rebuild the membership filter from scratch, dropping the bits left
+/// behind by removed atoms, and making room for more. All of the set
+/// locks are held, so that no atoms are added while this is running.
+/// If some other thread is already rebuilding, don't bother.
+void TypeIndex::rebuild_filter(void)
+{
+	std::unique_lock<std::mutex> only(_rebuild_mtx, std::try_to_lock);
+	if (not only.owns_lock()) return;
+
+	GET_BFL(_idx)
+	if (_filter.crowded())
+	{
+		std::vector<ContentHash> hashes;
+		for (const AtomSet& s : _idx)
+			for (const Handle& h : s)
+				hashes.push_back(h->get_hash());
+		_filter.rebuild(hashes);
+	}
+	DROP_BFL(_idx)
+}
+#endif
+
+// ================================================================
+
+bool TypeIndex::foreach_of_type(Type t,
+                      const std::function<bool(const Handle&)>& cb) const
+{
+	int start = get_bucket_start(t);
+	for (int ibu = start; ibu < start + POOL_SIZE; ibu++)
+	{
+#if USE_CONCURRENT_TYPESET
+		// One guard per set, rather than one for the whole walk, so
+		// that a long scan does not hold up the release of atoms that
+		// are extracted while it runs.
+		EpochGuard guard;
+		for (const Handle& h : _idx[ibu])
+			if (cb(h)) return true;
+#else
+		// The callback might add or remove atoms; it cannot be called
+		// with the lock held. Copy one set at a time.
+		HandleSeq hseq;
+		{
+			TYPE_INDEX_SHARED_LOCK(_idx[ibu]);
+			const AtomSet& s(_idx[ibu]);
+			hseq.assign(s.begin(), s.end());
+		}
+		for (const Handle& h : hseq)
+			if (cb(h)) return true;
+#endif
+	}
+	return false;
+}
+
+bool TypeIndex::foreach_atom(Type type, bool subclass,
+                      const std::function<bool(const Handle&)>& cb) const
+{
+	return foreach_type(type, subclass,
+		[&](Type t) { return foreach_of_type(t, cb); });
+}
+
+bool TypeIndex::next_of_type(Type t, Resume& where, size_t n,
+                             HandleSeq& out) const
+{
+	int start = get_bucket_start(t);
+	while (where._bucket < POOL_SIZE)
+	{
+#if USE_CONCURRENT_TYPESET
+		EpochGuard guard;
+		const AtomSet& s(_idx[start + where._bucket]);
+		bool more = true;
+		while (0 < n and more)
+		{
+			size_t base = out.size();
+			bool moved = false;
+			more = s.resume(where._pos, n, out, moved);
+
+			// The set was resized; the walk of it started over.
+			// Skip the atoms that were already reported.
+			if (moved)
+			{
+				std::sort(where._done.begin(), where._done.end());
+				where._sorted = where._done.size();
+			}
+			auto sorted_end = where._done.begin() + where._sorted;
+			size_t j = base;
+			for (size_t i = base; i < out.size(); i++)
+			{
+				const Atom* a = out[i].const_atom_ptr();
+				if (0 < where._sorted and
+				    std::binary_search(where._done.begin(), sorted_end, a))
+					continue;
+				if (i != j) out[j] = out[i];
+				j++;
+			}
+			out.resize(j);
+			for (size_t i = base; i < j; i++)
+				where._done.push_back(out[i].const_atom_ptr());
+			n -= j - base;
+		}
+		if (more) return true;
+
+		where._pos = ConcurrentAtomSet::Position();
+		where._done.clear();
+		where._sorted = 0;
+#else
+		// The set cannot be walked without holding its lock; copy
+		// it, one set at a time.
+		const AtomSet& s(_idx[start + where._bucket]);
+		if (where._copy.empty())
+		{
+			TYPE_INDEX_SHARED_LOCK(s);
+			where._copy.assign(s.begin(), s.end());
+		}
+		for (; 0 < n and where._next < where._copy.size(); n--)
+			out.push_back(where._copy[where._next++]);
+		if (where._next < where._copy.size()) return true;
+
+		where._copy.clear();
+		where._next = 0;
+#endif
+		where._bucket++;
+	}
+	return false;
 }
 
 // ================================================================
@@ -110,35 +460,18 @@ void TypeIndex::get_handles_by_type(HandleSeq& hseq,
 	// allocations and copies whenever the allocated size is exceeded.
 	hseq.reserve(initial_size + size_of_append);
 
-	if (type >= _offset_to_atom)
+	foreach_type(type, subclass, [&](Type t)
 	{
-		int start = get_bucket_start(type);
-		for (int ibu = start; ibu < start + POOL_SIZE; ibu++)
-		{
-			const AtomSet& s(_idx[ibu]);
-			TYPE_INDEX_SHARED_LOCK(s);
-			for (const Handle& h : s)
-				hseq.push_back(h);
-		}
-	}
-
-	// Not subclassing? We are done!
-	if (not subclass) return;
-
-	Type tstar = std::max(type+1, _offset_to_atom);
-	for (Type t = tstar; t<_num_types; t++)
-	{
-		if (not _nameserver.isA(t, type)) continue;
-
 		int start = get_bucket_start(t);
 		for (int ibu = start; ibu < start + POOL_SIZE; ibu++)
 		{
+			TYPE_INDEX_SHARED_LOCK(_idx[ibu]);
 			const AtomSet& s(_idx[ibu]);
-			TYPE_INDEX_SHARED_LOCK(s);
 			for (const Handle& h : s)
 				hseq.push_back(h);
 		}
-	}
+		return false;
+	});
 }
 
 // Same as above, except using an unordered set.
@@ -146,35 +479,17 @@ void TypeIndex::get_handles_by_type(UnorderedHandleSet& hset,
                                     Type type,
                                     bool subclass) const
 {
-	if (not subclass and type < _offset_to_atom) return;
-
-	if (type >= _offset_to_atom)
+	foreach_type(type, subclass, [&](Type t)
 	{
-		int start = get_bucket_start(type);
-		for (int ibu = start; ibu < start + POOL_SIZE; ibu++)
-		{
-			const AtomSet& s(_idx[ibu]);
-			TYPE_INDEX_SHARED_LOCK(s);
-			hset.insert(s.begin(), s.end());
-		}
-	}
-
-	// Not subclassing? We are done!
-	if (not subclass) return;
-
-	Type tstar = std::max(type+1, _offset_to_atom);
-	for (Type t = tstar; t<_num_types; t++)
-	{
-		if (not _nameserver.isA(t, type)) continue;
-
 		int start = get_bucket_start(t);
 		for (int ibu = start; ibu < start + POOL_SIZE; ibu++)
 		{
+			TYPE_INDEX_SHARED_LOCK(_idx[ibu]);
 			const AtomSet& s(_idx[ibu]);
-			TYPE_INDEX_SHARED_LOCK(s);
 			hset.insert(s.begin(), s.end());
 		}
-	}
+		return false;
+	});
 }
 
 // ================================================================
@@ -197,39 +512,19 @@ void TypeIndex::get_rootset_by_type(HandleSeq& hseq,
 	// allocations and copies whenever the allocated size is exceeded.
 	hseq.reserve(initial_size + size_of_append);
 
-	if (type >= _offset_to_atom)
+	foreach_type(type, subclass, [&](Type t)
 	{
-		int start = get_bucket_start(type);
-		for (int ibu = start; ibu < start + POOL_SIZE; ibu++)
-		{
-			const AtomSet& s(_idx[ibu]);
-			TYPE_INDEX_SHARED_LOCK(s);
-			for (const Handle& h : s)
-			{
-				if (h->isIncomingSetEmpty(cas))
-					hseq.push_back(h);
-			}
-		}
-	}
-
-	// Not subclassing? We are done!
-	if (not subclass) return;
-
-	Type tstar = std::max(type+1, _offset_to_atom);
-	for (Type t = tstar; t<_num_types; t++)
-	{
-		if (not _nameserver.isA(t, type)) continue;
-
 		int start = get_bucket_start(t);
 		for (int ibu = start; ibu < start + POOL_SIZE; ibu++)
 		{
+			TYPE_INDEX_SHARED_LOCK(_idx[ibu]);
 			const AtomSet& s(_idx[ibu]);
-			TYPE_INDEX_SHARED_LOCK(s);
 			for (const Handle& h : s)
 				if (h->isIncomingSetEmpty(cas))
 					hseq.push_back(h);
 		}
-	}
+		return false;
+	});
 }
 
 // ================================================================
@@ -22,6 +22,8 @@
 #ifndef _OPENCOG_TYPEINDEX_H
 #define _OPENCOG_TYPEINDEX_H
 
+#include <atomic>
+#include <functional>
 #include <mutex>
 #include <set>
 #include <vector>
@@ -37,7 +39,11 @@
 #include <opencog/util/oc_assert.h>
 #include <opencog/atoms/base/Atom.h>
 #include <opencog/atoms/base/Handle.h>
+#include <opencog/atoms/base/Link.h>
+#include <opencog/atoms/base/Node.h>
 #include <opencog/atoms/atom_types/types.h>
+#include <opencog/atomspace/ConcurrentAtomSet.h>
+#include <opencog/atomspace/MembershipFilter.h>
 
 namespace opencog
 {
@@ -76,6 +82,27 @@ namespace opencog
 	typedef google::sparse_hash_set<Handle> AtomHanSet;
 #endif
 
+// Lock-free concurrent hash set. Lookups and iteration take no locks
+// at all; they are protected by an EpochGuard instead. Inserts and
+// removals take a one-byte spinlock on the affected set, so there
+// are more sets per type, to spread out contention. Removed Atoms
+// are retired to the EpochManager, and so it is safe to iterate
+// over the index while other threads are adding and removing Atoms.
+// To get the old, reader-writer-locked std::unordered_set, comment
+// out the line below.
+#define USE_CONCURRENT_TYPESET 1
+
+#if USE_CONCURRENT_TYPESET
+	typedef ConcurrentAtomSet AtomSet;
+
+// The sets move to a new vector when the index is resized, and the
+// old vector is retired to the EpochManager. So readers must take the
+// guard before they pick a set out of the vector, not after.
+#define TYPE_INDEX_SHARED_LOCK(s) EpochGuard lck;
+#define TYPE_INDEX_WRITE_GUARD EpochGuard guard;
+
+#else // USE_CONCURRENT_TYPESET
+
 #if not (USE_SPARSE_TYPESET || USE_FOLLY)
 	typedef std::unordered_set<Handle> AtomHanSet;
 #endif
@@ -95,7 +122,17 @@ struct AtomSet : AtomHanSet
 };
 
 #define TYPE_INDEX_SHARED_LOCK(s) std::shared_lock<std::shared_mutex> lck(s._mtx);
-#define TYPE_INDEX_UNIQUE_LOCK(s) std::unique_lock<std::shared_mutex> lck(s._mtx);
+#define TYPE_INDEX_WRITE_GUARD
+
+#endif // USE_CONCURRENT_TYPESET
+
+// Keep a Bloom filter of the content hashes of all Atoms in the index.
+// Lookups through deep stacks of frames (thousands of them, for some
+// workloads) then skip most of the frames that don't hold the Atom,
+// without touching their hash tables. This costs about 2 bytes per
+// Atom, plus an occasional rebuild of the filter, with all of the
+// set locks held. Comment out the line below to disable.
+#define USE_MEMBERSHIP_FILTER 1
 
 /**
  * Implements a vector of AtomSets; each AtomSet is a hash table of
@@ -107,9 +144,16 @@ struct AtomSet : AtomHanSet
  * too much to try to copy into some temporary array.  Iterating is much
  * faster.
  *
- * @todo The iterator is NOT thread-safe against the insertion or
- * removal of atoms!  Either inserting or removing an atom will cause
- * the iterator references to be freed, leading to mystery crashes!
+ * With USE_CONCURRENT_TYPESET, the iterators are safe against the
+ * concurrent insertion and removal of atoms, provided that an
+ * EpochGuard is held for the lifetime of the iterator. The
+ * `foreach_atom()` method does this automatically, and is the
+ * preferred way of walking the index without copying it.
+ *
+ * @todo Without USE_CONCURRENT_TYPESET, the iterator is NOT thread-safe
+ * against the insertion or removal of atoms!  Either inserting or
+ * removing an atom will cause the iterator references to be freed,
+ * leading to mystery crashes!
  */
 class TypeIndex
 {
@@ -120,8 +164,19 @@ class TypeIndex
 		NameServer& _nameserver;
 		mutable std::vector<AtomSet> _idx;
 
+		// The number of atoms of each type, kept current by every
+		// insert and remove, so that counting them does not have to
+		// visit all POOL_SIZE sets of each type. Iterating over
+		// subtypes also uses this, to skip over the empty types.
+		mutable std::vector<std::atomic<size_t>> _counts;
+
 		static constexpr int TYPE_RESERVE_SIZE = 1024;
+#if USE_CONCURRENT_TYPESET
+		// Writers spin, so more, smaller sets are better.
+		static constexpr int POOL_SIZE = 32;
+#else
 		static constexpr int POOL_SIZE = 8;
+#endif
 		static constexpr int VEC_SIZE = TYPE_RESERVE_SIZE * POOL_SIZE;
 		int get_bucket_start(Type t) const
 		{
@@ -137,14 +192,82 @@ class TypeIndex
 			ibu += POOL_SIZE * (hty - _offset_to_atom);
 			return ibu;
 		}
-		AtomSet& get_atom_set(const Handle& h)
+		// Lock set `ibu` for writing, and return it. A writer that
+		// was waiting on a set while the index was resized finds it
+		// moved, and tries again with the new one. The caller must
+		// hold TYPE_INDEX_WRITE_GUARD, so that the old set is still
+		// there to be unlocked.
+		AtomSet& lock_set(int ibu)
 		{
-			return _idx[get_bucket(h)];
+			while (true)
+			{
+				AtomSet& s(_idx[ibu]);
+				s._mtx.lock();
+				if (&s == &_idx[ibu]) return s;
+				s._mtx.unlock();
+			}
 		}
 		const AtomSet& get_atom_set_const(const Handle& h) const
 		{
 			return _idx[get_bucket(h)];
 		}
+		std::atomic<size_t>& type_count(Type t) const
+		{
+			if (_reserved + _offset_to_atom <= t) resize();
+			return _counts[t - _offset_to_atom];
+		}
+		bool foreach_of_type(Type,
+		                     const std::function<bool(const Handle&)>&) const;
+
+		// Call `fn` on `type`, and, if `subclass`, on each subtype of
+		// it, skipping Value types and types with no atoms, until `fn`
+		// returns true. The subtypes are precomputed by the NameServer,
+		// so there is no need to check every type there is.
+		template<typename Fn>
+		bool foreach_type(Type type, bool subclass, Fn fn) const
+		{
+			if (not subclass)
+				return _offset_to_atom <= type and 0 < size(type) and fn(type);
+
+			for (Type t : _nameserver.getSubtypes(type))
+				if (_offset_to_atom <= t and 0 < size(t) and fn(t))
+					return true;
+			return false;
+		}
+
+#if USE_MEMBERSHIP_FILTER
+		MembershipFilter _filter;
+		std::mutex _rebuild_mtx;
+		void rebuild_filter(void);
+#endif
+
+		Handle insert_one(const Handle& h)
+		{
+			TYPE_INDEX_WRITE_GUARD
+			AtomSet& s(lock_set(get_bucket(h)));
+			std::lock_guard<decltype(s._mtx)> lck(s._mtx, std::adopt_lock);
+#if USE_CONCURRENT_TYPESET
+			Handle found(s.insert(h));
+			if (nullptr != found) return found;
+#if USE_MEMBERSHIP_FILTER
+			// Only atoms that were actually added are counted; else
+			// re-adding would make the filter look crowded. Until
+			// insertAtom() returns, findAtom() may not see the atom.
+			_filter.insert(h->get_hash());
+#endif
+			type_count(h->get_type()).fetch_add(1, std::memory_order_relaxed);
+			return Handle::UNDEFINED;
+#else
+			auto iter = s.find(h);
+			if (s.end() != iter) return *iter;
+#if USE_MEMBERSHIP_FILTER
+			_filter.insert(h->get_hash());
+#endif
+			s.insert(h);
+			type_count(h->get_type()).fetch_add(1, std::memory_order_relaxed);
+			return Handle::UNDEFINED;
+#endif
+		}
 	public:
 		TypeIndex(void);
 		void resize(void) const;
@@ -153,76 +276,190 @@ class TypeIndex
 		// Else, return nullptr
 		Handle insertAtom(const Handle& h)
 		{
-			AtomSet& s(get_atom_set(h));
-			TYPE_INDEX_UNIQUE_LOCK(s);
-			auto iter = s.find(h);
-			if (s.end() != iter) return *iter;
-			s.insert(h);
-			return Handle::UNDEFINED;
+#if USE_MEMBERSHIP_FILTER
+			Handle found(insert_one(h));
+			if (_filter.crowded()) rebuild_filter();
+			return found;
+#else
+			return insert_one(h);
+#endif
 		}
 
+		// Same as insertAtom(), for many atoms at once. The atoms are
+		// grouped by set, and each set is locked only once. On return,
+		// `found[i]` holds the atom that was already in the index, if
+		// any; else it is Handle::UNDEFINED, and `atoms[i]` was added.
+		void insertAtoms(const HandleSeq& atoms, HandleSeq& found);
+
+		// Same as removeAtom(), for many atoms at once. On return,
+		// `gone[i]` is non-zero if `atoms[i]` was removed.
+		void removeAtoms(const HandleSeq& atoms, std::vector<char>& gone);
+
 		bool removeAtom(const Handle& h)
 		{
-			AtomSet& s(get_atom_set(h));
-			TYPE_INDEX_UNIQUE_LOCK(s);
-			return 1 == s.erase(h);
+			TYPE_INDEX_WRITE_GUARD
+			AtomSet& s(lock_set(get_bucket(h)));
+#if USE_CONCURRENT_TYPESET
+			Handle gone;
+			{
+				std::lock_guard<AtomSetLock> lck(s._mtx, std::adopt_lock);
+				gone = s.erase(h);
+				if (nullptr == gone) return false;
+				type_count(h->get_type()).fetch_sub(1, std::memory_order_relaxed);
+			}
+
+			// Some reader might still be looking at it.
+			epoch_manager().retire(std::move(gone));
+			return true;
+#else
+			std::unique_lock<std::shared_mutex> lck(s._mtx, std::adopt_lock);
+			if (0 == s.erase(h)) return false;
+			type_count(h->get_type()).fetch_sub(1, std::memory_order_relaxed);
+			return true;
+#endif
 		}
 
 		Handle findAtom(const Handle& h) const
 		{
+#if USE_CONCURRENT_TYPESET
+			EpochGuard guard;
+#if USE_MEMBERSHIP_FILTER
+			if (not _filter.may_contain(h->get_hash()))
+				return Handle::UNDEFINED;
+#endif
+			return get_atom_set_const(h).find(h);
+#else
 			const AtomSet& s(get_atom_set_const(h));
 			TYPE_INDEX_SHARED_LOCK(s);
+#if USE_MEMBERSHIP_FILTER
+			if (not _filter.may_contain(h->get_hash()))
+				return Handle::UNDEFINED;
+#endif
 			auto iter = s.find(h);
 			if (s.end() == iter) return Handle::UNDEFINED;
 			return *iter;
+#endif
+		}
+
+		// Same as findAtom(), for the Node of type t with the given
+		// name, where `hsh` is what Node::compute_hash() gives for it.
+		Handle findNode(Type t, const char* name, size_t len,
+		                ContentHash hsh) const
+		{
+			if (t < _offset_to_atom) return Handle::UNDEFINED;
+#if USE_CONCURRENT_TYPESET
+			EpochGuard guard;
+#if USE_MEMBERSHIP_FILTER
+			if (not _filter.may_contain(hsh))
+				return Handle::UNDEFINED;
+#endif
+			const AtomSet& s(_idx[get_bucket_start(t) + hsh % POOL_SIZE]);
+			return s.find_node(t, name, len, hsh);
+#else
+			// The std::set needs something to compare against.
+			return findAtom(createNode(t, std::string(name, len)));
+#endif
+		}
+
+		// Same as findAtom(), for the Link of type t with the given
+		// outgoing set, where `hsh` is what Link::compute_hash() gives.
+		Handle findLink(Type t, const Handle* outgoing, size_t arity,
+		                ContentHash hsh) const
+		{
+			if (t < _offset_to_atom) return Handle::UNDEFINED;
+#if USE_CONCURRENT_TYPESET
+			EpochGuard guard;
+#if USE_MEMBERSHIP_FILTER
+			if (not _filter.may_contain(hsh))
+				return Handle::UNDEFINED;
+#endif
+			const AtomSet& s(_idx[get_bucket_start(t) + hsh % POOL_SIZE]);
+			return s.find_link(t, outgoing, arity, hsh);
+#else
+			return findAtom(createLink(
+				HandleSeq(outgoing, outgoing + arity), t));
+#endif
 		}
 
 		// How many atoms are there of type t?
 		size_t size(Type t) const
 		{
 			if (t < _offset_to_atom) return 0;
-			size_t cnt = 0;
-			int start = get_bucket_start(t);
-			for (int ibu = start; ibu < start + POOL_SIZE; ibu++)
-			{
-				const AtomSet& s(_idx[ibu]);
-				TYPE_INDEX_SHARED_LOCK(s);
-				cnt += s.size();
-			}
-			return cnt;
+#if USE_CONCURRENT_TYPESET
+			// The counts move too, when the index is resized.
+			EpochGuard guard;
+#endif
+			return type_count(t).load(std::memory_order_relaxed);
 		}
 
 		// How many atoms, grand total?
 		size_t size(void) const
 		{
+#if USE_CONCURRENT_TYPESET
+			EpochGuard guard;
+#endif
 			size_t cnt = 0;
-			for (const auto& s : _idx)
-			{
-				TYPE_INDEX_SHARED_LOCK(s);
-				cnt += s.size();
-			}
+			for (const auto& c : _counts)
+				cnt += c.load(std::memory_order_relaxed);
 			return cnt;
 		}
 
 		// How many atoms, of type t, and subclasses also?
 		size_t size(Type type, bool subclass) const
 		{
-			size_t result = 0;
-			if (_offset_to_atom <= type)
-				result = size(type);
-			if (not subclass) return result;
+			if (not subclass) return size(type);
 
-			// All subclassed types have a larger type.
-			for (Type t = type+1; t<_num_types; t++)
-			{
-				if (t != type and _nameserver.isA(t, type))
-					result += size(t);
-			}
+			size_t result = 0;
+			for (Type t : _nameserver.getSubtypes(type))
+				result += size(t);
 			return result;
 		}
 
 		void clear(void);
 
+		// Bytes used by the hash tables holding atoms of type t.
+		// Approximate.
+		size_t bytes(Type t) const;
+
+		// Bytes used by the entire index, including the empty sets
+		// reserved for every type, and the membership filter.
+		size_t bytes(void) const;
+
+		// Invoke the callback on each atom of type t (and subtypes,
+		// if subclass is set), until one of them returns true, in
+		// which case the loop stops and returns true. Otherwise,
+		// false is returned. Nothing is copied, and writers are not
+		// blocked; atoms added or removed during the walk may or may
+		// not be seen.
+		bool foreach_atom(Type, bool subclass,
+		                  const std::function<bool(const Handle&)>&) const;
+
+		// Where a cursor left off, in the sets holding one type.
+		struct Resume
+		{
+			int _bucket = 0;
+#if USE_CONCURRENT_TYPESET
+			ConcurrentAtomSet::Position _pos;
+
+			// The atoms already reported from the current set. These
+			// are skipped, if the set is resized under the cursor,
+			// and the walk of that set has to start over.
+			std::vector<const Atom*> _done;
+			size_t _sorted = 0;
+#else
+			HandleSeq _copy;
+			size_t _next = 0;
+#endif
+		};
+
+		// Append up to `n` atoms of type `t` to `out`, resuming where
+		// `where` left off. Return false once all of them have been
+		// appended. Nothing is locked between calls, so writers are
+		// never blocked by a cursor that is not being read; atoms
+		// added or removed between calls may or may not be seen.
+		bool next_of_type(Type t, Resume& where, size_t n,
+		                  HandleSeq& out) const;
+
 		void get_handles_by_type(HandleSeq&, Type, bool subclass) const;
 		void get_handles_by_type(UnorderedHandleSet&, Type, bool subclass) const;
 		void get_rootset_by_type(HandleSeq&, Type, bool subclass,
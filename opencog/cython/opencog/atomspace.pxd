@@ -2,6 +2,7 @@ from libcpp cimport bool
 from libcpp.vector cimport vector
 from libcpp.memory cimport shared_ptr
 from libcpp.set cimport set as cpp_set
+from libcpp.map cimport map as cpp_map
 from libcpp.string cimport string
 from cython.operator cimport dereference as deref
 
@@ -148,6 +149,28 @@ cdef class Atom(Value):
 
 cdef vector[cHandle] atom_list_to_vector(list lst);
 
+# Memory accounting
+cdef extern from "opencog/atomspace/MemoryUsage.h" namespace "opencog":
+    cdef cppclass cMemoryCounts "opencog::MemoryCounts":
+        size_t atoms
+        size_t atom_bytes
+        size_t incoming_bytes
+        size_t value_bytes
+        size_t index_bytes
+
+    cdef cppclass cFrameMemory "opencog::FrameMemory":
+        cHandle frame
+        cpp_map[Type, cMemoryCounts] by_type
+        cpp_map[cHandle, cMemoryCounts] by_key
+        cMemoryCounts total
+
+# HandleCursor
+cdef extern from "opencog/atomspace/HandleCursor.h" namespace "opencog":
+    cdef cppclass cHandleCursor "opencog::HandleCursor":
+        size_t next(vector[cHandle]&, size_t n)
+
+    ctypedef shared_ptr[cHandleCursor] cHandleCursorPtr "opencog::HandleCursorPtr"
+
 # AtomSpace
 cdef extern from "opencog/atomspace/AtomSpace.h" namespace "opencog":
     cdef cppclass cAtomSpace "opencog::AtomSpace":
@@ -172,6 +195,23 @@ cdef extern from "opencog/atomspace/AtomSpace.h" namespace "opencog":
         void clear()
         bint extract_atom(cHandle h, bint recursive)
 
+        # ==== memory accounting ====
+        cFrameMemory memory_usage() except +
+        vector[cFrameMemory] memory_usage_by_frame() except +
+
+        # ==== secondary indexes ====
+        void add_name_index(Type t, bint subclass) except +
+        void add_key_index(cHandle key) except +
+        void add_position_index(Type t, size_t pos) except +
+        void drop_indexes()
+        void get_handles_by_name_prefix(vector[cHandle], Type t, string prefix, bint subclass)
+        void get_handles_by_key(vector[cHandle], cHandle key)
+        void get_links_by_position(vector[cHandle], Type t, size_t pos, cHandle h)
+
+        # ==== cursors ====
+        cHandleCursorPtr cursor_by_type(Type t, bint subclass)
+        cHandleCursorPtr cursor_incoming(cHandle h, Type t)
+
     ctypedef shared_ptr[cAtomSpace] cAtomSpacePtr "opencog::AtomSpacePtr"
 
     cdef cValuePtr createAtomSpace(cAtomSpace *parent)
@@ -25,10 +25,46 @@ cdef convert_handle_seq_to_python_list(vector[cHandle] handles):
         inc(handle_iter)
     return result
 
+# Yield the atoms from the cursor, reading chunk of them at a time.
+def iterate_cursor(AtomSpace space, Type t, bint subtype, Atom atom,
+                   size_t chunk):
+    cdef cHandleCursorPtr cur
+    if atom is None:
+        cur = space.atomspace.cursor_by_type(t, subtype)
+    else:
+        cur = space.atomspace.cursor_incoming(deref(atom.handle), t)
+    cdef vector[cHandle] handle_vector
+    while 0 < deref(cur).next(handle_vector, chunk):
+        for a in convert_handle_seq_to_python_list(handle_vector):
+            yield a
+        handle_vector.clear()
+
 cdef convert_handle_set_to_python_list(cpp_set[cHandle] handles):
     return [create_python_value_from_c_value(<cValuePtr&>(h, h.get())) for h in handles]
 
 
+cdef convert_memory_counts(const cMemoryCounts& mc):
+    return {'atoms': mc.atoms,
+            'atom_bytes': mc.atom_bytes,
+            'incoming_bytes': mc.incoming_bytes,
+            'value_bytes': mc.value_bytes,
+            'index_bytes': mc.index_bytes}
+
+cdef convert_frame_memory(cFrameMemory& fm):
+    types = {}
+    for kv in fm.by_type:
+        types[get_type_name(kv.first)] = convert_memory_counts(kv.second)
+    keys = {}
+    for kv in fm.by_key:
+        key = create_python_value_from_c_value(<cValuePtr&>(kv.first, kv.first.get()))
+        keys[key] = convert_memory_counts(kv.second)
+    return {'frame': create_python_value_from_c_value(
+                <cValuePtr&>(fm.frame, fm.frame.get())),
+            'total': convert_memory_counts(fm.total),
+            'types': types,
+            'keys': keys}
+
+
 cdef vector[cHandle] atom_list_to_vector(list lst):
     cdef vector[cHandle] handle_vector
     for atom in lst:
@@ -210,6 +246,28 @@ cdef class AtomSpace(Value):
             raise RuntimeError("Null AtomSpace!")
         return self.atomspace.get_size()
 
+    def memory_usage(self):
+        """ Return the approximate RAM used by the atoms in this
+        AtomSpace, not counting the AtomSpaces under it, as a dict with
+        the entries 'frame', 'total', 'types' and 'keys'. The 'types'
+        and 'keys' entries break the total down by atom type name and
+        by key. Each count is itself a dict, with the entries 'atoms',
+        'atom_bytes', 'incoming_bytes', 'value_bytes' and 'index_bytes'.
+        """
+        if self.atomspace == NULL:
+            raise RuntimeError("Null AtomSpace!")
+        cdef cFrameMemory fm = self.atomspace.memory_usage()
+        return convert_frame_memory(fm)
+
+    def memory_usage_by_frame(self):
+        """ Same as memory_usage(), for this AtomSpace and each of the
+        AtomSpaces under it. Returns a list, starting with this one.
+        """
+        if self.atomspace == NULL:
+            raise RuntimeError("Null AtomSpace!")
+        cdef vector[cFrameMemory] frames = self.atomspace.memory_usage_by_frame()
+        return [convert_frame_memory(fm) for fm in frames]
+
     # query methods
     def get_atoms_by_type(self, Type t, subtype = True):
         if self.atomspace == NULL:
@@ -219,6 +277,80 @@ cdef class AtomSpace(Value):
         self.atomspace.get_handles_by_type(handle_vector,t,subt)
         return convert_handle_seq_to_python_list(handle_vector)
 
+    def iter_atoms_by_type(self, Type t, subtype = True, size_t chunk = 1024):
+        """ Same as get_atoms_by_type(), but a generator: the atoms
+        are fetched chunk at a time, as they are consumed, instead of
+        all at once. Atoms added or removed while the generator is
+        running may or may not be seen.
+        """
+        if self.atomspace == NULL:
+            raise RuntimeError("Null AtomSpace!")
+        return iterate_cursor(self, t, subtype, None, chunk)
+
+    def iter_incoming(self, Atom atom, Type t = NOTYPE, size_t chunk = 1024):
+        """ Generator over the incoming set of atom, as seen from this
+        AtomSpace; only the links of type t, if it is given. The links
+        are fetched chunk at a time, as they are consumed.
+        """
+        if self.atomspace == NULL:
+            raise RuntimeError("Null AtomSpace!")
+        if atom is None:
+            raise ValueError("No atom provided!")
+        return iterate_cursor(self, t, False, atom, chunk)
+
+    # secondary indexes
+    def add_name_index(self, Type t, subtype = True):
+        """ Keep Nodes of type t (and subtypes) sorted by name, for
+        get_atoms_by_name_prefix(). Like all secondary indexes, this
+        covers only the atoms in this AtomSpace, not those under it.
+        """
+        if self.atomspace == NULL:
+            raise RuntimeError("Null AtomSpace!")
+        self.atomspace.add_name_index(t, subtype)
+
+    def add_key_index(self, Atom key):
+        """ Keep track of the atoms holding a value on key, for
+        get_atoms_by_key(). """
+        if self.atomspace == NULL:
+            raise RuntimeError("Null AtomSpace!")
+        self.atomspace.add_key_index(deref(key.handle))
+
+    def add_position_index(self, Type t, size_t pos):
+        """ Index links of the ordered type t by the atom at position
+        pos of their outgoing set, for get_links_by_position(). The
+        pattern matcher uses these indexes to start searches. """
+        if self.atomspace == NULL:
+            raise RuntimeError("Null AtomSpace!")
+        self.atomspace.add_position_index(t, pos)
+
+    def drop_indexes(self):
+        if self.atomspace == NULL:
+            raise RuntimeError("Null AtomSpace!")
+        self.atomspace.drop_indexes()
+
+    def get_atoms_by_name_prefix(self, Type t, prefix, subtype = True):
+        if self.atomspace == NULL:
+            raise RuntimeError("Null AtomSpace!")
+        cdef vector[cHandle] handle_vector
+        cdef string cprefix = prefix.encode('UTF-8', 'surrogateescape')
+        self.atomspace.get_handles_by_name_prefix(handle_vector, t, cprefix, subtype)
+        return convert_handle_seq_to_python_list(handle_vector)
+
+    def get_atoms_by_key(self, Atom key):
+        if self.atomspace == NULL:
+            raise RuntimeError("Null AtomSpace!")
+        cdef vector[cHandle] handle_vector
+        self.atomspace.get_handles_by_key(handle_vector, deref(key.handle))
+        return convert_handle_seq_to_python_list(handle_vector)
+
+    def get_links_by_position(self, Type t, size_t pos, Atom atom):
+        if self.atomspace == NULL:
+            raise RuntimeError("Null AtomSpace!")
+        cdef vector[cHandle] handle_vector
+        self.atomspace.get_links_by_position(handle_vector, t, pos,
+                                             deref(atom.handle))
+        return convert_handle_seq_to_python_list(handle_vector)
+
     def is_node_in_atomspace(self, Type t, s):
         cdef string name = s.encode('UTF-8', 'surrogateescape')
         result = self.atomspace.xget_handle(t, name)
@@ -155,6 +155,16 @@ SCM SchemeSmob::equalp_misc(SCM a, SCM b)
 			if (al == bl) return SCM_BOOL_T;
 			return SCM_BOOL_F;
 		}
+		case COG_CURSOR:
+		{
+			// Cursors are never copied; compare pointers.
+			HandleCursorPtr* av = (HandleCursorPtr *) SCM_SMOB_DATA(a);
+			HandleCursorPtr* bv = (HandleCursorPtr *) SCM_SMOB_DATA(b);
+			scm_remember_upto_here_1(a);
+			scm_remember_upto_here_1(b);
+			if (av->get() == bv->get()) return SCM_BOOL_T;
+			return SCM_BOOL_F;
+		}
 		case COG_EXTEND:
 		{
 			// We compare pointers here, only.
@@ -380,7 +390,22 @@ void SchemeSmob::register_procs()
 
 	// Taking AtomSpace as optional argument
 	register_proc("cog-count-atoms",       1, 1, 0, C(ss_count));
+	register_proc("cog-memory-usage",      0, 1, 0, C(ss_as_memory_usage));
+	register_proc("cog-memory-usage-by-frame", 0, 1, 0, C(ss_as_memory_usage_by_frame));
+	register_proc("cog-mutex-stats",       0, 1, 0, C(ss_mutex_stats));
 	register_proc("cog-map-type",          2, 1, 0, C(ss_map_type));
+	register_proc("cog-add-name-index!",   1, 1, 0, C(ss_as_add_name_index));
+	register_proc("cog-add-key-index!",    1, 1, 0, C(ss_as_add_key_index));
+	register_proc("cog-add-position-index!", 2, 1, 0, C(ss_as_add_position_index));
+	register_proc("cog-drop-indexes!",     0, 1, 0, C(ss_as_drop_indexes));
+	register_proc("cog-get-atoms-by-prefix", 2, 1, 0, C(ss_as_atoms_by_prefix));
+	register_proc("cog-get-atoms-with-key", 1, 1, 0, C(ss_as_atoms_with_key));
+	register_proc("cog-get-links-at-position", 3, 1, 0, C(ss_as_links_at_position));
+
+	// Cursors
+	register_proc("cog-atoms-cursor",      1, 2, 0, C(ss_cursor_by_type));
+	register_proc("cog-incoming-cursor",   1, 2, 0, C(ss_cursor_incoming));
+	register_proc("cog-cursor-next",       1, 1, 0, C(ss_cursor_next));
 
 	// Value types
 	register_proc("cog-get-types",         0, 0, 0, C(ss_get_types));
@@ -60,7 +60,8 @@ private:
 	enum {
 		COG_PROTOM = 1, // values or atoms - smart pointer
 		COG_LOGGER,     // logger
-		COG_EXTEND      // callbacks into C++ code.
+		COG_EXTEND,     // callbacks into C++ code.
+		COG_CURSOR      // cursor over atoms.
 	};
 
 	static bool server_mode;
@@ -168,12 +169,24 @@ private:
 	static SCM ss_as_env(SCM);
 	static SCM ss_as_uuid(SCM);
 	static SCM ss_as_clear(SCM);
+	static SCM ss_as_memory_usage(SCM);
+	static SCM ss_as_memory_usage_by_frame(SCM);
+	static SCM ss_mutex_stats(SCM);
+	static SCM ss_as_add_name_index(SCM, SCM);
+	static SCM ss_as_add_key_index(SCM, SCM);
+	static SCM ss_as_add_position_index(SCM, SCM, SCM);
+	static SCM ss_as_drop_indexes(SCM);
+	static SCM ss_as_atoms_by_prefix(SCM, SCM, SCM);
+	static SCM ss_as_atoms_with_key(SCM, SCM);
+	static SCM ss_as_links_at_position(SCM, SCM, SCM, SCM);
 	static SCM ss_as_mark_readonly(SCM);
 	static SCM ss_as_mark_readwrite(SCM);
 	static SCM ss_as_readonly_p(SCM);
 	static SCM ss_as_mark_cow(SCM, SCM);
 	static SCM ss_as_cow_p(SCM);
 	static SCM make_as(const AtomSpacePtr&);
+	static SCM frame_memory_to_scm(const FrameMemory&);
+	static SCM handles_to_scm(const HandleSeq&);
 	static const AtomSpacePtr& ss_to_atomspace(SCM);
 
 	// Misc utilities
@@ -194,6 +207,14 @@ private:
 	static Logger* new_logger();
 	static std::mutex lgr_mtx;
 	static std::set<Logger*> deleteable_lgr;
+
+	// Cursors
+	static SCM cursor_to_scm(const HandleCursorPtr&);
+	static HandleCursorPtr ss_to_cursor(SCM);
+	static std::string cursor_to_string(const HandleCursor*);
+	static SCM ss_cursor_by_type(SCM, SCM, SCM);
+	static SCM ss_cursor_incoming(SCM, SCM, SCM);
+	static SCM ss_cursor_next(SCM, SCM);
 	
 	// validate arguments coming from scheme passing into C++
 	[[ noreturn ]] static void throw_exception(const std::exception&,
@@ -225,6 +246,7 @@ private:
 	static double verify_real (SCM, const char *, int pos = 1,
 	                           const char *msg = "real number");
 	static Logger* verify_logger(SCM, const char *, int pos = 1);
+	static HandleCursorPtr verify_cursor(SCM, const char *, int pos = 1);
 
 	static SCM atomspace_fluid;
 	static void ss_set_env_as(const AtomSpacePtr&);
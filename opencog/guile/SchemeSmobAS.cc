@@ -6,6 +6,7 @@
  * Copyright (c) 2008,2009,2014 Linas Vepstas <linas@linas.org>
  */
 
+#include <algorithm>
 #include <cstddef>
 #include <libguile.h>
 
@@ -258,6 +259,270 @@ SCM SchemeSmob::ss_as_clear(SCM sas)
 	return SCM_BOOL_T;
 }
 
+/* ============================================================== */
+/**
+ * Memory usage reports, as association lists.
+ */
+static SCM counts_to_scm(const MemoryCounts& mc)
+{
+	SCM rv = SCM_EOL;
+	rv = scm_acons(scm_from_utf8_symbol("index-bytes"),
+		scm_from_size_t(mc.index_bytes), rv);
+	rv = scm_acons(scm_from_utf8_symbol("value-bytes"),
+		scm_from_size_t(mc.value_bytes), rv);
+	rv = scm_acons(scm_from_utf8_symbol("incoming-bytes"),
+		scm_from_size_t(mc.incoming_bytes), rv);
+	rv = scm_acons(scm_from_utf8_symbol("atom-bytes"),
+		scm_from_size_t(mc.atom_bytes), rv);
+	rv = scm_acons(scm_from_utf8_symbol("atoms"),
+		scm_from_size_t(mc.atoms), rv);
+	return rv;
+}
+
+SCM SchemeSmob::frame_memory_to_scm(const FrameMemory& fm)
+{
+	AtomSpace* as = AtomSpaceCast(fm.frame).get();
+
+	SCM keys = SCM_EOL;
+	for (auto it = fm.by_key.rbegin(); it != fm.by_key.rend(); it++)
+	{
+		// Same as cog-keys->alist: keys that aren't in any AtomSpace
+		// would print as undefined handles.
+		Handle key(it->first);
+		if (nullptr == key->getAtomSpace() and not as->get_read_only())
+			key = as->add_atom(key);
+		keys = scm_acons(handle_to_scm(key), counts_to_scm(it->second), keys);
+	}
+
+	SCM types = SCM_EOL;
+	for (auto it = fm.by_type.rbegin(); it != fm.by_type.rend(); it++)
+	{
+		const std::string& tname = nameserver().getTypeName(it->first);
+		types = scm_acons(scm_from_utf8_symbol(tname.c_str()),
+			counts_to_scm(it->second), types);
+	}
+
+	SCM rv = SCM_EOL;
+	rv = scm_acons(scm_from_utf8_symbol("keys"), keys, rv);
+	rv = scm_acons(scm_from_utf8_symbol("types"), types, rv);
+	rv = scm_acons(scm_from_utf8_symbol("total"), counts_to_scm(fm.total), rv);
+	rv = scm_acons(scm_from_utf8_symbol("frame"),
+		make_as(AtomSpaceCast(fm.frame)), rv);
+	return rv;
+}
+
+/**
+ * Return the memory used by the atomspace, not counting its bases.
+ */
+SCM SchemeSmob::ss_as_memory_usage(SCM sas)
+{
+	const AtomSpacePtr& asg = ss_to_atomspace(sas);
+	const AtomSpacePtr& asp = asg ? asg :
+		ss_get_env_as("cog-memory-usage");
+
+	SCM rv = frame_memory_to_scm(asp->memory_usage());
+	scm_remember_upto_here_1(sas);
+	return rv;
+}
+
+/**
+ * Return a list of memory usage reports, one for the atomspace and
+ * one for each of the frames under it.
+ */
+SCM SchemeSmob::ss_as_memory_usage_by_frame(SCM sas)
+{
+	const AtomSpacePtr& asg = ss_to_atomspace(sas);
+	const AtomSpacePtr& asp = asg ? asg :
+		ss_get_env_as("cog-memory-usage-by-frame");
+
+	std::vector<FrameMemory> frames(asp->memory_usage_by_frame());
+	SCM rv = SCM_EOL;
+	for (size_t i = frames.size(); i > 0; i--)
+		rv = scm_cons(frame_memory_to_scm(frames[i-1]), rv);
+
+	scm_remember_upto_here_1(sas);
+	return rv;
+}
+
+/* ============================================================== */
+/**
+ * Lock statistics for the Atom mutex pools, as association lists.
+ */
+static SCM mutex_stats_to_scm(const MutexStats& ms)
+{
+	SCM rv = SCM_EOL;
+	rv = scm_acons(scm_from_utf8_symbol("wait-ns"),
+		scm_from_uint64(ms.wait_ns), rv);
+	rv = scm_acons(scm_from_utf8_symbol("contended"),
+		scm_from_uint64(ms.contended), rv);
+	rv = scm_acons(scm_from_utf8_symbol("acquired"),
+		scm_from_uint64(ms.acquired), rv);
+	return rv;
+}
+
+static SCM mutex_pool_to_scm(MutexPool& pool, bool reset)
+{
+	// The slots that were waited on the longest, busiest first.
+	static constexpr size_t NBUSY = 8;
+	std::vector<MutexStats> slots(pool.get_stats());
+	std::vector<size_t> busy;
+	for (size_t i = 0; i < slots.size(); i++)
+		if (0 < slots[i].contended) busy.push_back(i);
+	std::sort(busy.begin(), busy.end(), [&](size_t a, size_t b)
+		{ return slots[a].wait_ns > slots[b].wait_ns; });
+	if (NBUSY < busy.size()) busy.resize(NBUSY);
+
+	SCM sbusy = SCM_EOL;
+	for (auto it = busy.rbegin(); it != busy.rend(); it++)
+		sbusy = scm_acons(scm_from_size_t(*it),
+			mutex_stats_to_scm(slots[*it]), sbusy);
+
+	MutexStats total;
+	for (const MutexStats& ms : slots)
+	{
+		total.acquired += ms.acquired;
+		total.contended += ms.contended;
+		total.wait_ns += ms.wait_ns;
+	}
+	if (reset) pool.reset_stats();
+
+	SCM rv = SCM_EOL;
+	rv = scm_acons(scm_from_utf8_symbol("busiest"), sbusy, rv);
+	rv = scm_acons(scm_from_utf8_symbol("total"),
+		mutex_stats_to_scm(total), rv);
+	rv = scm_acons(scm_from_utf8_symbol("slots"),
+		scm_from_size_t(pool.size()), rv);
+	return rv;
+}
+
+/**
+ * Return lock statistics for the Atom mutex pools. If the optional
+ * argument is #t, the counters are zeroed afterwards.
+ */
+SCM SchemeSmob::ss_mutex_stats(SCM sreset)
+{
+	bool reset = not SCM_UNBNDP(sreset) and scm_is_true(sreset);
+
+	SCM rv = SCM_EOL;
+	rv = scm_acons(scm_from_utf8_symbol("incoming"),
+		mutex_pool_to_scm(Atom::incoming_mutex_pool(), reset), rv);
+	rv = scm_acons(scm_from_utf8_symbol("values"),
+		mutex_pool_to_scm(Atom::kvp_mutex_pool(), reset), rv);
+	return rv;
+}
+
+/* ============================================================== */
+/**
+ * Secondary indexes.
+ */
+SCM SchemeSmob::handles_to_scm(const HandleSeq& hs)
+{
+	SCM list = SCM_EOL;
+	for (size_t i = hs.size(); i > 0; i--)
+		list = scm_cons(handle_to_scm(hs[i-1]), list);
+	return list;
+}
+
+SCM SchemeSmob::ss_as_add_name_index(SCM stype, SCM sas)
+{
+	Type t = verify_type(stype, "cog-add-name-index!");
+	const AtomSpacePtr& asg = ss_to_atomspace(sas);
+	const AtomSpacePtr& asp = asg ? asg :
+		ss_get_env_as("cog-add-name-index!");
+	try
+	{
+		asp->add_name_index(t, true);
+	}
+	catch (const std::exception& ex)
+	{
+		throw_exception(ex, "cog-add-name-index!", stype);
+	}
+	scm_remember_upto_here_1(sas);
+	return SCM_BOOL_T;
+}
+
+SCM SchemeSmob::ss_as_add_key_index(SCM skey, SCM sas)
+{
+	Handle key = verify_handle(skey, "cog-add-key-index!");
+	const AtomSpacePtr& asg = ss_to_atomspace(sas);
+	const AtomSpacePtr& asp = asg ? asg :
+		ss_get_env_as("cog-add-key-index!");
+	asp->add_key_index(key);
+	scm_remember_upto_here_1(sas);
+	return SCM_BOOL_T;
+}
+
+SCM SchemeSmob::ss_as_add_position_index(SCM stype, SCM spos, SCM sas)
+{
+	Type t = verify_type(stype, "cog-add-position-index!");
+	size_t pos = verify_size_t(spos, "cog-add-position-index!", 2);
+	const AtomSpacePtr& asg = ss_to_atomspace(sas);
+	const AtomSpacePtr& asp = asg ? asg :
+		ss_get_env_as("cog-add-position-index!");
+	try
+	{
+		asp->add_position_index(t, pos);
+	}
+	catch (const std::exception& ex)
+	{
+		throw_exception(ex, "cog-add-position-index!", stype);
+	}
+	scm_remember_upto_here_1(sas);
+	return SCM_BOOL_T;
+}
+
+SCM SchemeSmob::ss_as_drop_indexes(SCM sas)
+{
+	const AtomSpacePtr& asg = ss_to_atomspace(sas);
+	const AtomSpacePtr& asp = asg ? asg :
+		ss_get_env_as("cog-drop-indexes!");
+	asp->drop_indexes();
+	scm_remember_upto_here_1(sas);
+	return SCM_BOOL_T;
+}
+
+SCM SchemeSmob::ss_as_atoms_by_prefix(SCM stype, SCM sprefix, SCM sas)
+{
+	Type t = verify_type(stype, "cog-get-atoms-by-prefix");
+	std::string prefix = verify_string(sprefix, "cog-get-atoms-by-prefix", 2);
+	const AtomSpacePtr& asg = ss_to_atomspace(sas);
+	const AtomSpacePtr& asp = asg ? asg :
+		ss_get_env_as("cog-get-atoms-by-prefix");
+
+	HandleSeq hs;
+	asp->get_handles_by_name_prefix(hs, t, prefix, true);
+	scm_remember_upto_here_1(sas);
+	return handles_to_scm(hs);
+}
+
+SCM SchemeSmob::ss_as_atoms_with_key(SCM skey, SCM sas)
+{
+	Handle key = verify_handle(skey, "cog-get-atoms-with-key");
+	const AtomSpacePtr& asg = ss_to_atomspace(sas);
+	const AtomSpacePtr& asp = asg ? asg :
+		ss_get_env_as("cog-get-atoms-with-key");
+
+	HandleSeq hs;
+	asp->get_handles_by_key(hs, key);
+	scm_remember_upto_here_1(sas);
+	return handles_to_scm(hs);
+}
+
+SCM SchemeSmob::ss_as_links_at_position(SCM stype, SCM spos, SCM satom, SCM sas)
+{
+	Type t = verify_type(stype, "cog-get-links-at-position");
+	size_t pos = verify_size_t(spos, "cog-get-links-at-position", 2);
+	Handle h = verify_handle(satom, "cog-get-links-at-position", 3);
+	const AtomSpacePtr& asg = ss_to_atomspace(sas);
+	const AtomSpacePtr& asp = asg ? asg :
+		ss_get_env_as("cog-get-links-at-position");
+
+	HandleSeq hs;
+	asp->get_links_by_position(hs, t, pos, h);
+	scm_remember_upto_here_1(sas);
+	return handles_to_scm(hs);
+}
+
 /* ============================================================== */
 /**
  * Return the atomspace of an atom.
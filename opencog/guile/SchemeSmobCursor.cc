@@ -0,0 +1,120 @@
+/*
+ * SchemeSmobCursor.cc
+ *
+ * Scheme small objects (SMOBS) for cursors over atoms.
+ *
+ * Copyright (c) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ */
+
+#include <cstddef>
+#include <libguile.h>
+
+#include <opencog/atomspace/HandleCursor.h>
+#include <opencog/guile/SchemeSmob.h>
+
+using namespace opencog;
+
+/* ============================================================== */
+
+std::string SchemeSmob::cursor_to_string(const HandleCursor *c)
+{
+#define BUFLEN 120
+	char buff[BUFLEN];
+
+	snprintf(buff, BUFLEN, "#<cursor %p>", c);
+	return buff;
+}
+
+SCM SchemeSmob::cursor_to_scm(const HandleCursorPtr& cur)
+{
+	SCM smob;
+	SCM_NEWSMOB (smob, cog_misc_tag, new HandleCursorPtr(cur));
+	SCM_SET_SMOB_FLAGS(smob, COG_CURSOR);
+	return smob;
+}
+
+/* ============================================================== */
+/* Cast SCM to cursor */
+
+HandleCursorPtr SchemeSmob::ss_to_cursor(SCM sc)
+{
+	if (not SCM_SMOB_PREDICATE(SchemeSmob::cog_misc_tag, sc))
+		return nullptr;
+
+	scm_t_bits misctype = SCM_SMOB_FLAGS(sc);
+	if (COG_CURSOR != misctype)
+		return nullptr;
+
+	HandleCursorPtr cur(*((HandleCursorPtr *) SCM_SMOB_DATA(sc)));
+	scm_remember_upto_here_1(sc);
+	return cur;
+}
+
+HandleCursorPtr SchemeSmob::verify_cursor(SCM sc, const char * subrname, int pos)
+{
+	HandleCursorPtr cur(ss_to_cursor(sc));
+	if (nullptr == cur)
+		scm_wrong_type_arg_msg(subrname, pos, sc, "opencog cursor");
+
+	return cur;
+}
+
+/* ============================================================== */
+/**
+ * Return a cursor over all atoms of type stype, and, optionally, its
+ * subtypes. The `aspace` argument is optional; use it if present,
+ * else use the current AtomSpace.
+ */
+SCM SchemeSmob::ss_cursor_by_type (SCM stype, SCM ssub, SCM aspace)
+{
+	Type t = verify_type(stype, "cog-atoms-cursor");
+	bool subclass = not SCM_UNBNDP(ssub) and scm_is_true(ssub);
+
+	const AtomSpacePtr& asg = ss_to_atomspace(aspace);
+	const AtomSpacePtr& asp = asg ? asg :
+		ss_get_env_as("cog-atoms-cursor");
+
+	SCM smob = cursor_to_scm(asp->cursor_by_type(t, subclass));
+	scm_remember_upto_here_1(aspace);
+	return smob;
+}
+
+/**
+ * Return a cursor over the incoming set of satom, optionally, only
+ * the Links of type stype.
+ */
+SCM SchemeSmob::ss_cursor_incoming (SCM satom, SCM stype, SCM aspace)
+{
+	Handle h = verify_handle(satom, "cog-incoming-cursor");
+	Type t = NOTYPE;
+	if (not SCM_UNBNDP(stype) and scm_is_true(stype))
+		t = verify_type(stype, "cog-incoming-cursor", 2);
+
+	const AtomSpacePtr& asg = ss_to_atomspace(aspace);
+	const AtomSpacePtr& asp = asg ? asg :
+		ss_get_env_as("cog-incoming-cursor");
+
+	SCM smob = cursor_to_scm(asp->cursor_incoming(h, t));
+	scm_remember_upto_here_1(aspace);
+	return smob;
+}
+
+/**
+ * Return a list of the next snum atoms from the cursor; fewer, if
+ * there are not that many left. The empty list means that the cursor
+ * is used up.
+ */
+SCM SchemeSmob::ss_cursor_next (SCM scur, SCM snum)
+{
+	HandleCursorPtr cur(verify_cursor(scur, "cog-cursor-next"));
+	size_t n = HandleCursor::DEFAULT_CHUNK;
+	if (not SCM_UNBNDP(snum))
+		n = verify_size_t(snum, "cog-cursor-next", 2);
+
+	HandleSeq chunk;
+	cur->next(chunk, n);
+	scm_remember_upto_here_1(scur);
+	return handles_to_scm(chunk);
+}
+
+/* ===================== END OF FILE ============================ */
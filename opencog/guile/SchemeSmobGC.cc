@@ -39,6 +39,13 @@ size_t SchemeSmob::free_misc(SCM node)
 			scm_remember_upto_here_1(node);
 			return 0;
 
+		case COG_CURSOR:
+			HandleCursorPtr* cur;
+			cur = (HandleCursorPtr *) SCM_SMOB_DATA(node);
+			delete cur;
+			scm_remember_upto_here_1(node);
+			return 0;
+
 		case COG_LOGGER:
 			Logger* lgr;
 			lgr = (Logger*) SCM_SMOB_DATA(node);
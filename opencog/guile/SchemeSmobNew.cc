@@ -514,7 +514,7 @@ SCM SchemeSmob::ss_node (SCM stype, SCM sname, SCM kv_pairs)
 		ss_get_env_as("cog-node");
 
 	// Now, look for the actual node... in the actual atom space.
-	Handle h(asp->get_node(t, std::string(name)));
+	Handle h(asp->get_node(t, name.data(), name.size()));
 	if (nullptr == h) return SCM_EOL;
 
 	scm_remember_upto_here_1(kv_pairs);
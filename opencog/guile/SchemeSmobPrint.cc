@@ -95,6 +95,13 @@ std::string SchemeSmob::misc_to_string(SCM node)
 			scm_remember_upto_here_1(node);
 			return str;
 		}
+		case COG_CURSOR:
+		{
+			HandleCursorPtr* cur = (HandleCursorPtr *) SCM_SMOB_DATA(node);
+			std::string str(cursor_to_string(cur->get()));
+			scm_remember_upto_here_1(node);
+			return str;
+		}
 		case COG_PROTOM:
 			if (server_mode)
 				return protom_to_server_string(node);
@@ -27,11 +27,17 @@ void opencog_exec_init(void);
 
 
 #include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <opencog/atoms/base/Link.h>
 #include <opencog/atomspace/AtomSpace.h>
 #include <opencog/atoms/execution/EvaluationLink.h>
 #include <opencog/atoms/execution/Instantiator.h>
+#include <opencog/atoms/value/LinkValue.h>
 #include <opencog/guile/SchemeModule.h>
+#include <opencog/query/LiveQuery.h>
+#include <opencog/query/QueryProfile.h>
 
 // ========================================================
 
@@ -51,6 +57,67 @@ static ValuePtr ss_execute(AtomSpace* atomspace, const Handle& h)
 	return pap;
 }
 
+/**
+ * cog-execute-profile executes, as above, while recording a profile
+ * of the pattern searches that were run. Returns a LinkValue holding
+ * the result, followed by the profile.
+ */
+static ValuePtr ss_execute_profile(AtomSpace* atomspace, const Handle& h)
+{
+	QueryProfile prof;
+	ValuePtr pap;
+	{
+		QueryProfile::Scope scope(prof);
+		pap = ss_execute(atomspace, h);
+	}
+	if (nullptr == pap) pap = createLinkValue();
+	return createLinkValue(ValueSeq({pap, prof.to_value()}));
+}
+
+// Live queries, by AtomSpace and query. The AtomSpace is held, so
+// that it outlives the subscription.
+struct Live
+{
+	AtomSpacePtr asp;
+	std::unique_ptr<LiveQuery> lq;
+};
+static std::mutex live_mtx;
+static std::map<std::pair<AtomSpace*, Handle>, Live> live_queries;
+
+/**
+ * cog-live-query! starts keeping the results of the query up to date,
+ * if it is not already, and returns them.
+ */
+static ValuePtr ss_live_query(AtomSpace* atomspace, const Handle& h)
+{
+	std::lock_guard<std::mutex> lck(live_mtx);
+	Live& live = live_queries[{atomspace, h}];
+	if (nullptr == live.lq)
+	{
+		live.asp = AtomSpaceCast(atomspace);
+		live.lq.reset(new LiveQuery(atomspace, h,
+			atomspace->add_node(PREDICATE_NODE, "*-live-results-*")));
+	}
+	return live.lq->get_results();
+}
+
+/**
+ * cog-live-query-stop! stops keeping the results up to date, and
+ * returns the last of them.
+ */
+static ValuePtr ss_live_query_stop(AtomSpace* atomspace, const Handle& h)
+{
+	std::unique_ptr<LiveQuery> lq;
+	{
+		std::lock_guard<std::mutex> lck(live_mtx);
+		auto it = live_queries.find({atomspace, h});
+		if (live_queries.end() == it) return nullptr;
+		lq = std::move(it->second.lq);
+		live_queries.erase(it);
+	}
+	return lq->get_results();
+}
+
 // ========================================================
 
 // XXX HACK ALERT This needs to be static, in order for python to
@@ -72,6 +139,12 @@ void ExecSCM::init(void)
 	_binders = new std::vector<FunctionWrap*>();
 	_binders->push_back(new FunctionWrap(ss_execute,
 	                   "cog-execute!", "exec"));
+	_binders->push_back(new FunctionWrap(ss_execute_profile,
+	                   "cog-execute-profile", "exec"));
+	_binders->push_back(new FunctionWrap(ss_live_query,
+	                   "cog-live-query!", "exec"));
+	_binders->push_back(new FunctionWrap(ss_live_query_stop,
+	                   "cog-live-query-stop!", "exec"));
 }
 
 ExecSCM::~ExecSCM()
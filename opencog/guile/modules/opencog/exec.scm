@@ -7,9 +7,34 @@
 (use-modules (opencog as-config))
 (load-extension (string-append opencog-ext-path-exec "libexec") "opencog_exec_init")
 
-(export cog-execute!)
+(export cog-execute! cog-live-query! cog-live-query-stop!)
+
+(set-procedure-property! cog-live-query! 'documentation
+"
+ cog-live-query! QUERY
+
+   Keep the results of QUERY up to date, as Atoms are added to and
+   extracted from the AtomSpace, and return the current results, as
+   a UnisetValue. The first call runs the query; later calls just
+   return the results. The results are also placed on QUERY, at the
+   key (Predicate \"*-live-results-*\").
+
+   For a QueryLink whose clauses are all found in the AtomSpace, only
+   the neighborhoods of the changed Atoms are searched. Other queries
+   are run again after each batch of changes. The results lag a little
+   behind the AtomSpace.
+")
+
+(set-procedure-property! cog-live-query-stop! 'documentation
+"
+ cog-live-query-stop! QUERY
+
+   Stop keeping the results of QUERY up to date, and return the last
+   of them. See `cog-live-query!`.
+")
 
 (use-modules (ice-9 optargs)) ; for define*-public
+(use-modules (srfi srfi-1))
 
 ; --------------------------------------------------------------------
 
@@ -49,4 +74,56 @@
 		))
 )
 
+; --------------------------------------------------------------------
+
+(define (profile->alist VAL)
+"
+  Convert the LinkValue of key-value pairs, made by the QueryProfile,
+  into an association list. Keys become symbols; counts become numbers.
+"
+	(define (key-val? V)
+		(and (equal? 'LinkValue (cog-type V))
+			(= 2 (length (cog-value->list V)))
+			(equal? 'StringValue (cog-type (cog-value-ref V 0)))))
+
+	(define (convert V)
+		(cond
+			((equal? 'FloatValue (cog-type V)) (cog-value-ref V 0))
+			((equal? 'LinkValue (cog-type V))
+				(let ((items (cog-value->list V)))
+					(if (every key-val? items)
+						(map (lambda (KV)
+								(cons (string->symbol (cog-value-ref KV 0))
+									(convert (cog-value-ref KV 1))))
+							items)
+						(map convert items))))
+			(else V)))
+
+	(convert VAL)
+)
+
+(define-public (cog-execute-profile! EXEC)
+"
+ cog-execute-profile! EXEC
+
+   Execute EXEC, just like `cog-execute!`, while keeping track of what
+   the pattern engine did. Returns an association list: the result of
+   the execution is under the key 'result, and the time taken, in
+   seconds, under 'seconds. Each pattern search that was run has an
+   entry under 'starts, giving the clause and term it started with, and
+   the number of atoms it started from. The entries under 'clauses say
+   how much work went into each clause: the number of candidate
+   groundings tried, tree compares, backtracks, permutation steps, glob
+   steps and evaluations.
+
+   Recording the profile costs little, and can be done on a live system.
+
+   Example:
+      (assoc-ref (cog-execute-profile! (Meet ...)) 'clauses)
+"
+	(define res-prof (cog-value->list (cog-execute-profile EXEC)))
+	(cons (cons 'result (car res-prof))
+		(profile->alist (cadr res-prof)))
+)
+
 ; ------------------ THE END -------------------
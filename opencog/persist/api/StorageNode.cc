@@ -98,6 +98,7 @@ void StorageNode::setValue(const Handle& key, const ValuePtr& value)
 	// *-load-frames-* is in getValue
 	static constexpr uint32_t p_store_frames = dispatch_hash("*-store-frames-*");
 	static constexpr uint32_t p_delete_frame = dispatch_hash("*-delete-frame-*");
+	static constexpr uint32_t p_squash_frames = dispatch_hash("*-squash-frames-*");
 	static constexpr uint32_t p_erase = dispatch_hash("*-erase-*");
 
 	static constexpr uint32_t p_proxy_open = dispatch_hash("*-proxy-open-*");
@@ -283,6 +284,14 @@ void StorageNode::setValue(const Handle& key, const ValuePtr& value)
 			COLL("*-delete-frame-*");
 			delete_frame(HandleCast(value));
 			return;
+		case p_squash_frames: {
+			COLL("*-squash-frames-*");
+			if (not value->is_type(LINK_VALUE)) return;
+			const ValueSeq& vsq(LinkValueCast(value)->value());
+			if (2 > vsq.size()) return;
+			squash_frames(HandleCast(vsq[0]), HandleCast(vsq[1]));
+			return;
+		}
 		case p_erase:
 			COLL("*-erase-*");
 			erase();
@@ -510,6 +519,44 @@ void StorageNode::delete_frame(const Handle& has)
 	return deleteFrame((AtomSpace*)has.get());
 }
 
+void StorageNode::squash_frames(const Handle& htop, const Handle& hbot)
+{
+	AtomSpacePtr top(AtomSpaceCast(htop));
+	AtomSpacePtr bottom(AtomSpaceCast(hbot));
+	if (nullptr == top or nullptr == bottom)
+		throw RuntimeException(TRACE_INFO, "Expecting AtomSpaces!");
+
+	// Find the frames that will no longer be needed in storage. Once
+	// some frame has another one built on it, it, and everything
+	// under it, is still in use, and must be kept.
+	HandleSeq doomed;
+	bool shared = false;
+	AtomSpace* as = top.get();
+	while (as != bottom.get())
+	{
+		const std::vector<AtomSpacePtr>& env(as->getEnviron());
+		if (1 != env.size())
+			throw RuntimeException(TRACE_INFO,
+				"Frames are not in a single chain!");
+		const AtomSpacePtr& below(env[0]);
+		if (1 < below->getIncomingSet().size()) shared = true;
+		if (not shared) doomed.push_back(HandleCast(below));
+		as = below.get();
+	}
+
+	// Delete first; if storage cannot do that, then nothing happens.
+	for (const Handle& h : doomed)
+		deleteFrame((AtomSpace*)h.get());
+
+	top->squash(bottom);
+
+	storeFrameDAG(top.get());
+	HandleSeq hs;
+	get_atoms_in_frame(top.get(), hs);
+	for (const Handle& h : hs)
+		storeAtom(h);
+}
+
 // ====================================================================
 
 void StorageNode::proxy_open(void)
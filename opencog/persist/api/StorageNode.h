@@ -209,6 +209,19 @@ public:
 	 */
 	void delete_frame(const Handle&);
 
+	/**
+	 * Collapse the chain of AtomSpace frames from `top` down to, and
+	 * including `bottom`, into the single frame `top`. This is done
+	 * both in RAM (see `AtomSpace::squash()`) and in storage: the
+	 * collapsed frames that no other frame is built on are deleted
+	 * from storage, and the merged contents of `top`, together with
+	 * its new place in the DAG, are written back.
+	 *
+	 * Both arguments must be AtomSpacePtr's, with `bottom` somewhere
+	 * below `top` in a chain of single-inheritance frames.
+	 */
+	void squash_frames(const Handle& top, const Handle& bottom);
+
 	/**
 	 * Use the backing store to load the entire incoming set of the
 	 * atom.
@@ -131,7 +131,7 @@ bool ContinuationMixin::satisfy(const PatternLinkPtr& form)
 		{
 			in_continuation = true;
 			Handle plk = _continuation->getOutgoingAtom(0);
-			AtomSpace* tas = TermMatchMixin::_temp_aspace;
+			AtomSpace* tas = TermMatchMixin::_tstate.temp_aspace;
 			tas->clear();
 			bool crispy = EvaluationLink::crisp_eval_scratch(tas, plk, tas);
 
@@ -58,6 +58,21 @@ class Implicator:
 			}
 };
 
+/// The Implicator used by QueryLink. The search state is kept
+/// per-thread by the mixins, and groundings are proposed under a
+/// lock, so large searches can run in parallel. Subclasses that
+/// override any of the callbacks start out serial, until they are
+/// checked, and say otherwise.
+class DefaultImplicator:
+	public Implicator
+{
+	public:
+		DefaultImplicator(AtomSpace* asp, ContainerValuePtr& cvp) :
+			Implicator(asp, cvp) {}
+
+		virtual bool thread_safe(void) { return true; }
+};
+
 }; // namespace opencog
 
 #endif // _OPENCOG_IMPLICATOR_H
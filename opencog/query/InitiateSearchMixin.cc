@@ -21,6 +21,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <cfloat>
+
 #include <opencog/atomspace/AtomSpace.h>
 
 #include <opencog/atoms/core/DefineLink.h>
@@ -31,12 +33,9 @@
 
 #include "InitiateSearchMixin.h"
 #include "PatternMatchEngine.h"
-
-#ifdef USE_THREADED_PATTERN_ENGINE
-	// #include <algorithm>
-	// #include <execution>
-	#include <opencog/util/oc_omp.h>
-#endif // USE_THREADED_PATTERN_ENGINE
+#include "QueryProfile.h"
+#include "SearchPool.h"
+#include "SearchStats.h"
 
 using namespace opencog;
 
@@ -49,12 +48,14 @@ using namespace opencog;
 
 /* ======================================================== */
 
+thread_local InitiateSearchMixin::ClauseState*
+	InitiateSearchMixin::_worker_clauses = nullptr;
+
 InitiateSearchMixin::InitiateSearchMixin(AtomSpace* as) :
-	_nameserver(nameserver())
+	_nameserver(nameserver()), _clause_workers(0)
 {
 	_variables = nullptr;
 	_pattern = nullptr;
-	_recursing = false;
 
 	_root = PatternTerm::UNDEFINED;
 	_starter_term = PatternTerm::UNDEFINED;
@@ -105,8 +106,8 @@ InitiateSearchMixin::InitiateSearchMixin(AtomSpace* as) :
 //
 // size_t& depth will be set to the depth of the thinnest constant found.
 // Handle& start will be set to the link containing that constant.
-// size_t& width will be set to the incoming-set size of the thinnest
-//               constant found.
+// size_t& width will be set to the number of Links, of the type of the
+//               start term, that hold the thinnest constant found.
 // The returned value will be the constant at which to start the search.
 // If no constant is found, then the returned value is the undefined
 // handle.
@@ -197,6 +198,17 @@ InitiateSearchMixin::find_starter_recursive(const PatternTermPtr& ptm,
 			if (sbr->isIdentical())
 				continue;
 
+			// The search will run over the Links of this type that
+			// hold the constant, and not over all of its incoming set.
+			// A position index may know of fewer candidates still.
+			if (CHOICE_LINK != t and s == hunt->getHandle())
+			{
+				brwid = s->getIncomingSetSizeByType(t);
+				size_t pos;
+				auto pidx(find_position_index(ptm, s, pos));
+				if (pidx) brwid = std::min(brwid, pidx->count(s));
+			}
+
 			// Each ChoiceLink is potentially disconnected from the rest
 			// of the graph. Assume the worst case, explore them all.
 			if (CHOICE_LINK == t)
@@ -204,7 +216,8 @@ InitiateSearchMixin::find_starter_recursive(const PatternTermPtr& ptm,
 				Choice ch;
 				ch.clause = _curr_clause;
 				ch.start_term = sbr;
-				ch.search_set = get_incoming_set(s, sbr->getQuote()->get_type());
+				ch.start = s;
+				make_search_set(ch, true);
 				_start_choices.push_back(ch);
 			}
 			else
@@ -224,24 +237,238 @@ InitiateSearchMixin::find_starter_recursive(const PatternTermPtr& ptm,
 }
 
 /* ======================================================== */
+
+// If the AtomSpace has a position index for the link type of `term`,
+// at the position where `start` appears in it, return that index.
+// Every grounding of `term` is then among the links that the index
+// holds for `start`. The index covers only the atoms in one frame,
+// and so is not used when searching a stack of frames. Terms with
+// globs have no fixed positions, and terms holding `start` more than
+// once are left alone.
+std::shared_ptr<const PositionIndex>
+InitiateSearchMixin::find_position_index(const PatternTermPtr& term,
+                                         const Handle& start,
+                                         size_t& pos)
+{
+	if (nullptr == _as or 0 < _as->get_arity()) return nullptr;
+
+	const Handle& h = term->getHandle();
+	if (not h->is_link() or term->hasGlobbyVar()) return nullptr;
+
+	pos = SIZE_MAX;
+	const PatternTermSeq& oset = term->getOutgoingSet();
+	for (size_t i = 0; i < oset.size(); i++)
+	{
+		if (oset[i]->getHandle() != start) continue;
+		if (SIZE_MAX != pos) return nullptr;
+		pos = i;
+	}
+	if (SIZE_MAX == pos) return nullptr;
+
+	return _as->get_position_index(h->get_type(), pos);
+}
+
+/* ======================================================== */
+/**
+ * Estimated number of Links of the type of each of the terms above
+ * `term`, up to `clause`, visited when walking upwards from a
+ * grounding of `term`. This is what the engine does when it moves
+ * from one clause to the next; see `PatternMatchEngine::explore_up_branches()`.
+ */
+double InitiateSearchMixin::fan_in(const PatternTermPtr& term,
+                                   const PatternTermPtr& clause)
+{
+	SearchStats& stats(search_stats());
+	double f = 1.0;
+	PatternTermPtr ptm(term);
+	while (ptm != clause)
+	{
+		const PatternTermPtr& parent = ptm->getParent();
+		if (nullptr == parent or nullptr == parent->getHandle()) break;
+
+		// All of the alternatives are tried; no Links to walk.
+		if (parent->isChoice()) { ptm = parent; continue; }
+
+		size_t pos = SearchStats::ANY;
+		if (not parent->isUnorderedLink() and not parent->hasGlobbyVar())
+		{
+			const PatternTermSeq& oset = parent->getOutgoingSet();
+			for (size_t i = 0; i < oset.size(); i++)
+				if (oset[i] == ptm) { pos = i; break; }
+		}
+		f *= stats.fan_in(_as, parent->getHandle()->get_type(), pos);
+		ptm = parent;
+	}
+	return f;
+}
+
+/**
+ * Fraction of the Links that a clause might be grounded by, that
+ * hold the constants in the clause. Each constant is taken to be
+ * independent of the others. For example, if half of the ListLinks
+ * hold "item", and a third of the EvaluationLinks hold "blah", then
+ * a sixth of the (Evaluation "blah" (List $var "item")) are expected
+ * to be found, per grounding of $var.
+ */
+double InitiateSearchMixin::selectivity(const PatternTermPtr& ptm)
+{
+	const auto& it = _selectivity.find(ptm);
+	if (_selectivity.end() != it) return it->second;
+
+	double sel = 1.0;
+	Type t = ptm->getHandle()->get_type();
+	for (const PatternTermPtr& sub : ptm->getOutgoingSet())
+	{
+		if (sub->isChoice() or sub->hasAnyEvaluatable()) continue;
+		if (sub->hasAnyBoundVariable() or sub->hasAnyGlobbyVar()
+		    or sub->hasAnyAnonVar())
+		{
+			if (sub->isLink()) sel *= selectivity(sub);
+			continue;
+		}
+		if (ptm->isChoice()) continue;
+
+		size_t nlinks = _as->get_num_atoms_of_type(t);
+		if (0 == nlinks) { sel = 0.0; break; }
+		double frac = sub->getHandle()->getIncomingSetSizeByType(t);
+		sel *= std::min(1.0, frac / nlinks);
+	}
+	_selectivity[ptm] = sel;
+	return sel;
+}
+
+/**
+ * Estimated number of groundings of `clause`, per grounding of the
+ * variables in `bound`. Returns DBL_MAX if the clause does not share
+ * any of these variables.
+ */
+double InitiateSearchMixin::fan_out(const PatternTermPtr& clause,
+                                    const HandleSet& bound)
+{
+	const auto& vit = _pattern->clause_variables.find(clause);
+	if (_pattern->clause_variables.end() == vit) return DBL_MAX;
+
+	double f = DBL_MAX;
+	bool all_bound = true;
+	for (const Handle& v : vit->second)
+	{
+		if (bound.end() == bound.find(v)) { all_bound = false; continue; }
+
+		const auto& tit = _pattern->connected_terms_map.find({v, clause});
+		if (_pattern->connected_terms_map.end() == tit) continue;
+		for (const PatternTermPtr& ptm : tit->second)
+			f = std::min(f, fan_in(ptm, clause));
+	}
+	if (DBL_MAX == f) return f;
+
+	f *= selectivity(clause);
+
+	// Nothing left to ground; it can only pass or fail.
+	if (all_bound) f = std::min(f, 1.0);
+	return f;
+}
+
 /**
- * Iterate over all the clauses, to find the "thinnest" one.
+ * Estimated cost of a search starting with `start`, when `width`
+ * groundings of it are to be tried. This is the total number of
+ * partial groundings made along the way, when the other clauses are
+ * taken in the cheapest order: always the one with the smallest
+ * fan-out, of those connected to what is grounded so far. That is
+ * the order that get_next_thinnest_clause() will mostly follow.
+ *
+ * Evaluatable clauses are left out; they are checked last, and do
+ * not multiply the work. Clauses not connected to the start are in
+ * other components, and searched separately.
+ *
+ * If `record` is set, the order is saved in `_plan_rank`.
+ */
+double InitiateSearchMixin::plan_cost(const PatternTermPtr& start,
+                                      double width, bool record)
+{
+	PatternTermSeq todo;
+	for (const PatternTermPtr& ptm : _pattern->pmandatory)
+	{
+		if (ptm == start or ptm->hasAnyEvaluatable()) continue;
+		todo.push_back(ptm);
+	}
+
+	HandleSet bound;
+	const auto& vit = _pattern->clause_variables.find(start);
+	if (_pattern->clause_variables.end() != vit)
+		bound.insert(vit->second.begin(), vit->second.end());
+
+	if (record)
+	{
+		_plan_rank.clear();
+		_plan_rank[start] = 0;
+	}
+
+	double rows = width;
+	double cost = width;
+	while (not todo.empty())
+	{
+		double least = DBL_MAX;
+		auto next = todo.end();
+		for (auto it = todo.begin(); it != todo.end(); it++)
+		{
+			double f = fan_out(*it, bound);
+			if (f < least) { least = f; next = it; }
+		}
+		if (todo.end() == next) break;
+
+		rows *= least;
+		cost += rows;
+
+		const auto& nit = _pattern->clause_variables.find(*next);
+		if (_pattern->clause_variables.end() != nit)
+			bound.insert(nit->second.begin(), nit->second.end());
+		if (record)
+		{
+			size_t rank = _plan_rank.size();
+			_plan_rank[*next] = rank;
+		}
+		todo.erase(next);
+	}
+	return cost;
+}
+
+/**
+ * Iterate over all the clauses, to find the cheapest place to start.
  * Skip any/all evaluatable clauses, as these typically do not
  * exist in the atomspace, anyway.
  *
  * An exception: the IdenticalLink can be treated as non-virtual, and we
  * can begin the search at ne of the terms inside of an IdenticalLink.
+ *
+ * The thinnest start is not always the cheapest. A thin start that
+ * leads to a hub (the PredicateNode of an EvaluationLink, say) makes
+ * for a lot more work than a somewhat thicker one leading to thin
+ * places. So, when there are several clauses, each start is costed
+ * with plan_cost(). The depth breaks ties, as before.
+ *
+ * Each clause holding ChoiceLinks offers a set of starts, all of
+ * which have to be searched. The cheapest such set is kept, and used
+ * if it costs less than the cheapest single start.
  */
 Handle InitiateSearchMixin::find_thinnest(const PatternTermSeq& clauses,
                                           PatternTermPtr& starter_term,
                                           PatternTermPtr& bestclause)
 {
-	size_t thinnest = SIZE_MAX;
+	double cheapest = DBL_MAX;
 	size_t deepest = 0;
 	bestclause = PatternTerm::UNDEFINED;
 	Handle best_start(Handle::UNDEFINED);
 	starter_term = PatternTerm::UNDEFINED;
 	_start_choices.clear();
+	_plan_rank.clear();
+	_selectivity.clear();
+
+	// Nothing to plan, with only one clause.
+	bool plan = nullptr != _as and 1 < _pattern->pmandatory.size();
+
+	double choice_cost = DBL_MAX;
+	std::vector<Choice> best_choices;
+	double best_width = 0;
 
 	for (const PatternTermPtr& ptm: clauses)
 	{
@@ -249,26 +476,54 @@ Handle InitiateSearchMixin::find_thinnest(const PatternTermSeq& clauses,
 		if (ptm->hasAnyEvaluatable() and not ptm->isIdentical()) continue;
 
 		_curr_clause = ptm;
+		size_t nchoices = _start_choices.size();
 		size_t depth = 0;
 		size_t width = SIZE_MAX;
 		PatternTermPtr term(PatternTerm::UNDEFINED);
 		Handle start(find_starter(ptm, depth, term, width));
-		if (start
-		    and (width < thinnest
-		         or (width == thinnest and depth > deepest)))
+		if (start)
+		{
+			double cost = plan ? plan_cost(ptm, width) : width;
+			if (cost < cheapest or (cost == cheapest and depth > deepest))
+			{
+				cheapest = cost;
+				deepest = depth;
+				bestclause = ptm;
+				best_start = start;
+				starter_term = term;
+				best_width = width;
+			}
+		}
+
+		// All of the choices found in this clause.
+		if (nchoices < _start_choices.size())
 		{
-			thinnest = width;
-			deepest = depth;
-			bestclause = ptm;
-			best_start = start;
-			starter_term = term;
+			double cost = 0.0;
+			for (size_t i = nchoices; i < _start_choices.size(); i++)
+			{
+				double nset = _start_choices[i].search_set.size();
+				cost += plan ? plan_cost(ptm, nset) : nset;
+			}
+			if (cost < choice_cost)
+			{
+				choice_cost = cost;
+				best_choices.assign(_start_choices.begin() + nchoices,
+				                    _start_choices.end());
+			}
 		}
+	}
 
-		// If we encountered choices, then we have enumerated all of them.
-		// So we are good to go. XXX FIXME -- we could try again, to find
-		// some thinner set of choices. Later, some other time.
-		if (0 < _start_choices.size()) break;
+	_start_choices.clear();
+	if (choice_cost < cheapest)
+	{
+		_start_choices.swap(best_choices);
+		bestclause = _start_choices[0].clause;
+		best_start = Handle::UNDEFINED;
+		starter_term = PatternTerm::UNDEFINED;
+		if (plan) plan_cost(bestclause, 0, true);
 	}
+	else if (plan and best_start)
+		plan_cost(bestclause, best_width, true);
 
 	return best_start;
 }
@@ -344,6 +599,9 @@ bool InitiateSearchMixin::setup_neighbor_search(const PatternTermSeq& clauses)
 	// Note also: the user is allowed to specify patterns that have
 	// no constants in them at all.  In this case, the search is
 	// performed by looping over all links of the given types.
+	bool found;
+	if (reuse_plan(clauses, found)) return found;
+
 	PatternTermPtr bestclause;
 	Handle best_start = find_thinnest(clauses, _starter_term, bestclause);
 
@@ -353,7 +611,10 @@ bool InitiateSearchMixin::setup_neighbor_search(const PatternTermSeq& clauses)
 	// Somewhat unusual, but it can happen.  For this, we need
 	// some other, alternative search strategy.
 	if (nullptr == best_start and 0 == _start_choices.size())
+	{
+		save_plan(clauses, false);
 		return false;
+	}
 
 	// If only a single choice, fake it for the choice_loop.
 	if (0 == _start_choices.size())
@@ -361,27 +622,133 @@ bool InitiateSearchMixin::setup_neighbor_search(const PatternTermSeq& clauses)
 		Choice ch;
 		ch.clause = bestclause;
 		ch.start_term = _starter_term;
-
-		// This feels wonky. Is this correct?
-		if (_starter_term->getHandle()->is_link())
-		{
-			// XXX ?? Why incoming set ???
-			ch.search_set = get_incoming_set(best_start,
-			                              _starter_term->getHandle()->get_type());
-		}
-		else
-		{
-			ch.search_set = HandleSeq({best_start});
-		}
+		ch.start = best_start;
+		make_search_set(ch, false);
 		_start_choices.push_back(ch);
 	}
 	else
 	{
 		// TODO -- weed out duplicates!
 	}
+	save_plan(clauses, 0 < _start_choices.size() and not best_start);
+	return true;
+}
+
+/// Fill in the search set of the Choice, from the start atom.
+/// If `choice` is set, the start is one of the alternatives of
+/// a ChoiceLink.
+void InitiateSearchMixin::make_search_set(Choice& ch, bool choice)
+{
+	if (choice)
+	{
+		ch.search_set = get_incoming_set(ch.start,
+		                        ch.start_term->getQuote()->get_type());
+		return;
+	}
+
+	// This feels wonky. Is this correct?
+	size_t pos;
+	auto pidx(find_position_index(ch.start_term, ch.start, pos));
+	if (pidx)
+	{
+		// Only the links holding the start at the right place.
+		pidx->get_links(ch.search_set, ch.start);
+	}
+	else
+	if (ch.start_term->getHandle()->is_link())
+	{
+		// XXX ?? Why incoming set ???
+		ch.search_set = get_incoming_set(ch.start,
+		                        ch.start_term->getHandle()->get_type());
+	}
+	else
+	{
+		ch.search_set = HandleSeq({ch.start});
+	}
+}
+
+/* ======================================================== */
+
+// The same few patterns tend to be run over and over, and picking a
+// start for them each time is a waste. So the start, and the planned
+// clause order, are kept with the Pattern, and used again as long as
+// the AtomSpace has not grown or shrunk much. The search sets are
+// always made afresh; if one of them has grown a lot since the plan
+// was made, then the plan is made again.
+
+// Search sets smaller than this are cheap, no matter how much they
+// have grown.
+#define MIN_REPLAN 16
+
+/// Set up the search from the saved plan, if there is one that fits.
+/// Returns true, if it does. Sets `found` to false, if the plan says
+/// that there is no place to start.
+bool InitiateSearchMixin::reuse_plan(const PatternTermSeq& clauses,
+                                     bool& found)
+{
+	SearchPlanPtr plan;
+	{
+		std::lock_guard<std::mutex> lck(_pattern->plan_mtx);
+		plan = _pattern->plan;
+	}
+
+	if (nullptr == plan
+	    or plan->aspace != (_as ? _as->get_uuid() : 0)
+	    or plan->planner != std::type_index(typeid(*this))
+	    or plan->epoch != SearchStats::epoch(_as)
+	    or plan->clauses != clauses)
+	{
+		search_stats().count_plan(false);
+		return false;
+	}
+
+	_start_choices.clear();
+	for (const SearchPlan::Start& st : plan->starts)
+	{
+		Choice ch;
+		ch.clause = st.clause;
+		ch.start_term = st.term;
+		ch.start = st.atom;
+		make_search_set(ch, st.choice);
+
+		// Grown too much; some other start might be better now.
+		if (2 * st.width + MIN_REPLAN < ch.search_set.size())
+		{
+			_start_choices.clear();
+			search_stats().count_plan(false);
+			return false;
+		}
+		_start_choices.emplace_back(std::move(ch));
+	}
+
+	search_stats().count_plan(true);
+	_plan_rank = plan->rank;
+	found = not _start_choices.empty();
+	if (found) _starter_term = _start_choices[0].start_term;
 	return true;
 }
 
+/// Save the outcome of setup_neighbor_search(). If `choice` is set,
+/// the starts are the alternatives of ChoiceLinks.
+void InitiateSearchMixin::save_plan(const PatternTermSeq& clauses,
+                                    bool choice)
+{
+	std::shared_ptr<SearchPlan> plan(std::make_shared<SearchPlan>());
+	plan->aspace = _as ? _as->get_uuid() : 0;
+	plan->epoch = SearchStats::epoch(_as);
+	plan->planner = typeid(*this);
+	plan->clauses = clauses;
+	plan->rank = _plan_rank;
+	for (const Choice& ch : _start_choices)
+	{
+		plan->starts.push_back({ch.clause, ch.start_term, ch.start,
+		                        ch.search_set.size(), choice});
+	}
+
+	std::lock_guard<std::mutex> lck(_pattern->plan_mtx);
+	_pattern->plan = plan;
+}
+
 /* ======================================================== */
 
 bool InitiateSearchMixin::choice_loop(PatternMatchCallback& pmc,
@@ -506,6 +873,10 @@ bool InitiateSearchMixin::perform_search(PatternMatchCallback& pmc)
 	_curr_clause = PatternTerm::UNDEFINED;
 	_search_set.clear();
 	_start_choices.clear();
+	_plan_rank.clear();
+
+	if (not _seeds.empty())
+		return seed_search(pmc);
 
 	// Fallback to the legacy mode.
 	if (1 != _pattern->pmandatory.size())
@@ -566,6 +937,30 @@ bool InitiateSearchMixin::conjoin_search(PatternMatchCallback& pmc,
 	return false;
 }
 
+/// Search only from the seeds. Each seed is offered as the grounding
+/// of each clause of the same type. Evaluatable clauses are not in the
+/// AtomSpace, and so cannot be grounded by a seed. The same grounding
+/// is found more than once, if it involves more than one seed.
+bool InitiateSearchMixin::seed_search(PatternMatchCallback& pmc)
+{
+	for (const PatternTermPtr& cl : _pattern->pmandatory)
+	{
+		if (cl->hasAnyEvaluatable() or cl->isIdentical()) continue;
+
+		Type ct = cl->getHandle()->get_type();
+		_search_set.clear();
+		for (const Handle& h : _seeds)
+			if (h->get_type() == ct) _search_set.push_back(h);
+		if (_search_set.empty()) continue;
+
+		_root = cl;
+		_starter_term = cl;
+		if (search_loop(pmc, "ssssssssss seed_search ssssssssss"))
+			return true;
+	}
+	return false;
+}
+
 bool InitiateSearchMixin::legacy_search(PatternMatchCallback& pmc)
 {
 	const PatternTermSeq& clauses = get_clause_list();
@@ -1122,125 +1517,132 @@ bool InitiateSearchMixin::setup_no_search(void)
 bool InitiateSearchMixin::search_loop(PatternMatchCallback& pmc,
                                       const std::string dbg_banner)
 {
+	QueryProfile* prof = QueryProfile::active();
+	if (prof)
+		prof->add_start(_root->getQuote(),
+		                _starter_term ? _starter_term->getQuote() : Handle(),
+		                _search_set.size());
+
 	// This is the main entry point into the CPU-cycle sucking part of
-	// the pattern search.  If `USE_THREADED_PATTERN_ENGINE` is defined,
-	// then it runs in parallel. It works, unit-tests pass. But ...
-	// But the overhead is so large, that, for small pattern matches,
-	// the setup of going parallel is far more expensive than the gain
-	// from parallelism. (RandomUTest runs 25x slower! GetStateUTest
-	// runs 33x slower!) So this code is currently disabled.
-	//
-	// If `_search_set` is large, or the if pattern is large/complex,
-	// then the extra cost might be worth it. However, this is NOT
-	// always the bottleneck! Be careful not to penalize small users!
-	// See the benchmark `nano-en.scm` in the opencog/benchmark GitHub
-	// repo, for example.
+	// the pattern search. Large searches are spread over the threads
+	// of the SearchPool. But not small ones: even with the threads
+	// already running, handing out the work costs more than a small
+	// search does. (Starting threads anew for each search made
+	// RandomUTest run 25x slower, and GetStateUTest 33x slower.)
+	// Many users make many small queries; see the benchmark
+	// `nano-en.scm` in the opencog/benchmark GitHub repo, for example.
 	//
-#ifndef USE_THREADED_PATTERN_ENGINE
-	// See explanation below for the `_recursing` flag.
-	_recursing = true;
-#endif
-
-	if (_recursing)
+	// The cost of a search is roughly the number of starting points,
+	// times the number of clauses that must be grounded for each.
+	if (pmc.thread_safe() and 1 < _search_set.size())
 	{
-		// Plain-old, olde-fashioned sequential search loop.
-		// This works.
+		size_t nclauses = _pattern->pmandatory.size() +
+			_pattern->absents.size() + _pattern->always.size();
+		SearchPool& pool(search_pool());
+		if (1 < pool.size() and
+		    pool.get_threshold() <= _search_set.size() * nclauses)
+			return parallel_loop(pmc);
+	}
+
+	// Plain-old, olde-fashioned sequential search loop.
 #ifdef QDEBUG
-		size_t i = 0, hsz = _search_set.size();
+	size_t i = 0, hsz = _search_set.size();
 #endif
 
-		PatternMatchEngine pme(pmc);
-		pme.set_pattern(*_variables, *_pattern);
-
-		while (0 < _issued_stack.size()) _issued_stack.pop();
-		_issued.clear();
-		_issued.insert(_root);
-		for (const Handle& h : _search_set)
-		{
-			DO_LOG({LAZY_LOG_FINE << dbg_banner
-			             << "\n       Loop candidate ("
-			             << ++i << "/" << hsz << "):\n"
-			             << h->to_string("       ");})
-			bool found = pme.explore_neighborhood(_starter_term,
-			                                      h, _root);
-			if (found) return true;
-		}
+	PatternMatchEngine pme(pmc);
+	pme.set_pattern(*_variables, *_pattern);
 
-		return false;
+	ClauseState& st(cs());
+	while (0 < st.issued_stack.size()) st.issued_stack.pop();
+	st.issued.clear();
+	st.issued.insert(_root);
+	for (const Handle& h : _search_set)
+	{
+		DO_LOG({LAZY_LOG_FINE << dbg_banner
+		             << "\n       Loop candidate ("
+		             << ++i << "/" << hsz << "):\n"
+		             << h->to_string("       ");})
+		bool found = pme.explore_neighborhood(_starter_term,
+		                                      h, _root);
+		if (found) return true;
 	}
 
-	// Note also: for multi-component patterns, this entire class
-	// is used recursively in multiple threads. This is because
-	// `PatternLink::satisfy()` is recursive, when there are multiple
-	// components. So: we start here, create multiple threads,
-	// and then pass ourselves into each thread. When there are
-	// components, this gets wrapped in PMCGroundings and then
-	// `PatternLink::satisfy()` is called .. once in each thread!
-	// Which causes a new start-point to be searched for, for each
-	// component which clobbers this structure against itself.  Fail.
-	// The `_recursing` flag prevents this double-threading.
-// #define PM_PARALLEL 1
-#ifdef PM_PARALLEL
-	// Parallel loop. This requires linking to -ltbb to work.
-	_recursing = true;
-
-	_issued_stack.clear();
-	_issued.clear();
-	_issued.insert(_root);
-
-	std::atomic<size_t> nfnd = 0;
-	std::for_each(
-		std::execution::par_unseq,
-		_search_set.begin(),
-		_search_set.end(),
-		[&](auto&& h)
-		{
-			PatternMatchEngine pme(pmc);
-			pme.set_pattern(*_variables, *_pattern);
-
-			if (pme.explore_neighborhood(_starter_term, h, _root)) nfnd++;
-		});
-
-	_recursing = false;
-	return 0 < nfnd;
-
-#endif
+	return false;
+}
 
-#ifdef USE_THREADED_PATTERN_ENGINE
-	#define OMP_PM_PARALLEL 1
-#endif
-#ifdef OMP_PM_PARALLEL
-	// Parallel loop. This requires OpenMP to work.
-	_recursing = true;
-	_issued_stack.clear();
-	_issued.clear();
-	_issued.insert(_root);
+/* ======================================================== */
 
-#ifdef QDEBUG
-	size_t i = 0;
-#endif
+/// The search loop, as run by each of the SearchPool threads.
+///
+/// Each thread gets its own PatternMatchEngine, and its own
+/// ClauseState. The callback sets up whatever else it needs per
+/// thread in `worker_start()`. Note that multi-component patterns
+/// come through here once per component, with the callback wrapped
+/// in PMCGroundings (see SatisfyMixin.cc); the same InitiateSearchMixin
+/// is used for each, so the per-thread state cannot be kept in it.
+struct InitiateSearchMixin::LoopJob : public SearchPool::Job
+{
+	InitiateSearchMixin& _ism;
+	PatternMatchCallback& _pmc;
+	std::vector<ClauseState> _states;
+	std::vector<std::unique_ptr<PatternMatchEngine>> _pmes;
+	QueryProfile* _profile;
+	std::mutex _mtx;
+
+	LoopJob(InitiateSearchMixin& ism, PatternMatchCallback& pmc,
+	        size_t nthreads) :
+		_ism(ism), _pmc(pmc), _states(nthreads), _pmes(nthreads),
+		_profile(QueryProfile::active())
+	{}
+
+	void start(size_t t)
+	{
+		_pmc.worker_start();
+
+		// The engine records into the profile of the thread that
+		// started the search.
+		QueryProfile* prev = QueryProfile::exchange(_profile);
+		_pmes[t].reset(new PatternMatchEngine(_pmc));
+		QueryProfile::exchange(prev);
+		_pmes[t]->set_pattern(*_ism._variables, *_ism._pattern);
+
+		ClauseState& st(_states[t]);
+		st.issued.insert(_ism._root);
+		st.owner = &_ism;
+		st.prev = _worker_clauses;
+		_worker_clauses = &st;
+		_ism._clause_workers++;
+	}
 
-	std::atomic<size_t> nfnd = 0;
-	size_t hsz = _search_set.size();
-	#pragma omp parallel for
-	for (size_t j=0; j<hsz; j++)
+	bool work(size_t t, size_t begin, size_t end)
 	{
-		PatternMatchEngine pme(pmc);
-		pme.set_pattern(*_variables, *_pattern);
+		PatternMatchEngine& pme(*_pmes[t]);
+		for (size_t j = begin; j < end; j++)
+		{
+			if (halted()) return false;
+			if (pme.explore_neighborhood(_ism._starter_term,
+			                             _ism._search_set[j], _ism._root))
+				return true;
+		}
+		return false;
+	}
 
-		Handle h(_search_set[j]);
-		DO_LOG({LAZY_LOG_FINE << dbg_banner
-		             << "\n       Loop candidate ("
-		             << ++i << "/" << hsz << "):\n"
-		             << h->to_short_string("       ");})
+	void finish(size_t t)
+	{
+		_ism._clause_workers--;
+		_worker_clauses = _states[t].prev;
+		_pmes[t].reset();
 
-		if (pme.explore_neighborhood(_starter_term, h, _root)) nfnd++;
+		std::lock_guard<std::mutex> lck(_mtx);
+		_pmc.worker_end();
 	}
-	_recursing = false;
-	return 0 < nfnd;
-#endif
+};
 
-	return false;
+bool InitiateSearchMixin::parallel_loop(PatternMatchCallback& pmc)
+{
+	SearchPool& pool(search_pool());
+	LoopJob job(*this, pmc, pool.size());
+	return pool.run(job, _search_set.size());
 }
 
 /* ======================================================== */
@@ -25,6 +25,8 @@
 #ifndef _OPENCOG_INITIATE_SEARCH_H
 #define _OPENCOG_INITIATE_SEARCH_H
 
+#include <atomic>
+
 #include <opencog/util/empty_string.h>
 #include <opencog/atoms/atom_types/types.h>
 #include <opencog/atoms/core/Quotation.h>
@@ -34,6 +36,7 @@
 namespace opencog {
 
 class AtomSpace;
+class PositionIndex;
 
 /**
  * Callback mixin class, used to provide a default atomspace search.
@@ -54,6 +57,16 @@ public:
 	 */
 	virtual bool perform_search(PatternMatchCallback&);
 
+	/**
+	 * Limit the search to the neighborhoods of the given atoms: each
+	 * is tried as the grounding of the clauses it might ground. Any
+	 * grounding that involves one of these, as the grounding of some
+	 * clause, is found. This is used to update the results of a
+	 * query after these atoms were added to the AtomSpace. An empty
+	 * list restores the usual search.
+	 */
+	void set_seeds(const HandleSeq& seeds) { _seeds = seeds; }
+
 	virtual void push(void);
 	virtual void pop(void);
 	virtual void next_connections(const GroundingMap&);
@@ -65,8 +78,6 @@ protected:
 
 	NameServer& _nameserver;
 
-	bool _recursing;
-
 	PatternTermPtr _root;
 	PatternTermPtr _starter_term;
 	HandleSeq _search_set;
@@ -75,10 +86,12 @@ protected:
 	{
 		PatternTermPtr clause;
 		PatternTermPtr start_term;
+		Handle start;  // The atom the search set was made from.
 		HandleSeq search_set;
 	};
 	PatternTermPtr _curr_clause;
 	std::vector<Choice> _start_choices;
+	HandleSeq _seeds;
 
 	virtual Handle find_starter(const PatternTermPtr&,
 	                            size_t&, PatternTermPtr&, size_t&);
@@ -88,10 +101,26 @@ protected:
 	                             PatternTermPtr&, PatternTermPtr&);
 	virtual void find_rarest(const PatternTermPtr&, PatternTermPtr&,
 	                         size_t&, Quotation quotation=Quotation());
+	std::shared_ptr<const PositionIndex>
+	find_position_index(const PatternTermPtr&, const Handle&, size_t&);
+
+	// Cost estimates for picking the starting clause; see
+	// find_thinnest(). The rank is the position of each clause in
+	// the plan made for the chosen start; get_next_thinnest_clause()
+	// follows it, when nothing better is known.
+	std::map<PatternTermPtr, size_t> _plan_rank;
+	std::map<PatternTermPtr, double> _selectivity;
+	double plan_cost(const PatternTermPtr&, double, bool record=false);
+	double fan_out(const PatternTermPtr&, const HandleSet&);
+	double fan_in(const PatternTermPtr&, const PatternTermPtr&);
+	double selectivity(const PatternTermPtr&);
 
 	const PatternTermSeq& get_clause_list(void);
 
 	bool setup_neighbor_search(const PatternTermSeq&);
+	void make_search_set(Choice&, bool);
+	bool reuse_plan(const PatternTermSeq&, bool&);
+	void save_plan(const PatternTermSeq&, bool);
 	bool setup_no_search(void);
 	bool setup_deep_type_search(const PatternTermSeq&);
 	bool setup_link_type_search(const PatternTermSeq&);
@@ -100,6 +129,7 @@ protected:
 	bool disjoin_search(PatternMatchCallback&, const PatternTermSeq&);
 	bool conjoin_search(PatternMatchCallback&, const PatternTermSeq&);
 	bool legacy_search(PatternMatchCallback&);
+	bool seed_search(PatternMatchCallback&);
 	bool choice_loop(PatternMatchCallback&, const std::string);
 	bool search_loop(PatternMatchCallback&, const std::string);
 
@@ -109,14 +139,41 @@ protected:
 	// --------------------------------------------
 	// Methods and state that select the next clause to be grounded.
 	typedef std::set<PatternTermPtr> IssuedSet;
+	typedef std::vector<Choice> ChoiceList;
 
-	// Set of clauses for which a grounding is currently being attempted.
-	IssuedSet _issued;     // stacked on _issued_stack
-	std::stack<IssuedSet> _issued_stack;
+	// This state changes as the search progresses. When the search
+	// runs in parallel, each thread has its own; see search_loop().
+	struct ClauseState
+	{
+		// Set of clauses for which a grounding is currently being
+		// attempted.
+		IssuedSet issued;     // stacked on issued_stack
+		std::stack<IssuedSet> issued_stack;
 
-	typedef std::vector<Choice> ChoiceList;
-	ChoiceList _next_choices;
-	std::stack<ChoiceList> _choice_stack;
+		ChoiceList next_choices;
+		std::stack<ChoiceList> choice_stack;
+
+		// The search this belongs to, and the one it is nested in.
+		const InitiateSearchMixin* owner = nullptr;
+		ClauseState* prev = nullptr;
+	};
+	ClauseState _cstate;
+	static thread_local ClauseState* _worker_clauses;
+
+	// Number of threads running this search in parallel. While it is
+	// zero, there is no need to look at the thread-local state.
+	std::atomic<size_t> _clause_workers;
+
+	ClauseState& cs(void)
+	{
+		if (0 == _clause_workers.load(std::memory_order_relaxed))
+			return _cstate;
+		ClauseState* wc = _worker_clauses;
+		return (wc and this == wc->owner) ? *wc : _cstate;
+	}
+
+	struct LoopJob;
+	bool parallel_loop(PatternMatchCallback&);
 
 	Handle get_glob_embedding(const GroundingMap&, const Handle&);
 	bool get_next_thinnest_clause(const GroundingMap&, bool, bool);
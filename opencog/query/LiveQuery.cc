@@ -0,0 +1,384 @@
+/*
+ * opencog/query/LiveQuery.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+
+#include <opencog/util/exceptions.h>
+#include <opencog/atoms/atom_types/NameServer.h>
+#include <opencog/atoms/pattern/PatternLink.h>
+#include <opencog/atoms/value/LinkValue.h>
+#include <opencog/atoms/value/QueueValue.h>
+#include <opencog/atoms/value/UnisetValue.h>
+#include <opencog/atomspace/AtomSpace.h>
+
+#include "Implicator.h"
+#include "LiveQuery.h"
+
+using namespace opencog;
+
+namespace {
+
+typedef std::vector<std::pair<HandleSeq, ValuePtr>> Found;
+
+/// An Implicator that reports each result together with the clause
+/// groundings it was made from, instead of placing it in a queue.
+class LiveImplicator : public Implicator
+{
+	Found& _found;
+
+public:
+	LiveImplicator(AtomSpace* as, ContainerValuePtr& cvp, Found& found) :
+		Implicator(as, cvp), _found(found) {}
+
+	virtual bool propose_grounding(const GroundingMap& var_soln,
+	                               const GroundingMap& term_soln)
+	{
+		LOCK_PE_MUTEX;
+		HandleSeq key;
+		for (const PatternTermPtr& cl : _pattern->pmandatory)
+		{
+			auto it = term_soln.find(cl->getQuote());
+			if (term_soln.end() != it) key.push_back(it->second);
+		}
+
+		ValuePtr v(instantiate_implicand(var_soln));
+		if (nullptr == v) return false;
+		if (v->is_atom())
+			v = RewriteMixin::_as->add_atom(HandleCast(v));
+		_found.emplace_back(std::move(key), std::move(v));
+		return false;
+	}
+
+	// Neighborhood searches run on the change-feed thread. Threads of
+	// the SearchPool adding results would wait on that same thread,
+	// if the feed were full; so these run on this thread only.
+	virtual bool thread_safe(void) { return _seeds.empty(); }
+};
+
+/// Only connected QueryLinks, whose clauses are all to be found in
+/// the AtomSpace, can be kept up to date by looking at the changes.
+bool can_increment(const Handle& query)
+{
+	if (not nameserver().isA(query->get_type(), QUERY_LINK))
+		return false;
+
+	PatternLinkPtr jit(PatternLinkCast(query)->jit_analyze());
+	if (1 < jit->get_components().size()) return false;
+	if (0 < jit->get_virtual().size()) return false;
+
+	const Pattern& pat = jit->get_pattern();
+	if (pat.pmandatory.empty()) return false;
+	if (not pat.absents.empty() or not pat.always.empty() or
+	    not pat.grouping.empty())
+		return false;
+
+	for (const PatternTermPtr& cl : pat.pmandatory)
+	{
+		if (cl->hasAnyEvaluatable() or cl->isIdentical() or
+		    cl->isChoice() or cl->isBoundVariable() or cl->isGlobbyVar())
+			return false;
+	}
+	return true;
+}
+
+} // namespace
+
+// ================================================================
+
+LiveQuery::LiveQuery(AtomSpace* as, const Handle& query, const Handle& key) :
+	_as(as), _query(query), _key(key), _sub(0), _ready(false),
+	_full_runs(0), _delta_runs(0)
+{
+	if (not nameserver().isA(query->get_type(), PATTERN_LINK))
+	{
+		const std::string& tname = nameserver().getTypeName(query->get_type());
+		throw InvalidParamException(TRACE_INFO,
+			"Expecting a PatternLink, got %s", tname.c_str());
+	}
+
+	_incremental = can_increment(query);
+	if (_incremental)
+	{
+		PatternLinkPtr jit(PatternLinkCast(query)->jit_analyze());
+		for (const PatternTermPtr& cl : jit->get_pattern().pmandatory)
+		{
+			Type t = cl->getHandle()->get_type();
+			if (_clause_types.end() ==
+			    std::find(_clause_types.begin(), _clause_types.end(), t))
+				_clause_types.push_back(t);
+		}
+	}
+
+	// Subscribe first, so that nothing is missed. Changes that come
+	// in during the first search are held until it is done.
+	_sub = _as->subscribe_changes(FeedFilter(),
+		[this](const std::vector<AtomEvent>& evs) { changed(evs); });
+
+	full_run();
+
+	// Setting the results sends a change down the feed; the held
+	// changes are looked at when it arrives.
+	{
+		std::lock_guard<std::mutex> lck(_mtx);
+		_ready = true;
+	}
+	publish();
+}
+
+LiveQuery::~LiveQuery()
+{
+	_as->unsubscribe_changes(_sub);
+}
+
+ValuePtr LiveQuery::get_results(void) const
+{
+	std::lock_guard<std::mutex> lck(_mtx);
+	ValueSeq vals;
+	for (const auto& pr : _results)
+		vals.push_back(pr.first);
+	return createUnisetValue(vals);
+}
+
+void LiveQuery::flush(void)
+{
+	_as->flush_changes();
+}
+
+// ================================================================
+
+/// Run the query; from the seeds only, if there are any.
+LiveQuery::Found LiveQuery::search(const HandleSeq& seeds)
+{
+	Found found;
+	ContainerValuePtr cvp(createQueueValue());
+	LiveImplicator impl(_as, cvp, found);
+	impl.set_seeds(seeds);
+	impl.satisfy(PatternLinkCast(_query));
+	return found;
+}
+
+void LiveQuery::full_run(void)
+{
+	_full_runs++;
+
+	if (_incremental)
+	{
+		Found found(search(HandleSeq()));
+
+		std::lock_guard<std::mutex> lck(_mtx);
+		_support.clear();
+		_uses.clear();
+		_results.clear();
+		for (const auto& pr : found)
+			record(pr.first, pr.second);
+		return;
+	}
+
+	ValuePtr vp(_query->execute(_as));
+	ValueSeq vals;
+	if (vp and vp->is_type(LINK_VALUE))
+		vals = LinkValueCast(vp)->value();
+	else if (vp)
+		vals.push_back(vp);
+
+	// The events for the atoms added by this run come later; they
+	// are only handed out after this returns, or after `_ready` is set.
+	std::lock_guard<std::mutex> lck(_mtx);
+	_results.clear();
+	for (const ValuePtr& v : vals)
+	{
+		add_result(v);
+		if (v->is_atom()) _own.insert(HandleCast(v));
+	}
+}
+
+void LiveQuery::delta_run(const HandleSeq& seeds)
+{
+	_delta_runs++;
+	Found found(search(seeds));
+
+	std::lock_guard<std::mutex> lck(_mtx);
+	for (const auto& pr : found)
+		record(pr.first, pr.second);
+}
+
+// ================================================================
+
+/// Keep a grounding, unless it is already kept, or some of the atoms
+/// it was made from have gone since it was found.
+void LiveQuery::record(const HandleSeq& key, const ValuePtr& result)
+{
+	if (_support.end() != _support.find(key)) return;
+	for (const Handle& h : key)
+		if (nullptr == _as->get_atom(h)) return;
+
+	auto it = _support.emplace(key, result).first;
+	for (size_t i = 0; i < key.size(); i++)
+	{
+		// An atom can ground more than one clause.
+		if (std::find(key.begin(), key.begin() + i, key[i]) !=
+		    key.begin() + i) continue;
+		_uses.emplace(key[i], &it->first);
+	}
+	add_result(result);
+}
+
+/// Drop the groundings that `gone` took part in. Returns true if
+/// there were any.
+bool LiveQuery::retract(const Handle& gone)
+{
+	auto range = _uses.equal_range(gone);
+	if (range.first == range.second) return false;
+
+	std::vector<HandleSeq> keys;
+	for (auto it = range.first; it != range.second; it++)
+		keys.push_back(*it->second);
+	_uses.erase(range.first, range.second);
+
+	for (const HandleSeq& key : keys)
+	{
+		auto sit = _support.find(key);
+		if (_support.end() == sit) continue;
+
+		for (const Handle& h : key)
+		{
+			auto other = _uses.equal_range(h);
+			for (auto it = other.first; it != other.second; )
+			{
+				if (it->second == &sit->first) it = _uses.erase(it);
+				else it++;
+			}
+		}
+		ValuePtr result(sit->second);
+		_support.erase(sit);
+		drop_result(result);
+	}
+	return true;
+}
+
+void LiveQuery::add_result(const ValuePtr& v)
+{
+	_results[v]++;
+}
+
+void LiveQuery::drop_result(const ValuePtr& v)
+{
+	auto it = _results.find(v);
+	if (_results.end() == it) return;
+	if (0 == --it->second) _results.erase(it);
+}
+
+void LiveQuery::publish(void)
+{
+	_as->set_value(_query, _key, get_results());
+}
+
+// ================================================================
+
+void LiveQuery::changed(const std::vector<AtomEvent>& evs)
+{
+	std::vector<AtomEvent> batch;
+	{
+		std::lock_guard<std::mutex> lck(_mtx);
+		if (not _ready)
+		{
+			_pending.insert(_pending.end(), evs.begin(), evs.end());
+			return;
+		}
+		batch.swap(_pending);
+	}
+	batch.insert(batch.end(), evs.begin(), evs.end());
+
+	// The events lag behind the AtomSpace; by now, an added atom may
+	// have been extracted again, or the other way around. So look at
+	// what is there now, rather than at the order of the events.
+	HandleSeq seeds;
+	bool rerun = false;
+	bool dropped = false;
+	for (const AtomEvent& ev : batch)
+	{
+		switch (ev.kind)
+		{
+			case AtomEvent::ADD:
+			{
+				// Results of our own full run, coming back to us. A
+				// result that was there before the run sends no ADD;
+				// if it is extracted and added again, the EXTRACT has
+				// forgotten it by then.
+				if (not _incremental)
+				{
+					std::lock_guard<std::mutex> lck(_mtx);
+					if (0 == _own.erase(ev.atom)) rerun = true;
+					break;
+				}
+
+				// Results are searched from, like any other atom; they
+				// might ground a clause.
+				Type t = ev.atom->get_type();
+				if (_clause_types.end() ==
+				    std::find(_clause_types.begin(), _clause_types.end(), t))
+					break;
+				if (_as->get_atom(ev.atom)) seeds.push_back(ev.atom);
+				break;
+			}
+			case AtomEvent::EXTRACT:
+			{
+				if (not _incremental)
+				{
+					std::lock_guard<std::mutex> lck(_mtx);
+					_own.erase(ev.atom);
+					rerun = true;
+					break;
+				}
+				if (_as->get_atom(ev.atom)) break;
+				std::lock_guard<std::mutex> lck(_mtx);
+				dropped |= retract(ev.atom);
+				break;
+			}
+			case AtomEvent::VALUE:
+			{
+				// Our own results, being published. Evaluatable clauses
+				// might look at any other value.
+				if (ev.atom == _query and ev.key == _key) break;
+				if (not _incremental) rerun = true;
+				break;
+			}
+			case AtomEvent::CLEAR:
+			{
+				std::lock_guard<std::mutex> lck(_mtx);
+				_own.clear();
+				rerun = true;
+				break;
+			}
+		}
+	}
+
+	if (rerun)
+		full_run();
+	else if (not seeds.empty())
+		delta_run(seeds);
+	else if (not dropped)
+		return;
+
+	publish();
+}
+
+/* ===================== END OF FILE ===================== */
@@ -0,0 +1,135 @@
+/*
+ * opencog/query/LiveQuery.h
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_LIVE_QUERY_H
+#define _OPENCOG_LIVE_QUERY_H
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <opencog/atoms/base/Handle.h>
+#include <opencog/atoms/value/Value.h>
+#include <opencog/atomspace/ChangeFeed.h>
+
+namespace opencog {
+
+class AtomSpace;
+
+/**
+ * The results of a query, kept up to date as the AtomSpace changes.
+ *
+ * The query is run once, in full. After that, the AtomSpace change
+ * feed (see ChangeFeed.h) reports the atoms that are added and
+ * extracted. For an added atom, only its neighborhood is searched:
+ * it is offered to the engine as the grounding of each clause it
+ * might ground. For an extracted atom, the results that were made
+ * from groundings holding it are dropped. Thus, the cost of keeping
+ * the results is proportional to the size of the change, and not to
+ * the size of the AtomSpace. The results are added to the AtomSpace,
+ * and are searched from in the same way; a rewrite that grounds its
+ * own pattern is followed until it gives nothing new.
+ *
+ * This works for a QueryLink whose clauses are all found in the
+ * AtomSpace, and are connected. Queries with evaluatable, absent,
+ * always or grouping clauses, or with several components, and other
+ * kinds of PatternLinks, are run again in full, after each batch of
+ * changes; this is still cheaper than having each reader run them.
+ * The atoms added by such a run do not cause it to be run again.
+ *
+ * The results are kept as a closed UnisetValue, placed on the query
+ * at the given key; a new UnisetValue replaces the old, each time the
+ * results change. The changes are seen by subscribers to the feed.
+ *
+ * Changes are applied on the thread of the change feed, in the order
+ * in which they were made; the results lag behind the AtomSpace. Use
+ * `flush()` to wait for them to catch up.
+ */
+class LiveQuery
+{
+	AtomSpace* _as;
+	Handle _query;
+	Handle _key;
+	bool _incremental;
+	uint64_t _sub;
+
+	mutable std::mutex _mtx;
+
+	// Changes that came in before the first search was done.
+	bool _ready;
+	std::vector<AtomEvent> _pending;
+
+	// The clause groundings of each grounding found, and the result
+	// made from it. The results are counted; several groundings can
+	// give the same result.
+	std::map<HandleSeq, ValuePtr> _support;
+	std::unordered_multimap<Handle, const HandleSeq*> _uses;
+	std::map<ValuePtr, size_t> _results;
+
+	// Atoms that the last full runs gave as results, when these are
+	// not incremental. Their ADD events, if any, were caused by those
+	// runs, and do not call for another one.
+	std::unordered_set<Handle> _own;
+
+	// Types of the clauses; only atoms of these types can ground
+	// a clause.
+	std::vector<Type> _clause_types;
+
+	std::atomic<size_t> _full_runs;
+	std::atomic<size_t> _delta_runs;
+
+	typedef std::vector<std::pair<HandleSeq, ValuePtr>> Found;
+	Found search(const HandleSeq&);
+	void full_run(void);
+	void delta_run(const HandleSeq&);
+	void record(const HandleSeq&, const ValuePtr&);
+	bool retract(const Handle&);
+	void add_result(const ValuePtr&);
+	void drop_result(const ValuePtr&);
+	void publish(void);
+	void changed(const std::vector<AtomEvent>&);
+
+public:
+	LiveQuery(AtomSpace*, const Handle& query, const Handle& key);
+	~LiveQuery();
+
+	/// The current results, as a closed UnisetValue.
+	ValuePtr get_results(void) const;
+
+	/// True if changes are handled by searching the neighborhoods of
+	/// the changed atoms; false if the query is run again in full.
+	bool is_incremental(void) const { return _incremental; }
+
+	/// Wait until the changes made so far are in the results. Must
+	/// not be called from a change-feed callback.
+	void flush(void);
+
+	/// Number of full searches, and of neighborhood searches, so far.
+	size_t get_full_runs(void) const { return _full_runs; }
+	size_t get_delta_runs(void) const { return _delta_runs; }
+};
+
+} // namespace opencog
+
+#endif // _OPENCOG_LIVE_QUERY_H
@@ -41,13 +41,15 @@ using namespace opencog;
 
 void InitiateSearchMixin::push(void)
 {
-	_issued_stack.push(_issued);
+	ClauseState& st(cs());
+	st.issued_stack.push(st.issued);
 }
 
 void InitiateSearchMixin::pop(void)
 {
-	_issued = _issued_stack.top();
-	_issued_stack.pop();
+	ClauseState& st(cs());
+	st.issued = st.issued_stack.top();
+	st.issued_stack.pop();
 }
 
 /**
@@ -84,29 +86,31 @@ void InitiateSearchMixin::pop(void)
 bool InitiateSearchMixin::get_next_clause(PatternTermPtr& clause,
                                           PatternTermPtr& joint)
 {
-	if (0 == _next_choices.size())
+	ClauseState& st(cs());
+	if (0 == st.next_choices.size())
 	{
-		if (0 < _choice_stack.size())
+		if (0 < st.choice_stack.size())
 		{
-			_next_choices = _choice_stack.top();
-			_choice_stack.pop();
+			st.next_choices = st.choice_stack.top();
+			st.choice_stack.pop();
 		}
 		return false;
 	}
 
-	const Choice& ch(_next_choices.back());
+	const Choice& ch(st.next_choices.back());
 	clause = ch.clause;
 	joint = ch.start_term;
-	_next_choices.pop_back();
+	st.next_choices.pop_back();
 
-	_issued.insert(clause);
+	st.issued.insert(clause);
 	return true;
 }
 
 void InitiateSearchMixin::next_connections(const GroundingMap& var_grounding)
 {
-	_choice_stack.push(_next_choices);
-	_next_choices.clear();
+	ClauseState& st(cs());
+	st.choice_stack.push(st.next_choices);
+	st.next_choices.clear();
 
 	// First, try to ground all the mandatory clauses, only.
 	// no virtuals, no black boxes, no absents.
@@ -132,7 +136,7 @@ void InitiateSearchMixin::next_connections(const GroundingMap& var_grounding)
 	// All variables must necessarily be grounded at this point.
 	for (const PatternTermPtr& root : _pattern->always)
 	{
-		if (_issued.end() != _issued.find(root)) continue;
+		if (st.issued.end() != st.issued.find(root)) continue;
 		for (const Handle &v : _variables->varset)
 		{
 			if (is_free_in_tree(root->getHandle(), v))
@@ -140,7 +144,7 @@ void InitiateSearchMixin::next_connections(const GroundingMap& var_grounding)
 				Choice ch;
 				ch.clause = root;
 				ch.start_term = term_of_handle(v, root);
-				_next_choices.emplace_back(ch);
+				st.next_choices.emplace_back(ch);
 				return;
 			}
 		}
@@ -150,7 +154,7 @@ void InitiateSearchMixin::next_connections(const GroundingMap& var_grounding)
 	// Make sure all clauses have been grounded.
 	for (const PatternTermPtr& root : _pattern->pmandatory)
 	{
-		if (_issued.end() == _issued.find(root))
+		if (st.issued.end() == st.issued.find(root))
 			throw RuntimeException(TRACE_INFO,
 				"BUG! Still have ungrounded clauses!!");
 	}
@@ -164,11 +168,8 @@ void InitiateSearchMixin::next_connections(const GroundingMap& var_grounding)
 // can be done in a direct fashion; it resembles the concept of
 // "unit propagation" in the DPLL algorithm.
 //
-// XXX TODO ... Rather than counting the number of variables, we
-// should instead look for one with the smallest incoming set.
-// That is because the very next thing that we do will be to
-// iterate over the incoming set of "pursue" ... so it could be
-// a huge pay-off to minimize this.
+// This is only a tie-breaker; the size of the incoming set of
+// "pursue" is looked at first. See get_next_thinnest_clause().
 //
 // If there are two ungrounded variables in a clause, then the
 // "thickness" is the *product* of the sizes of the two incoming
@@ -204,6 +205,7 @@ unsigned int InitiateSearchMixin::thickness(const PatternTermPtr& clause,
 Handle InitiateSearchMixin::get_glob_embedding(const GroundingMap& var_grounding,
                                                const Handle& glob)
 {
+	ClauseState& st(cs());
 	// If the glob is in only one clause, there is no connectivity map.
 	if (0 == _pattern->connectivity_map.count(glob)) return glob;
 
@@ -216,7 +218,7 @@ Handle InitiateSearchMixin::get_glob_embedding(const GroundingMap& var_grounding
 	auto clpr = clauses.first;
 	for (; clpr != clauses.second; clpr++)
 	{
-		if (_issued.end() == _issued.find(clpr->second)) break;
+		if (st.issued.end() == st.issued.find(clpr->second)) break;
 	}
 
 	// Glob is not in any ungrounded clauses.
@@ -258,14 +260,13 @@ bool InitiateSearchMixin::get_next_thinnest_clause(const GroundingMap& var_groun
                                                    bool search_eval,
                                                    bool search_absents)
 {
+	ClauseState& st(cs());
 	// Make a list of the as-yet ungrounded variables.
 	HandleSet ungrounded_vars;
 
-	// Grounded variables ordered by the size of their grounding
-	// incoming set. Ideally, we should look only at the incoming
-	// set that matches the type of the parent term. But for now,
-	// this simpler code is good enough. XXX FIXME someday?
-	std::multimap<std::size_t, Handle> thick_vars;
+	// Grounded variables, paired with their groundings. Globs are
+	// replaced by the grounded terms they are embedded in.
+	std::vector<std::pair<Handle, Handle>> joints;
 
 	for (const Handle &v : _variables->varset)
 	{
@@ -279,15 +280,10 @@ bool InitiateSearchMixin::get_next_thinnest_clause(const GroundingMap& var_groun
 			if (GLOB_NODE == v->get_type())
 			{
 				Handle embed = get_glob_embedding(var_grounding, v);
-				const Handle& tg = var_grounding.find(embed)->second;
-				std::size_t incoming_set_size = tg->getIncomingSetSize();
-				thick_vars.insert(std::make_pair(incoming_set_size, embed));
+				joints.push_back({embed, var_grounding.find(embed)->second});
 			}
 			else
-			{
-				std::size_t incoming_set_size = gnd->second->getIncomingSetSize();
-				thick_vars.insert(std::make_pair(incoming_set_size, v));
-			}
+				joints.push_back({v, gnd->second});
 		}
 		else ungrounded_vars.insert(v);
 	}
@@ -299,42 +295,62 @@ bool InitiateSearchMixin::get_next_thinnest_clause(const GroundingMap& var_groun
 	// the root is grounded.  If its not, start working on that.
 	Handle joint(Handle::UNDEFINED);
 	PatternTermPtr unsolved_clause(PatternTerm::UNDEFINED);
-	unsigned int thinnest_joint = UINT_MAX;
+	size_t thinnest_joint = SIZE_MAX;
+	size_t best_rank = SIZE_MAX;
 	unsigned int thinnest_clause = UINT_MAX;
 	bool unsolved = false;
 
 	// We are looking for a joining atom, one that is shared in common
 	// with the a fully grounded clause, and an as-yet ungrounded clause.
 	// The joint is called "pursue", and the unsolved clause that it
-	// joins will become our next untried clause. We choose joining atom
-	// with smallest size of its incoming set. If there are many such
-	// atoms we choose one from clauses with minimal number of ungrounded
-	// yet variables.
-	for (const auto& tckvar : thick_vars)
+	// joins will become our next untried clause. The engine will walk
+	// upwards from the grounding of the joint, through the Links of
+	// the type of the term holding the joint in that clause; so we
+	// pick the joint and clause for which there are the fewest such
+	// Links. Ties go to the order planned by find_thinnest(), and
+	// then to the clause with the fewest ungrounded variables.
+	for (const auto& jnt : joints)
 	{
-		std::size_t pursue_thickness = tckvar.first;
-		const Handle& pursue = tckvar.second;
-
-		if (pursue_thickness > thinnest_joint) break;
+		const Handle& pursue = jnt.first;
+		const Handle& gnd = jnt.second;
 
 		const auto& root_list = _pattern->connectivity_map.equal_range(pursue);
 		for (auto it = root_list.first; it != root_list.second; it++)
 		{
 			const PatternTermPtr& root = it->second;
-			if ((_issued.end() == _issued.find(root))
-			     and (search_eval or not root->hasAnyEvaluatable())
-			     and (search_absents or not root->isAbsent()))
+			if ((st.issued.end() != st.issued.find(root))
+			     or (not search_eval and root->hasAnyEvaluatable())
+			     or (not search_absents and root->isAbsent()))
+				continue;
+
+			size_t width = SIZE_MAX;
+			const auto& tit = _pattern->connected_terms_map.find({pursue, root});
+			if (_pattern->connected_terms_map.end() != tit)
 			{
-				unsigned int root_thickness = thickness(root, ungrounded_vars);
-				if (root_thickness < thinnest_clause)
-				{
-					thinnest_clause = root_thickness;
-					thinnest_joint = pursue_thickness;
-					unsolved_clause = root;
-					joint = pursue;
-					unsolved = true;
-				}
+				const PatternTermPtr& parent = tit->second[0]->getParent();
+				if (parent and parent->getHandle() and not parent->isChoice())
+					width = gnd->getIncomingSetSizeByType(
+						parent->getHandle()->get_type());
 			}
+			if (SIZE_MAX == width) width = gnd->getIncomingSetSize();
+			if (thinnest_joint < width) continue;
+
+			size_t rank = SIZE_MAX;
+			const auto& rit = _plan_rank.find(root);
+			if (_plan_rank.end() != rit) rank = rit->second;
+			if (width == thinnest_joint and best_rank < rank) continue;
+
+			unsigned int root_thickness = thickness(root, ungrounded_vars);
+			if (width == thinnest_joint and rank == best_rank
+			    and thinnest_clause <= root_thickness)
+				continue;
+
+			thinnest_joint = width;
+			best_rank = rank;
+			thinnest_clause = root_thickness;
+			unsolved_clause = root;
+			joint = pursue;
+			unsolved = true;
 		}
 	}
 
@@ -346,7 +362,7 @@ bool InitiateSearchMixin::get_next_thinnest_clause(const GroundingMap& var_groun
 	{
 		for (const PatternTermPtr& root : _pattern->pmandatory)
 		{
-			if (_issued.end() != _issued.find(root)) continue;
+			if (st.issued.end() != st.issued.find(root)) continue;
 
 			// Clauses with no variables are (by definition)
 			// evaluatable. So we don't check if they're evaluatable.
@@ -356,7 +372,7 @@ bool InitiateSearchMixin::get_next_thinnest_clause(const GroundingMap& var_groun
 				Choice ch;
 				ch.clause = root;
 				ch.start_term = root;
-				_next_choices.emplace_back(ch);
+				st.next_choices.emplace_back(ch);
 				return true;
 			}
 		}
@@ -373,11 +389,11 @@ bool InitiateSearchMixin::get_next_thinnest_clause(const GroundingMap& var_groun
 			Choice ch;
 			ch.clause = unsolved_clause;
 			ch.start_term = term_of_handle(joint, alt);
-			_next_choices.emplace_back(ch);
+			st.next_choices.emplace_back(ch);
 		}
 
 		// Special case.
-		_issued.insert(unsolved_clause);
+		st.issued.insert(unsolved_clause);
 	}
 	else
 	{
@@ -387,7 +403,7 @@ bool InitiateSearchMixin::get_next_thinnest_clause(const GroundingMap& var_groun
 			Choice ch;
 			ch.clause = unsolved_clause;
 			ch.start_term = stm;
-			_next_choices.emplace_back(ch);
+			st.next_choices.emplace_back(ch);
 		}
 	}
 	return true;
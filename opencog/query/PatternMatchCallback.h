@@ -25,6 +25,7 @@
 #define _OPENCOG_PATTERN_MATCH_CALLBACK_H
 
 #include <map>
+#include <mutex>
 #include <set>
 #include <opencog/atoms/base/Handle.h>
 #include <opencog/atoms/base/Link.h>
@@ -409,18 +410,34 @@ class PatternMatchCallback
 		 * You get to call this, to perform the actual search.
 		 */
 		virtual bool satisfy(const PatternLinkPtr&) = 0;
+
+		/**
+		 * Return true if this callback can be used from several
+		 * threads at once, so that large searches can be spread over
+		 * the SearchPool. All of the above callbacks may then be
+		 * called concurrently, except for `start_search()`,
+		 * `perform_search()`, `search_finished()` and `set_pattern()`.
+		 * Any state kept during the search must then be kept per
+		 * thread, in between `worker_start()` and `worker_end()`,
+		 * and solutions must be recorded under a lock. See
+		 * `InitiateSearchMixin::search_loop()`.
+		 */
+		virtual bool thread_safe(void) { return false; }
+
+		/**
+		 * Called in each thread taking part in a parallel search,
+		 * before and after its share of the search. The `worker_end()`
+		 * calls are serialized; they may fold per-thread state back
+		 * into the shared state.
+		 */
+		virtual void worker_start(void) {}
+		virtual void worker_end(void) {}
 };
 
-// See notes in `InitiateSearchMixin.cc` for an explanation of the
-// threading code and its status.
-// #define USE_THREADED_PATTERN_ENGINE
-#ifdef USE_THREADED_PATTERN_ENGINE
-	#define DECLARE_PE_MUTEX std::mutex _mtx;
-	#define LOCK_PE_MUTEX std::lock_guard<std::mutex> lck(_mtx);
-#else
-	#define DECLARE_PE_MUTEX
-	#define LOCK_PE_MUTEX
-#endif // USE_THREADED_PATTERN_ENGINE
+// Solutions may be proposed from several threads at once; see
+// `thread_safe()` above.
+#define DECLARE_PE_MUTEX std::mutex _mtx;
+#define LOCK_PE_MUTEX std::lock_guard<std::mutex> lck(_mtx);
 
 } // namespace opencog
 
@@ -57,6 +57,10 @@ using namespace opencog;
 #define DO_LOG(STUFF)
 #endif
 
+// Count some work against the current clause, if profiling.
+// See QueryProfile.h
+#define PROF_COUNT(FIELD) if (_profile) _counts->FIELD++
+
 
 #ifdef QDEBUG
 static inline void logmsg(const char * msg, const Handle& h)
@@ -662,6 +666,7 @@ bool PatternMatchEngine::unorder_compare(const PatternTermPtr& ptm,
 		              << " for term=" << ptm->to_string();})
 
 take_next_step:
+		PROF_COUNT(permutations);
 		_perm_take_step = false; // we are taking the step, so clear the flag.
 		_perm_have_more = false; // start with a clean slate...
 		solution_pop();
@@ -901,6 +906,8 @@ bool PatternMatchEngine::glob_compare(const PatternTermSeq& osp,
 
 	while (ip<osp_size)
 	{
+		PROF_COUNT(glob_steps);
+
 		// Reject if no more backtracking is possible.
 		if (cannot_backtrack_anymore)
 		{
@@ -1487,6 +1494,7 @@ bool PatternMatchEngine::tree_compare(const PatternTermPtr& ptm,
                                       const Handle& hg,
                                       Caller caller)
 {
+	PROF_COUNT(compares);
 	const Handle& hp = ptm->getHandle();
 
 	// Do we already have a grounding for this? If we do, and the
@@ -2949,6 +2957,7 @@ bool PatternMatchEngine::explore_clause_evaluatable(const PatternTermPtr& term,
                                                     const Handle& grnd,
                                                     const PatternTermPtr& clause)
 {
+	PROF_COUNT(evaluations);
 	logmsg("Clause is evaluatable; start evaluating it");
 
 	// Some people like to have a clause that is just one big
@@ -3105,9 +3114,9 @@ bool PatternMatchEngine::explore_clause_identical(const PatternTermPtr& term,
  * and would become effective only for large, complex searches, of
  * which I haven't seen any good examples of, yet.
  */
-bool PatternMatchEngine::explore_clause(const PatternTermPtr& term,
-                                        const Handle& grnd,
-                                        const PatternTermPtr& pclause)
+bool PatternMatchEngine::explore_clause_cached(const PatternTermPtr& term,
+                                               const Handle& grnd,
+                                               const PatternTermPtr& pclause)
 {
 	// The two sides of an identity can be equated directly.
 	if (pclause->isIdentical())
@@ -3194,6 +3203,24 @@ bool PatternMatchEngine::explore_clause(const PatternTermPtr& term,
 	return okay;
 }
 
+/// Explore the clause, counting the work done for it, when profiling.
+/// The work done for the clauses after it is counted against those.
+bool PatternMatchEngine::explore_clause(const PatternTermPtr& term,
+                                        const Handle& grnd,
+                                        const PatternTermPtr& pclause)
+{
+	if (nullptr == _profile)
+		return explore_clause_cached(term, grnd, pclause);
+
+	QueryProfile::Counts* outer = _counts;
+	_counts = &_clause_counts[pclause];
+	_counts->candidates++;
+	bool found = explore_clause_cached(term, grnd, pclause);
+	if (not found) _counts->backtracks++;
+	_counts = outer;
+	return found;
+}
+
 void PatternMatchEngine::record_grounding(const PatternTermPtr& ptm,
                                           const Handle& hg)
 {
@@ -3271,8 +3298,13 @@ PatternMatchEngine::PatternMatchEngine(PatternMatchCallback& pmcb)
 	_nameserver(nameserver()),
 	_variables(nullptr),
 	_pat(nullptr),
-	clause_accepted(false)
+	clause_accepted(false),
+	_profile(QueryProfile::active()),
+	_counts(nullptr)
 {
+	// Work done outside of any clause is counted here.
+	if (_profile) _counts = &_clause_counts[nullptr];
+
 	// current state
 	depth = 0;
 
@@ -3294,6 +3326,11 @@ PatternMatchEngine::PatternMatchEngine(PatternMatchCallback& pmcb)
 	_perm_odo_state.clear();
 }
 
+PatternMatchEngine::~PatternMatchEngine()
+{
+	if (_profile) _profile->add_counts(_clause_counts);
+}
+
 void PatternMatchEngine::set_pattern(const Variables& v,
                                      const Pattern& p)
 {
@@ -32,6 +32,7 @@
 #include <opencog/atoms/atom_types/NameServer.h>
 #include <opencog/atoms/pattern/Pattern.h>
 #include <opencog/query/PatternMatchCallback.h>
+#include <opencog/query/QueryProfile.h>
 
 namespace opencog {
 
@@ -205,6 +206,13 @@ private:
 	std::unordered_map<HandleSeq, Handle> _gnd_cache;
 	std::unordered_set<HandleSeq> _nack_cache;
 
+	// Work counts, kept only when a QueryProfile is being recorded.
+	// `_counts` points at the counts of the clause being explored;
+	// it is null when there is no profile.
+	QueryProfile* _profile;
+	QueryProfile::ClauseCounts _clause_counts;
+	QueryProfile::Counts* _counts;
+
 	// -------------------------------------------
 	// Stack used to store current traversal state for a single
 	// clause. These are pushed when a clause is fully grounded,
@@ -277,6 +285,8 @@ private:
 	// See PatternMatchEngine.cc for descriptions
 	bool explore_clause(const PatternTermPtr&, const Handle&,
 	                    const PatternTermPtr&);
+	bool explore_clause_cached(const PatternTermPtr&, const Handle&,
+	                           const PatternTermPtr&);
 	bool explore_clause_direct(const PatternTermPtr&, const Handle&,
 	                           const PatternTermPtr&);
 	bool explore_clause_evaluatable(const PatternTermPtr&, const Handle&,
@@ -317,6 +327,7 @@ private:
 
 public:
 	PatternMatchEngine(PatternMatchCallback&);
+	~PatternMatchEngine();
 	void set_pattern(const Variables&, const Pattern&);
 
 	// Examine the locally connected neighborhood for possible
@@ -0,0 +1,154 @@
+/*
+ * opencog/query/QueryProfile.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <opencog/atoms/value/FloatValue.h>
+#include <opencog/atoms/value/LinkValue.h>
+#include <opencog/atoms/value/StringValue.h>
+
+#include "QueryProfile.h"
+
+using namespace opencog;
+
+static thread_local QueryProfile* active_profile = nullptr;
+
+void QueryProfile::Counts::add(const Counts& other)
+{
+	candidates += other.candidates;
+	compares += other.compares;
+	backtracks += other.backtracks;
+	permutations += other.permutations;
+	glob_steps += other.glob_steps;
+	evaluations += other.evaluations;
+}
+
+bool QueryProfile::Counts::empty(void) const
+{
+	return 0 == candidates and 0 == compares and 0 == backtracks and
+		0 == permutations and 0 == glob_steps and 0 == evaluations;
+}
+
+QueryProfile::Scope::Scope(QueryProfile& prof) :
+	_prev(exchange(&prof)),
+	_start(std::chrono::steady_clock::now()),
+	_prof(prof)
+{
+}
+
+QueryProfile::Scope::~Scope()
+{
+	auto end = std::chrono::steady_clock::now();
+	double secs = std::chrono::duration<double>(end - _start).count();
+	{
+		std::lock_guard<std::mutex> lck(_prof._mtx);
+		_prof._seconds += secs;
+	}
+	exchange(_prev);
+}
+
+QueryProfile* QueryProfile::active(void)
+{
+	return active_profile;
+}
+
+QueryProfile* QueryProfile::exchange(QueryProfile* prof)
+{
+	QueryProfile* prev = active_profile;
+	active_profile = prof;
+	return prev;
+}
+
+// ================================================================
+
+void QueryProfile::add_start(const Handle& clause, const Handle& term,
+                             size_t search_set)
+{
+	std::lock_guard<std::mutex> lck(_mtx);
+	_starts.push_back({clause, term, search_set});
+}
+
+void QueryProfile::add_counts(const ClauseCounts& counts)
+{
+	std::lock_guard<std::mutex> lck(_mtx);
+	for (const auto& pr : counts)
+	{
+		if (pr.second.empty()) continue;
+
+		// Work done outside of any clause is filed under the
+		// undefined handle.
+		Handle clause(pr.first ? pr.first->getQuote() : Handle::UNDEFINED);
+		auto it = _clauses.find(clause);
+		if (_clauses.end() == it)
+		{
+			it = _clauses.emplace(clause, Counts()).first;
+			_order.push_back(clause);
+		}
+		it->second.add(pr.second);
+	}
+}
+
+// ================================================================
+
+static ValuePtr kv(const std::string& key, const ValuePtr& val)
+{
+	return createLinkValue(ValueSeq({createStringValue(key), val}));
+}
+
+static ValuePtr number(size_t n)
+{
+	return createFloatValue((double) n);
+}
+
+ValuePtr QueryProfile::to_value(void) const
+{
+	std::lock_guard<std::mutex> lck(_mtx);
+
+	ValueSeq starts;
+	for (const Start& st : _starts)
+	{
+		ValueSeq kvp;
+		if (st.clause) kvp.push_back(kv("clause", st.clause));
+		if (st.term) kvp.push_back(kv("start-term", st.term));
+		kvp.push_back(kv("search-set", number(st.search_set)));
+		starts.push_back(createLinkValue(std::move(kvp)));
+	}
+
+	ValueSeq clauses;
+	for (const Handle& clause : _order)
+	{
+		const Counts& c = _clauses.at(clause);
+		ValueSeq kvp;
+		if (clause) kvp.push_back(kv("clause", clause));
+		kvp.push_back(kv("candidates", number(c.candidates)));
+		kvp.push_back(kv("tree-compares", number(c.compares)));
+		kvp.push_back(kv("backtracks", number(c.backtracks)));
+		kvp.push_back(kv("permutations", number(c.permutations)));
+		kvp.push_back(kv("glob-steps", number(c.glob_steps)));
+		kvp.push_back(kv("evaluations", number(c.evaluations)));
+		clauses.push_back(createLinkValue(std::move(kvp)));
+	}
+
+	return createLinkValue(ValueSeq({
+		kv("seconds", createFloatValue(_seconds)),
+		kv("starts", createLinkValue(std::move(starts))),
+		kv("clauses", createLinkValue(std::move(clauses)))}));
+}
+
+// ======================= END OF FILE =================
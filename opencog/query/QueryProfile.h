@@ -0,0 +1,111 @@
+/*
+ * opencog/query/QueryProfile.h
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_QUERY_PROFILE_H
+#define _OPENCOG_QUERY_PROFILE_H
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <opencog/atoms/base/Handle.h>
+#include <opencog/atoms/pattern/PatternTerm.h>
+#include <opencog/atoms/value/Value.h>
+
+namespace opencog {
+
+/**
+ * A record of what the pattern engine did during some searches: where
+ * each search started, and, for each clause, how much work went into
+ * grounding it. This is meant to answer the question "why is this
+ * query slow?" It is cheap enough to use on a live system: when no
+ * profile is being recorded, the engine only checks a null pointer.
+ *
+ * To record a profile, put a QueryProfile::Scope on the stack; every
+ * search started by this thread, until the Scope is gone, is recorded
+ * into the profile. Searches run in parallel (see SearchPool) are
+ * recorded as well.
+ *
+ * From scheme, use `cog-execute-profile!`.
+ */
+class QueryProfile
+{
+public:
+	/// Work done for one clause.
+	struct Counts
+	{
+		size_t candidates = 0;   // Proposed groundings explored.
+		size_t compares = 0;     // Calls to tree_compare().
+		size_t backtracks = 0;   // Candidates that did not work out.
+		size_t permutations = 0; // Unordered-link permutations stepped.
+		size_t glob_steps = 0;   // Steps taken by the glob matcher.
+		size_t evaluations = 0;  // Evaluatable clauses evaluated.
+
+		void add(const Counts&);
+		bool empty(void) const;
+	};
+	typedef std::map<PatternTermPtr, Counts> ClauseCounts;
+
+	/// Where a search loop started.
+	struct Start
+	{
+		Handle clause;
+		Handle term;
+		size_t search_set;
+	};
+
+	/// Records into a profile, for as long as it exists.
+	class Scope
+	{
+		QueryProfile* _prev;
+		std::chrono::steady_clock::time_point _start;
+		QueryProfile& _prof;
+	public:
+		Scope(QueryProfile&);
+		~Scope();
+	};
+
+	/// The profile being recorded by this thread, if any.
+	static QueryProfile* active(void);
+
+	/// Make `prof` the profile recorded by this thread, and return
+	/// the one that was, before.
+	static QueryProfile* exchange(QueryProfile* prof);
+
+	void add_start(const Handle& clause, const Handle& term, size_t);
+	void add_counts(const ClauseCounts&);
+
+	/// The profile, as a LinkValue of key-value pairs; each pair is a
+	/// LinkValue holding a StringValue key, followed by the value.
+	ValuePtr to_value(void) const;
+
+private:
+	mutable std::mutex _mtx;
+	double _seconds = 0.0;
+	std::vector<Start> _starts;
+	std::map<Handle, Counts> _clauses;
+	HandleSeq _order;  // Clauses, in the order first seen.
+};
+
+} // namespace opencog
+
+#endif // _OPENCOG_QUERY_PROFILE_H
@@ -84,30 +84,11 @@ void RewriteMixin::record_marginals(const GroundingMap& var_soln)
 }
 
 /**
- * This callback takes the reported grounding, runs it through the
- * instantiator, to create the implicand, and then records the result
- * in the `result_set`. Repeated solutions are skipped. If the number
- * of unique results so far is less than `max_results`, it then returns
- * false, to search for more groundings.  (The engine will halt its
- * search for a grounding once an acceptable one has been found; so,
- * to continue hunting for more, we return `false` here. We want to
- * find all possible groundings.)
+ * Run the grounding through the instantiator, to create the implicand.
+ * Returns nullptr if there is nothing to report.
  */
-bool RewriteMixin::propose_grounding(const GroundingMap& var_soln,
-                                     const GroundingMap& term_soln)
+ValuePtr RewriteMixin::instantiate_implicand(const GroundingMap& var_soln)
 {
-	LOCK_PE_MUTEX;
-	// PatternMatchEngine::print_solution(var_soln, term_soln);
-
-	// If we found as many as we want, then stop looking for more.
-	if (_num_results >= max_results)
-		return true;
-
-	_num_results ++;
-
-	// Record marginals for variables.
-	record_marginals(var_soln);
-
 	// Catch and ignore SilentExceptions. This arises when
 	// running with the URE, which creates ill-formed links
 	// (due to rules producing nothing). Ideally this should
@@ -128,27 +109,57 @@ bool RewriteMixin::propose_grounding(const GroundingMap& var_soln,
 				auto it = _implicand_grnds.find(_implicand[0]);
 				if (_implicand_grnds.end() != it)
 					(*it).second->add(v);
-				insert_result(v);
 			}
+			return v;
 		}
-		else
+
+		ValueSeq vs;
+		for (const Handle& himp: _implicand)
 		{
-			ValueSeq vs;
-			for (const Handle& himp: _implicand)
+			ValuePtr v(inst.instantiate(himp, var_soln, true));
+			if (nullptr != v)
 			{
-				ValuePtr v(inst.instantiate(himp, var_soln, true));
-				if (nullptr != v)
-				{
-					auto it = _implicand_grnds.find(himp);
-					if (_implicand_grnds.end() != it)
-						(*it).second->add(v);
-					vs.emplace_back(v);
-				}
+				auto it = _implicand_grnds.find(himp);
+				if (_implicand_grnds.end() != it)
+					(*it).second->add(v);
+				vs.emplace_back(v);
 			}
-			insert_result(createLinkValue(std::move(vs)));
 		}
+		return createLinkValue(std::move(vs));
 	} catch (const SilentException& ex) {}
 
+	return nullptr;
+}
+
+/**
+ * This callback takes the reported grounding, runs it through the
+ * instantiator, to create the implicand, and then records the result
+ * in the `result_set`. Repeated solutions are skipped. If the number
+ * of unique results so far is less than `max_results`, it then returns
+ * false, to search for more groundings.  (The engine will halt its
+ * search for a grounding once an acceptable one has been found; so,
+ * to continue hunting for more, we return `false` here. We want to
+ * find all possible groundings.)
+ */
+bool RewriteMixin::propose_grounding(const GroundingMap& var_soln,
+                                     const GroundingMap& term_soln)
+{
+	LOCK_PE_MUTEX;
+	// PatternMatchEngine::print_solution(var_soln, term_soln);
+
+	// If we found as many as we want, then stop looking for more.
+	if (_num_results >= max_results)
+		return true;
+
+	_num_results ++;
+
+	// Record marginals for variables.
+	record_marginals(var_soln);
+
+	ValuePtr v(instantiate_implicand(var_soln));
+	if (nullptr != v)
+		insert_result(v);
+
 	// If we found as many as we want, then stop looking for more.
 	return (_num_results >= max_results);
 }
@@ -168,6 +179,7 @@ bool RewriteMixin::propose_grouping(const GroundingMap &var_soln,
                                     const GroundingMap &term_soln,
                                     const GroundingMap &grouping)
 {
+	LOCK_PE_MUTEX;
 	// Do not accept new solution if maximum number has been already reached
 	if (_num_results >= max_results)
 		return true;
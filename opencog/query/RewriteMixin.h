@@ -75,6 +75,7 @@ class RewriteMixin :
 			_implicand = _plp->get_implicand();
 		}
 		void record_marginals(const GroundingMap&);
+		ValuePtr instantiate_implicand(const GroundingMap&);
 
 		size_t _num_results;
 		std::map<GroundingMap, ValueSet> _groups;
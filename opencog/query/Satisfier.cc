@@ -100,9 +100,9 @@ bool Satisfier::search_finished(bool done)
 	// only to handle the no-groundings case.
 	if (_result) return done;
 
-	// _optionals_present will be set to true if some optional clause
+	// optionals_present() will be true if some optional clause
 	// was grounded. Ergo, its not the no-grounding case.
-	if (_optionals_present) return done;
+	if (optionals_present()) return done;
 
 	// Multi-component patterns will not have distinct bodies.
 	// A failure to match one of the components is benign, and is
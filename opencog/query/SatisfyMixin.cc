@@ -129,6 +129,10 @@ class PMCGroundings : public SatisfyMixin
 			return _cb.search_finished(done);
 		}
 
+		bool thread_safe(void) { return _cb.thread_safe(); }
+		void worker_start(void) { _cb.worker_start(); }
+		void worker_end(void) { _cb.worker_end(); }
+
 		// This one we don't pass through. Instead, we collect the
 		// groundings.
 		bool propose_grounding(const GroundingMap &var_soln,
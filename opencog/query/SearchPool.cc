@@ -0,0 +1,288 @@
+/*
+ * opencog/query/SearchPool.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "SearchPool.h"
+
+using namespace opencog;
+
+// Largest number of candidates handed out at once. Kept small, so
+// that all threads stay busy until the very end. Each chunk costs
+// one uncontended lock.
+#define MAX_CHUNK 64
+
+// Search set size times clause count. A few tens of thousands of
+// candidates, for a typical pattern.
+#define DEFAULT_THRESHOLD 100000
+
+// Set on the pool threads, and on the calling thread while it takes
+// part in a Job. Jobs started from these run serially.
+static thread_local bool in_job = false;
+
+// ================================================================
+
+SearchPool::SearchPool(size_t nthreads, size_t threshold) :
+	_chunk(1), _generation(0), _active(0), _stop(false),
+	_job(nullptr), _found(false)
+{
+	if (0 == nthreads)
+		nthreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+	_nthreads = nthreads - 1;
+
+	if (0 == threshold) threshold = DEFAULT_THRESHOLD;
+	_threshold = threshold;
+
+	_ranges.reset(new Range[_nthreads + 1]);
+}
+
+SearchPool::~SearchPool()
+{
+	{
+		std::lock_guard<std::mutex> lck(_mtx);
+		_stop = true;
+	}
+	_wake.notify_all();
+	for (std::thread& th : _threads) th.join();
+}
+
+size_t SearchPool::env_threads(void)
+{
+	const char* env = getenv("OPENCOG_SEARCH_THREADS");
+	if (nullptr == env) return 0;
+	long n = atol(env);
+	if (n <= 0) return 0;
+	return n;
+}
+
+size_t SearchPool::env_threshold(void)
+{
+	const char* env = getenv("OPENCOG_PARALLEL_SEARCH_THRESHOLD");
+	if (nullptr == env) return 0;
+	long n = atol(env);
+	if (n <= 0) return 0;
+	return n;
+}
+
+// ================================================================
+
+bool SearchPool::serial(Job& job, size_t n)
+{
+	job.start(0);
+	bool found = false;
+	try
+	{
+		found = job.work(0, 0, n);
+	}
+	catch (...)
+	{
+		job.finish(0);
+		throw;
+	}
+	job.finish(0);
+	return found;
+}
+
+bool SearchPool::run(Job& job, size_t n)
+{
+	if (0 == n) return false;
+	if (0 == _nthreads or n < 2 or in_job or not _busy.try_lock())
+		return serial(job, n);
+
+	std::lock_guard<std::mutex> busy(_busy, std::adopt_lock);
+
+	// Start the threads, the first time through.
+	if (_threads.empty())
+	{
+		for (size_t i = 1; i <= _nthreads; i++)
+			_threads.push_back(std::thread(&SearchPool::worker, this, i));
+	}
+
+	// The workers are asleep; they will see all this once they
+	// grab the lock, below.
+	size_t nparts = _nthreads + 1;
+	_chunk = std::max<size_t>(1, std::min<size_t>(MAX_CHUNK, n / (8 * nparts)));
+	for (size_t i = 0; i < nparts; i++)
+	{
+		_ranges[i]._lo = n * i / nparts;
+		_ranges[i]._hi = n * (i+1) / nparts;
+	}
+	_found = false;
+	_error = nullptr;
+
+	{
+		std::lock_guard<std::mutex> lck(_mtx);
+		_job = &job;
+		_active = _nthreads;
+		_generation++;
+	}
+	_wake.notify_all();
+
+	in_job = true;
+	participate(0);
+	in_job = false;
+
+	{
+		std::unique_lock<std::mutex> lck(_mtx);
+		_done.wait(lck, [this]{ return 0 == _active; });
+		_job = nullptr;
+	}
+
+	std::exception_ptr err;
+	std::swap(err, _error);
+	if (err) std::rethrow_exception(err);
+	return _found;
+}
+
+void SearchPool::worker(size_t me)
+{
+	in_job = true;
+	uint64_t seen = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lck(_mtx);
+			_wake.wait(lck, [&]{ return _stop or seen != _generation; });
+			if (_stop) return;
+			seen = _generation;
+		}
+
+		participate(me);
+
+		std::lock_guard<std::mutex> lck(_mtx);
+		if (0 == --_active) _done.notify_all();
+	}
+}
+
+// ================================================================
+
+void SearchPool::participate(size_t me)
+{
+	Job& job = *_job;
+	try
+	{
+		job.start(me);
+	}
+	catch (...)
+	{
+		fail();
+		return;
+	}
+
+	try
+	{
+		size_t lo, hi;
+		while (not job.halted() and take(me, lo, hi))
+		{
+			if (job.work(me, lo, hi))
+			{
+				_found = true;
+				job._halt = true;
+			}
+		}
+	}
+	catch (...)
+	{
+		fail();
+	}
+
+	try
+	{
+		job.finish(me);
+	}
+	catch (...)
+	{
+		fail();
+	}
+}
+
+/// Record the exception being handled, if it is the first one,
+/// and halt the loop.
+void SearchPool::fail(void)
+{
+	std::lock_guard<std::mutex> lck(_mtx);
+	if (not _error) _error = std::current_exception();
+	_job->_halt = true;
+}
+
+/// Get the next chunk of work for thread `me`: from the front of its
+/// own range, if there is anything left there, else by stealing the
+/// back half of the range of some other thread. Returns false when
+/// all of the ranges are empty.
+bool SearchPool::take(size_t me, size_t& lo, size_t& hi)
+{
+	Range& mine = _ranges[me];
+	{
+		std::lock_guard<std::mutex> lck(mine._mtx);
+		if (mine._lo < mine._hi)
+		{
+			lo = mine._lo;
+			hi = std::min(mine._lo + _chunk, mine._hi);
+			mine._lo = hi;
+			return true;
+		}
+	}
+
+	size_t nparts = _nthreads + 1;
+	for (size_t i = 1; i < nparts; i++)
+	{
+		Range& victim = _ranges[(me + i) % nparts];
+		size_t slo, shi;
+		{
+			std::lock_guard<std::mutex> lck(victim._mtx);
+			if (victim._hi <= victim._lo) continue;
+
+			size_t left = victim._hi - victim._lo;
+			if (left <= _chunk)
+			{
+				lo = victim._lo;
+				hi = victim._hi;
+				victim._lo = victim._hi;
+				return true;
+			}
+			slo = victim._hi - left / 2;
+			shi = victim._hi;
+			victim._hi = slo;
+		}
+
+		// Keep the rest of the stolen half where others can steal
+		// it in turn.
+		lo = slo;
+		hi = std::min(slo + _chunk, shi);
+		std::lock_guard<std::mutex> lck(mine._mtx);
+		mine._lo = hi;
+		mine._hi = shi;
+		return true;
+	}
+	return false;
+}
+
+// ================================================================
+
+SearchPool& opencog::search_pool(void)
+{
+	static SearchPool* pool = new SearchPool(SearchPool::env_threads(),
+	                                         SearchPool::env_threshold());
+	return *pool;
+}
+
+// ======================= END OF FILE =================
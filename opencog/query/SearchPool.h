@@ -0,0 +1,161 @@
+/*
+ * opencog/query/SearchPool.h
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_SEARCH_POOL_H
+#define _OPENCOG_SEARCH_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace opencog {
+
+/**
+ * A pool of threads for running the outer loop of a pattern search
+ * in parallel.
+ *
+ * The threads are started once, and then sleep until there is work.
+ * Starting threads anew for each search costs far more than a small
+ * search does, so that was never worth it. Even so, a search is
+ * handed to the pool only when it is big enough; see
+ * `InitiateSearchMixin::search_loop()`.
+ *
+ * The index range of a Job is split evenly over the threads (the
+ * calling thread being one of them). Each thread takes small chunks
+ * off the front of its own range. A thread that runs out steals the
+ * back half of what some other thread has left. Thus, one candidate
+ * that takes far longer than the others does not hold up the rest.
+ *
+ * There is only one pool, and it runs one Job at a time. A Job
+ * started while the pool is busy, or from within a Job, runs in the
+ * calling thread only.
+ */
+class SearchPool
+{
+public:
+	/**
+	 * One parallel loop over the range [0, n). Each thread taking part
+	 * calls start() once, then work() on disjoint pieces of the range,
+	 * then finish() once. The thread argument numbers the threads from
+	 * zero, and is less than SearchPool::size().
+	 */
+	class Job
+	{
+		friend class SearchPool;
+		std::atomic<bool> _halt;
+
+	public:
+		Job(void) : _halt(false) {}
+		virtual ~Job() {}
+
+		virtual void start(size_t thread) {}
+
+		/// Return true to halt the whole loop.
+		virtual bool work(size_t thread, size_t begin, size_t end) = 0;
+
+		/// Called once start() has returned, even if work() threw.
+		virtual void finish(size_t thread) {}
+
+		/// True once some thread has halted the loop. Long-running
+		/// work() may poll this to quit early.
+		bool halted(void) const
+		{
+			return _halt.load(std::memory_order_relaxed);
+		}
+	};
+
+private:
+	struct alignas(64) Range
+	{
+		std::mutex _mtx;
+		size_t _lo = 0;
+		size_t _hi = 0;
+	};
+
+	size_t _nthreads;
+	std::atomic<size_t> _threshold;
+
+	std::vector<std::thread> _threads;
+	std::unique_ptr<Range[]> _ranges;
+	size_t _chunk;
+
+	// Guards the fields below.
+	std::mutex _mtx;
+	std::condition_variable _wake;
+	std::condition_variable _done;
+	uint64_t _generation;
+	size_t _active;
+	bool _stop;
+	Job* _job;
+
+	std::atomic<bool> _found;
+	std::exception_ptr _error;
+
+	// Held while a Job runs in parallel.
+	std::mutex _busy;
+
+	void worker(size_t);
+	void participate(size_t);
+	bool take(size_t, size_t&, size_t&);
+	void fail(void);
+	bool serial(Job&, size_t);
+
+public:
+	/// The thread count includes the calling thread; zero means one
+	/// per CPU. The threads are not started until the first Job is run.
+	SearchPool(size_t nthreads = 0, size_t threshold = 0);
+	~SearchPool();
+	SearchPool(const SearchPool&) = delete;
+	SearchPool& operator=(const SearchPool&) = delete;
+
+	/// Run the job over [0, n). Returns true if some call to work()
+	/// returned true. If a thread throws, the loop is halted, and the
+	/// first exception is rethrown here, after all threads are done.
+	bool run(Job&, size_t n);
+
+	/// Number of threads taking part in a Job, the caller included.
+	size_t size(void) const { return _nthreads + 1; }
+
+	/// Estimated cost of a search, below which it is not worth going
+	/// parallel. See `InitiateSearchMixin::search_loop()`.
+	size_t get_threshold(void) const { return _threshold; }
+	void set_threshold(size_t t) { _threshold = t; }
+
+	/// The thread count given by OPENCOG_SEARCH_THREADS, if it is set,
+	/// else zero, meaning "use the default". Set it to 1 to disable
+	/// parallel search.
+	static size_t env_threads(void);
+
+	/// The threshold given by OPENCOG_PARALLEL_SEARCH_THRESHOLD, if it
+	/// is set, else zero, meaning "use the default".
+	static size_t env_threshold(void);
+};
+
+/// The pool used by the pattern engine. Never destroyed.
+SearchPool& search_pool(void);
+
+} // namespace opencog
+
+#endif // _OPENCOG_SEARCH_POOL_H
@@ -0,0 +1,139 @@
+/*
+ * opencog/query/SearchStats.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <unordered_map>
+
+#include <opencog/atomspace/AtomSpace.h>
+
+#include "SearchStats.h"
+
+using namespace opencog;
+
+size_t SearchStats::Degrees::quantile(double q) const
+{
+	if (0 == nsamples) return 0;
+	size_t want = q * nsamples;
+	size_t seen = 0;
+	for (size_t k = 0; k < 32; k++)
+	{
+		seen += buckets[k];
+		if (want < seen) return ((size_t) 2) << k;
+	}
+	return SIZE_MAX;
+}
+
+/// Look at the first few Links of type `t` that the TypeIndex hands
+/// out. These come in hash order, which is as good as random here.
+SearchStats::Degrees
+SearchStats::sample(const AtomSpace* as, Type t, size_t pos, size_t nlinks)
+{
+	Degrees deg;
+	deg.nlinks = nlinks;
+	if (0 == nlinks) return deg;
+
+	HandleSeq links;
+	as->cursor_by_type(t)->next(links, SAMPLE_SIZE);
+
+	// Hubs turn up over and over; count each one only once. The
+	// count is over all frames; close enough.
+	std::unordered_map<Handle, size_t> seen;
+	double total = 0.0;
+	for (const Handle& l : links)
+	{
+		const HandleSeq& oset = l->getOutgoingSet();
+		size_t lo = 0;
+		size_t hi = oset.size();
+		if (ANY != pos)
+		{
+			if (hi <= pos) continue;
+			lo = pos;
+			hi = pos + 1;
+		}
+		for (size_t i = lo; i < hi; i++)
+		{
+			const Handle& h = oset[i];
+			auto it = seen.find(h);
+			if (seen.end() == it)
+				it = seen.emplace(h, h->getIncomingSetSizeByType(t)).first;
+			size_t d = it->second;
+			size_t k = 0;
+			while (k < 31 and (((size_t) 2) << k) <= d) k++;
+			deg.buckets[k]++;
+			deg.nsamples++;
+			total += d;
+		}
+	}
+
+	if (0 < deg.nsamples) deg.mean = total / deg.nsamples;
+	return deg;
+}
+
+SearchStats::Degrees
+SearchStats::degrees(const AtomSpace* as, Type t, size_t pos)
+{
+	if (nullptr == as) return Degrees();
+
+	// Counting is cheap; it is kept up to date by the TypeIndex.
+	size_t nlinks = as->get_num_atoms_of_type(t);
+
+	auto key = std::make_tuple(as->get_uuid(), t, pos);
+	{
+		std::lock_guard<std::mutex> lck(_mtx);
+		auto it = _cache.find(key);
+		if (_cache.end() != it)
+		{
+			size_t then = it->second.nlinks;
+			if (nlinks <= 2 * then and then <= 2 * nlinks)
+				return it->second;
+		}
+	}
+
+	// Sample without the lock, so that other planners are not held
+	// up. Two of them might sample the same thing at the same time;
+	// either answer will do.
+	Degrees deg = sample(as, t, pos, nlinks);
+
+	// AtomSpaces come and go, and the entries for those that are gone
+	// are never looked at again. They should not pile up.
+	std::lock_guard<std::mutex> lck(_mtx);
+	if (MAX_ENTRIES <= _cache.size()) _cache.clear();
+	_cache[key] = deg;
+	return deg;
+}
+
+size_t SearchStats::epoch(const AtomSpace* as)
+{
+	if (nullptr == as) return 0;
+	size_t n = as->get_size();
+	size_t e = 0;
+	while (n) { n >>= 1; e++; }
+	return e;
+}
+
+// ================================================================
+
+SearchStats& opencog::search_stats(void)
+{
+	static SearchStats* stats = new SearchStats();
+	return *stats;
+}
+
+// ======================= END OF FILE =================
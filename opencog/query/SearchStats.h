@@ -0,0 +1,115 @@
+/*
+ * opencog/query/SearchStats.h
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_SEARCH_STATS_H
+#define _OPENCOG_SEARCH_STATS_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#include <opencog/atoms/atom_types/types.h>
+#include <opencog/atoms/base/Handle.h>
+
+namespace opencog {
+
+class AtomSpace;
+
+/**
+ * Cheap statistics about the contents of an AtomSpace, used to
+ * estimate the cost of a search before starting it. See
+ * `InitiateSearchMixin::find_thinnest()`.
+ *
+ * The one thing that cannot be looked up directly is how many Links
+ * of some type hold an atom that is not yet known: the grounding of
+ * a variable. This is estimated by sampling: pick some Links of the
+ * type, look at the atom at the given position in each, and record
+ * how many Links of the type hold that atom. Positions are kept
+ * apart, so that the hub in position zero of an EvaluationLink (the
+ * PredicateNode) does not swamp the ListLinks in position one.
+ *
+ * The samples are kept until the number of Links of the type has
+ * halved or doubled.
+ */
+class SearchStats
+{
+public:
+	/// Sampled degrees, as a histogram in powers of two.
+	struct Degrees
+	{
+		size_t nlinks = 0;      // Links of the type, when sampled.
+		size_t nsamples = 0;
+		size_t buckets[32] = {}; // [k] counts degrees below 2^(k+1)
+		double mean = 0.0;
+
+		/// Power of two below which the fraction q of the samples lie.
+		size_t quantile(double q) const;
+	};
+
+	/// Position meaning "any position"; used for unordered Links.
+	/// Every real position is kept apart, however large.
+	static constexpr size_t ANY = SIZE_MAX;
+
+	/// Degrees of the atoms at position `pos` of the Links of type `t`:
+	/// how many Links of type `t` hold each of them.
+	Degrees degrees(const AtomSpace*, Type t, size_t pos = ANY);
+
+	/// Expected number of Links of type `t` holding an atom found at
+	/// position `pos` in some Link of type `t`.
+	double fan_in(const AtomSpace* as, Type t, size_t pos = ANY)
+	{
+		return degrees(as, t, pos).mean;
+	}
+
+	/// Changes when the number of atoms in the AtomSpace passes a
+	/// power of two. Search plans made in an older epoch are redone;
+	/// see `InitiateSearchMixin::setup_neighbor_search()`.
+	static size_t epoch(const AtomSpace*);
+
+	/// How often a cached search plan was used, and how often one
+	/// had to be made instead.
+	size_t get_plan_hits(void) const { return _plan_hits; }
+	size_t get_plan_misses(void) const { return _plan_misses; }
+	void count_plan(bool hit) { hit ? _plan_hits++ : _plan_misses++; }
+
+private:
+	static constexpr size_t SAMPLE_SIZE = 64;
+	static constexpr size_t MAX_ENTRIES = 4096;
+
+	std::atomic<size_t> _plan_hits{0};
+	std::atomic<size_t> _plan_misses{0};
+
+	// Keyed by the AtomSpace UUID, and not its address; a new
+	// AtomSpace can get the address of one that is gone.
+	std::mutex _mtx;
+	std::map<std::tuple<UUID, Type, size_t>, Degrees> _cache;
+
+	Degrees sample(const AtomSpace*, Type, size_t, size_t);
+};
+
+/// The statistics used by the pattern engine. Never destroyed.
+SearchStats& search_stats(void);
+
+} // namespace opencog
+
+#endif // _OPENCOG_SEARCH_STATS_H
@@ -69,10 +69,13 @@ Set set_intersection(const Set& s1, const Set& s2)
 
 /* ======================================================== */
 
+thread_local TermMatchMixin::TermState*
+	TermMatchMixin::_worker_terms = nullptr;
+
 TermMatchMixin::TermMatchMixin(AtomSpace* as) :
-	_nameserver(nameserver())
+	_nameserver(nameserver()), _term_workers(0)
 {
-	_temp_aspace = grab_transient_atomspace(as);
+	_tstate.temp_aspace = grab_transient_atomspace(as);
 
 	_connectives.insert(SEQUENTIAL_AND_LINK);
 	_connectives.insert(SEQUENTIAL_OR_LINK);
@@ -81,22 +84,46 @@ TermMatchMixin::TermMatchMixin(AtomSpace* as) :
 	_connectives.insert(NOT_LINK);
 
 	_as = as;
-	_pat_bound_vars = nullptr;
-	_gnd_bound_vars = nullptr;
 }
 
 TermMatchMixin::~TermMatchMixin()
 {
 	// If we have a transient atomspace, release it.
-	if (_temp_aspace)
+	if (_tstate.temp_aspace)
 	{
-		release_transient_atomspace(_temp_aspace);
-		_temp_aspace = nullptr;
+		release_transient_atomspace(_tstate.temp_aspace);
+		_tstate.temp_aspace = nullptr;
 	}
 }
 
 /* ======================================================== */
 
+/// Each thread of a parallel search gets its own scratch space.
+void TermMatchMixin::worker_start(void)
+{
+	TermState* st = new TermState();
+	st->temp_aspace = grab_transient_atomspace(_as);
+	st->owner = this;
+	st->prev = _worker_terms;
+	_worker_terms = st;
+	_term_workers++;
+}
+
+/// Called with a lock held; see InitiateSearchMixin::LoopJob.
+void TermMatchMixin::worker_end(void)
+{
+	TermState* st = _worker_terms;
+	if (nullptr == st or this != st->owner) return;
+
+	_term_workers--;
+	_worker_terms = st->prev;
+	_tstate.optionals_present |= st->optionals_present;
+	release_transient_atomspace(st->temp_aspace);
+	delete st;
+}
+
+/* ======================================================== */
+
 /**
  * Called when a node in the template pattern needs to
  * be compared to a possibly matching node in the atomspace.
@@ -142,10 +169,11 @@ bool TermMatchMixin::scope_match(const Handle& npat_h,
 {
 	// If there are scoped vars, then accept anything that is
 	// alpha-equivalent. (i.e. equivalent after alpha-conversion)
-	if (_pat_bound_vars and _pat_bound_vars->varset_contains(npat_h))
+	const TermState& st(ts());
+	if (st.pat_bound_vars and st.pat_bound_vars->varset_contains(npat_h))
 	{
-		bool aok = _pat_bound_vars->is_alpha_convertible(npat_h,
-		                  nsoln_h, *_gnd_bound_vars);
+		bool aok = st.pat_bound_vars->is_alpha_convertible(npat_h,
+		                  nsoln_h, *st.gnd_bound_vars);
 		return aok;
 	}
 
@@ -198,24 +226,25 @@ bool TermMatchMixin::link_match(const PatternTermPtr& ptm,
 		// scoped links. The correct fix would be to push these onto a
 		// stack, and then alter scope_match() to walk the stack,
 		// verifying alpha-convertability.
-		OC_ASSERT(nullptr == _pat_bound_vars,
+		TermState& st(ts());
+		OC_ASSERT(nullptr == st.pat_bound_vars,
 			"Not implemented! Need to implement a stack, here.");
-		_pat_bound_vars = & ScopeLinkCast(lpat)->get_variables();
-		_gnd_bound_vars = & ScopeLinkCast(lsoln)->get_variables();
+		st.pat_bound_vars = & ScopeLinkCast(lpat)->get_variables();
+		st.gnd_bound_vars = & ScopeLinkCast(lsoln)->get_variables();
 
 		// This is interesting: the ground term need only satisfy
 		// the pattern typing requirements.  We do not ask for equality:
-		//     if (not _pat_bound_vars->is_equal(*_gnd_bound_vars))
+		//     if (not st.pat_bound_vars->is_equal(*st.gnd_bound_vars))
 		// because that prevents searches for narrowly-typed grounds
 		// (as is done in the ForwardChainerUTest, see bug #934)
 		// Alternately, a single variable can match an entire
 		// VariableList (per bug #2070).
-		if (not (*_pat_bound_vars == *_gnd_bound_vars)
-		      and not _pat_bound_vars->is_type(VARIABLE_LIST)
-		      and not _pat_bound_vars->is_type(_gnd_bound_vars->varseq))
+		if (not (*st.pat_bound_vars == *st.gnd_bound_vars)
+		      and not st.pat_bound_vars->is_type(VARIABLE_LIST)
+		      and not st.pat_bound_vars->is_type(st.gnd_bound_vars->varseq))
 		{
-			_pat_bound_vars = nullptr;
-			_gnd_bound_vars = nullptr;
+			st.pat_bound_vars = nullptr;
+			st.gnd_bound_vars = nullptr;
 			return false;
 		}
 		return true;
@@ -229,10 +258,11 @@ bool TermMatchMixin::post_link_match(const Handle& lpat,
                                      const Handle& lgnd)
 {
 	Type pattype = lpat->get_type();
-	if (_pat_bound_vars and _nameserver.isA(pattype, SCOPE_LINK))
+	TermState& st(ts());
+	if (st.pat_bound_vars and _nameserver.isA(pattype, SCOPE_LINK))
 	{
-		_pat_bound_vars = nullptr;
-		_gnd_bound_vars = nullptr;
+		st.pat_bound_vars = nullptr;
+		st.gnd_bound_vars = nullptr;
 	}
 
 	// The StateLink has a single, unique closed-term value (or possibly
@@ -252,10 +282,11 @@ void TermMatchMixin::post_link_mismatch(const Handle& lpat,
                                         const Handle& lgnd)
 {
 	Type pattype = lpat->get_type();
-	if (_pat_bound_vars and _nameserver.isA(pattype, SCOPE_LINK))
+	TermState& st(ts());
+	if (st.pat_bound_vars and _nameserver.isA(pattype, SCOPE_LINK))
 	{
-		_pat_bound_vars = nullptr;
-		_gnd_bound_vars = nullptr;
+		st.pat_bound_vars = nullptr;
+		st.gnd_bound_vars = nullptr;
 	}
 }
 
@@ -417,8 +448,9 @@ bool TermMatchMixin::clause_match(const Handle& ptrn,
 		// which seems reasonable, except that everything else in the
 		// default callback ignores the TV on EvaluationLinks. So this
 		// is kind-of schizophrenic here.  Not sure what else to do.
-		_temp_aspace->clear();
-		bool crispy = EvaluationLink::crisp_eval_scratch(_as, grnd, _temp_aspace);
+		AtomSpace* tas = ts().temp_aspace;
+		tas->clear();
+		bool crispy = EvaluationLink::crisp_eval_scratch(_as, grnd, tas);
 
 		DO_LOG({LAZY_LOG_FINE << "Clause_match evaluation yielded: "
 		                      << crispy << std::endl;})
@@ -447,7 +479,7 @@ bool TermMatchMixin::optional_clause_match(const Handle& ptrn,
 	if (grnd)
 	{
 		if (not is_self_ground(ptrn, grnd, term_gnds, _variables->varset))
-			_optionals_present = true;
+			ts().optionals_present = true;
 		return false;
 	}
 
@@ -520,10 +552,11 @@ bool TermMatchMixin::eval_term(const Handle& virt,
 	DO_LOG({LAZY_LOG_FINE << "Grounded by gvirt=" << std::endl
 	              << gvirt->to_short_string() << std::endl;})
 
-	_temp_aspace->clear();
+	AtomSpace* tas = ts().temp_aspace;
+	tas->clear();
 	try
 	{
-		bool crispy = EvaluationLink::crisp_eval_scratch(_as, gvirt, _temp_aspace, true);
+		bool crispy = EvaluationLink::crisp_eval_scratch(_as, gvirt, tas, true);
 		DO_LOG({LAZY_LOG_FINE << "Eval_term evaluation yielded crisp-tv="
 		                      << crispy << std::endl;})
 		return crispy;
@@ -25,6 +25,8 @@
 #ifndef _OPENCOG_TERM_MATCH_MIXIN_H
 #define _OPENCOG_TERM_MATCH_MIXIN_H
 
+#include <atomic>
+
 #include <opencog/atoms/atom_types/types.h>
 #include <opencog/atoms/core/Quotation.h>
 #include <opencog/atomspace/AtomSpace.h>
@@ -45,7 +47,7 @@ namespace opencog {
  * other clear-box evaluatable link types.
  *
  * It handles AbsentLink using standard intuitionist logic,
- * and provides tracking of an _optionals_present flag, so that
+ * and provides tracking of an optionals_present flag, so that
  * conversion to explicit classical logic can be performed at the
  * conclusion of the search.  The default implicator performs
  * conversion; see the notes there for details.
@@ -92,7 +94,10 @@ class TermMatchMixin : public virtual PatternMatchCallback
 			return _connectives;
 		}
 
-		bool optionals_present(void) { return _optionals_present; }
+		bool optionals_present(void) { return _tstate.optionals_present; }
+
+		virtual void worker_start(void);
+		virtual void worker_end(void);
 
 	protected:
 		NameServer& _nameserver;
@@ -101,21 +106,43 @@ class TermMatchMixin : public virtual PatternMatchCallback
 		                    const GroundingMap&, const HandleSet&,
 		                    Quotation quotation=Quotation());
 
-		// Variables that should be ignored, because they are bound
-		// (scoped) in the current context (i.e. appear in a ScopeLink
-		// that is being matched.)
-		const Variables* _pat_bound_vars;
-		const Variables* _gnd_bound_vars;
-
-		// Temp atomspace used for test-groundings of virtual links.
-		AtomSpace* _temp_aspace;
+		// State that changes as the search progresses. When the search
+		// runs in parallel, each thread has its own, set up in
+		// worker_start().
+		struct TermState
+		{
+			// Variables that should be ignored, because they are bound
+			// (scoped) in the current context (i.e. appear in a
+			// ScopeLink that is being matched.)
+			const Variables* pat_bound_vars = nullptr;
+			const Variables* gnd_bound_vars = nullptr;
+
+			// Temp atomspace used for test-groundings of virtual links.
+			AtomSpace* temp_aspace = nullptr;
+
+			bool optionals_present = false;
+
+			// The search this belongs to, and the one it is nested in.
+			const TermMatchMixin* owner = nullptr;
+			TermState* prev = nullptr;
+		};
+		TermState _tstate;
+		static thread_local TermState* _worker_terms;
+		std::atomic<size_t> _term_workers;
+
+		TermState& ts(void)
+		{
+			if (0 == _term_workers.load(std::memory_order_relaxed))
+				return _tstate;
+			TermState* wt = _worker_terms;
+			return (wt and this == wt->owner) ? *wt : _tstate;
+		}
 
 		// Crisp-logic evaluation of evaluatable terms
 		TypeSet _connectives;
 		bool eval_term(const Handle& pat, const GroundingMap& gnds);
 		bool eval_sentence(const Handle& pat, const GroundingMap& gnds);
 
-		bool _optionals_present = false;
 		AtomSpace* _as;
 };
 
@@ -988,6 +988,213 @@
      cog-report-counts -- return a report of counts of all atom types.
 ")
 
+(set-procedure-property! cog-memory-usage 'documentation
+"
+  cog-memory-usage [ATOMSPACE] -- Approximate RAM used by an AtomSpace
+
+  Return an association list describing the RAM used by the Atoms in
+  `ATOMSPACE`, not counting the AtomSpaces under it. If the optional
+  argument is not given, the current AtomSpace is used. The numbers
+  are estimates, computed from object sizes; they do not include the
+  overhead of the memory allocator. The report is cheap to make, and
+  is safe to make on a running system.
+
+  The list has the form
+     ((frame . ATOMSPACE)
+      (total . COUNTS)
+      (types . ((TYPE . COUNTS) ...))
+      (keys . ((KEY . COUNTS) ...)))
+  and each COUNTS is an association list with the entries
+     atoms          -- number of Atoms
+     atom-bytes     -- the Atoms themselves, including Node names and
+                       Link outgoing sets
+     incoming-bytes -- incoming sets
+     value-bytes    -- key-value maps and the Values in them
+     index-bytes    -- the hash tables that index the Atoms.
+  Under `keys`, `atoms` is the number of Atoms holding that key, and
+  only `value-bytes` is filled in.
+
+  Example usage:
+     (assoc-ref (assoc-ref (cog-memory-usage) 'total) 'atom-bytes)
+     (assoc-ref (assoc-ref (cog-memory-usage) 'types) 'ConceptNode)
+
+  See also:
+     cog-memory-usage-by-frame -- the same, for a stack of AtomSpaces.
+     cog-report-counts -- return a report of counts of all atom types.
+")
+
+(set-procedure-property! cog-memory-usage-by-frame 'documentation
+"
+  cog-memory-usage-by-frame [ATOMSPACE] -- RAM used by a stack of frames
+
+  Return a list of memory usage reports, as described for
+  `cog-memory-usage`, one for `ATOMSPACE` and one for each of the
+  AtomSpaces under it. Each AtomSpace is reported once, even if it is
+  reachable along several paths. The first report is for `ATOMSPACE`
+  itself.
+
+  Example usage:
+     (map (lambda (rpt) (assoc-ref (assoc-ref rpt 'total) 'atoms))
+        (cog-memory-usage-by-frame))
+  will return the number of Atoms in each frame.
+")
+
+(set-procedure-property! cog-mutex-stats 'documentation
+"
+  cog-mutex-stats [RESET] -- Lock contention on the Atom mutexes
+
+  Atoms do not hold a lock of their own; instead, they share the locks
+  in two pools, one protecting the Values on the Atoms, and one for the
+  incoming sets. This returns an association list of the form
+     ((values . POOL) (incoming . POOL))
+  where each POOL is
+     ((slots . NUMBER-OF-LOCKS)
+      (total . STATS)
+      (busiest . ((SLOT . STATS) ...)))
+  and each STATS is an association list with the entries
+     acquired   -- number of times the lock was taken
+     contended  -- number of times it had to be waited for
+     wait-ns    -- total time spent waiting, in nanoseconds.
+  At most eight of the busiest slots are listed. If `RESET` is #t,
+  all of the counters are zeroed, after being read.
+
+  A high ratio of contended to acquired means that unrelated Atoms
+  are fighting over the same locks. The number of locks in each pool
+  can be raised by setting the OPENCOG_MUTEX_POOL_SIZE environment
+  variable, before the AtomSpace is loaded.
+
+  Example usage:
+     (assoc-ref (assoc-ref (cog-mutex-stats) 'values) 'total)
+")
+
+(set-procedure-property! cog-add-name-index! 'documentation
+"
+  cog-add-name-index! TYPE [ATOMSPACE] -- Index Nodes by name
+
+  Declare an index that keeps Nodes of type `TYPE`, and its subtypes,
+  sorted by name, so that `cog-get-atoms-by-prefix` does not need to
+  scan all of them. The index is built from the Atoms already in the
+  AtomSpace, and is kept current as Atoms are added and extracted.
+  Like all secondary indexes, it covers the Atoms in `ATOMSPACE` only,
+  and not those in the AtomSpaces under it. If the optional argument
+  is not given, the current AtomSpace is used.
+
+  Example usage:
+     (cog-add-name-index! 'ConceptNode)
+     (cog-get-atoms-by-prefix 'ConceptNode \"anti\")
+
+  See also:
+     cog-add-key-index! -- index Atoms by the keys they hold.
+     cog-add-position-index! -- index Links by their outgoing Atoms.
+     cog-drop-indexes! -- remove all secondary indexes.
+")
+
+(set-procedure-property! cog-add-key-index! 'documentation
+"
+  cog-add-key-index! KEY [ATOMSPACE] -- Index Atoms holding KEY
+
+  Declare an index of all Atoms holding a Value on `KEY`, so that
+  `cog-get-atoms-with-key` does not need to scan the AtomSpace. The
+  index is kept current as Values are set and removed with
+  `cog-set-value!` and related functions.
+
+  Example usage:
+     (cog-add-key-index! (Predicate \"weight\"))
+     (cog-get-atoms-with-key (Predicate \"weight\"))
+")
+
+(set-procedure-property! cog-add-position-index! 'documentation
+"
+  cog-add-position-index! TYPE POS [ATOMSPACE] -- Index Links by position
+
+  Declare an index of Links of type `TYPE`, keyed by the Atom at
+  position `POS` in their outgoing set, counting from zero. `TYPE`
+  must be an ordered Link type. The index is used by
+  `cog-get-links-at-position`, and also by the pattern matcher, when
+  it picks the place to start a search: a query holding a constant
+  at an indexed position only has to look at the Links holding that
+  constant at that position.
+
+  Example usage:
+     (cog-add-position-index! 'ListLink 1)
+     (cog-get-links-at-position 'ListLink 1 (Concept \"item\"))
+")
+
+(set-procedure-property! cog-drop-indexes! 'documentation
+"
+  cog-drop-indexes! [ATOMSPACE] -- Remove all secondary indexes
+
+  Remove the indexes declared with `cog-add-name-index!`,
+  `cog-add-key-index!` and `cog-add-position-index!`.
+")
+
+(set-procedure-property! cog-get-atoms-by-prefix 'documentation
+"
+  cog-get-atoms-by-prefix TYPE PREFIX [ATOMSPACE]
+
+  Return a list of the Nodes of type `TYPE`, or its subtypes, whose
+  name starts with the string `PREFIX`. A name index is used, if one
+  was declared with `cog-add-name-index!`; else all Nodes of that
+  type are scanned. Only the Atoms in `ATOMSPACE` itself are returned,
+  not those in the AtomSpaces under it.
+")
+
+(set-procedure-property! cog-get-atoms-with-key 'documentation
+"
+  cog-get-atoms-with-key KEY [ATOMSPACE]
+
+  Return a list of the Atoms holding a Value on `KEY`. A key index is
+  used, if one was declared with `cog-add-key-index!`; else the whole
+  AtomSpace is scanned. Only the Atoms in `ATOMSPACE` itself are
+  returned, not those in the AtomSpaces under it.
+")
+
+(set-procedure-property! cog-get-links-at-position 'documentation
+"
+  cog-get-links-at-position TYPE POS ATOM [ATOMSPACE]
+
+  Return a list of the Links of type `TYPE` that have `ATOM` at
+  position `POS` of their outgoing set. A position index is used, if
+  one was declared with `cog-add-position-index!`; else all Links of
+  that type are scanned. Only the Atoms in `ATOMSPACE` itself are
+  returned, not those in the AtomSpaces under it.
+")
+
+(set-procedure-property! cog-atoms-cursor 'documentation
+"
+  cog-atoms-cursor TYPE [SUBTYPES] [ATOMSPACE]
+
+  Return a cursor over the Atoms of type `TYPE`, and also its
+  subtypes, if `SUBTYPES` is #t. Use `cog-cursor-next` to read Atoms
+  from it, a chunk at a time, or `cog-cursor->stream` to turn it into
+  a stream. Unlike `cog-get-atoms`, this does not first make a list
+  of all of the Atoms; a reader that stops early pays only for the
+  chunks that it read. Atoms added or extracted while the cursor is
+  being read may or may not be seen.
+
+  Example:
+     (define cur (cog-atoms-cursor 'ConceptNode))
+     (cog-cursor-next cur 10)   ; The first ten ConceptNodes.
+")
+
+(set-procedure-property! cog-incoming-cursor 'documentation
+"
+  cog-incoming-cursor ATOM [TYPE] [ATOMSPACE]
+
+  Return a cursor over the incoming set of `ATOM`; only the Links
+  of type `TYPE`, if it is given, and is not #f. See `cog-atoms-cursor`
+  and `cog-incoming-set`.
+")
+
+(set-procedure-property! cog-cursor-next 'documentation
+"
+  cog-cursor-next CURSOR [N]
+
+  Return a list of the next `N` Atoms from `CURSOR`, or fewer, if
+  there are not that many left. The empty list means that the cursor
+  is used up. `N` defaults to 1024.
+")
+
 (set-procedure-property! cog-atomspace 'documentation
 "
  cog-atomspace [ATOM]
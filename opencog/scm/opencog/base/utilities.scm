@@ -13,6 +13,7 @@
 ; -- cog-report-counts -- Return an association list of counts.
 ; -- count-all -- Return the total number of atoms in the atomspace.
 ; -- cog-get-atoms -- Return a list of all atoms of type 'atom-type'
+; -- cog-cursor->stream -- Read a cursor as a stream of atoms.
 ; -- cog-get-all-roots -- Return the list of all root atoms.
 ; -- cog-prt-atomspace -- Prints all atoms in the atomspace
 ; -- cog-get-root -- Return all hypergraph roots containing 'atom'
@@ -33,6 +34,8 @@
 (use-modules (srfi srfi-1))
 (use-modules (ice-9 optargs))  ; Needed for define*-public
 (use-modules (ice-9 threads))  ; Needed for par-map par-for-each
+(use-modules ((srfi srfi-41)   ; Needed for cog-cursor->stream
+	#:select (stream-cons stream-null stream-lambda)))
 
 ; -----------------------------------------------------------------------
 ; Analogs of car, cdr, etc. but for atoms.
@@ -211,6 +214,32 @@
 	)
 )
 
+; -----------------------------------------------------------------------
+(define*-public (cog-cursor->stream CURSOR #:optional (CHUNK 1024))
+"
+  cog-cursor->stream CURSOR [CHUNK] -- Read CURSOR as a stream.
+
+  Return a SRFI-41 stream of the Atoms from CURSOR, as made by
+  `cog-atoms-cursor` or `cog-incoming-cursor`. The Atoms are read
+  from the cursor CHUNK at a time, and only as the stream is walked.
+
+  Example:
+     (use-modules (srfi srfi-41))
+     (define s (cog-cursor->stream (cog-atoms-cursor 'ConceptNode)))
+     (stream->list 10 s)   ; The first ten ConceptNodes.
+
+  See also:
+     cog-cursor-next -- read a list of Atoms from a cursor.
+"
+	(define from-chunk
+		(stream-lambda (chunk)
+			(if (pair? chunk)
+				(stream-cons (car chunk) (from-chunk (cdr chunk)))
+				(let ((more (cog-cursor-next CURSOR CHUNK)))
+					(if (null? more) stream-null (from-chunk more))))))
+	(from-chunk '())
+)
+
 ; -----------------------------------------------------------------------
 (define*-public (cog-prt-atomspace #:optional (ATOMSPACE (cog-atomspace)))
 "
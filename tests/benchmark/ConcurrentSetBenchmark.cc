@@ -0,0 +1,85 @@
+/*
+ * tests/benchmark/ConcurrentSetBenchmark.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <opencog/atomspace/AtomSpace.h>
+
+using namespace opencog;
+
+// Print the add and lookup rate of the AtomSpace, for increasing
+// numbers of threads.
+int main()
+{
+	unsigned int max_threads = std::thread::hardware_concurrency();
+	max_threads = std::max(1U, std::min(64U, max_threads));
+	const int N = 20000;
+	int rc = 0;
+
+	printf("Threads   add/sec     lookup/sec\n");
+	for (unsigned int nthr = 1; nthr <= max_threads; nthr *= 2)
+	{
+		AtomSpace as;
+		std::vector<HandleSeq> made(nthr);
+		std::atomic<int> bad(0);
+
+		auto adder = [&](int tid)
+		{
+			for (int i = 0; i < N; i++)
+				made[tid].push_back(as.add_node(CONCEPT_NODE,
+					std::to_string(tid) + "-" + std::to_string(i)));
+		};
+		auto looker = [&](int tid)
+		{
+			for (int j = 0; j < 4; j++)
+				for (const Handle& h : made[tid])
+					if (nullptr == as.get_atom(h)) bad++;
+		};
+
+		auto start = std::chrono::steady_clock::now();
+		std::vector<std::thread> pool;
+		for (unsigned int i = 0; i < nthr; i++) pool.push_back(std::thread(adder, i));
+		for (std::thread& t : pool) t.join();
+		auto mid = std::chrono::steady_clock::now();
+
+		pool.clear();
+		for (unsigned int i = 0; i < nthr; i++) pool.push_back(std::thread(looker, i));
+		for (std::thread& t : pool) t.join();
+		auto end = std::chrono::steady_clock::now();
+
+		double add_secs = std::chrono::duration<double>(mid - start).count();
+		double look_secs = std::chrono::duration<double>(end - mid).count();
+		printf("%4u   %10.0f   %12.0f\n", nthr,
+		       nthr * N / add_secs, 4 * nthr * N / look_secs);
+
+		if (0 != bad or as.get_size() != nthr * N)
+		{
+			fprintf(stderr, "Lost atoms with %u threads\n", nthr);
+			rc = 1;
+		}
+	}
+	return rc;
+}
@@ -0,0 +1,99 @@
+/*
+ * tests/benchmark/CountValueBenchmark.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <opencog/atoms/base/Node.h>
+#include <opencog/atoms/value/FloatValue.h>
+
+using namespace opencog;
+
+static const int nthreads = 4;
+static const int natoms = 4;
+static const int loops = 100000;
+
+static double get(const Handle& h, const Handle& key, size_t idx)
+{
+	return FloatValueCast(h->getValue(key))->value()[idx];
+}
+
+// Time one increment, with several threads hammering the same few
+// keys. Returns nanoseconds per increment, or a negative number if
+// some increment was lost.
+static double timeit(const HandleSeq& hot, const Handle& key,
+                     const std::function<void(const Handle&)>& incr)
+{
+	for (const Handle& h : hot) h->setValue(key, nullptr);
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> thrs;
+	for (int t = 0; t < nthreads; t++)
+		thrs.push_back(std::thread([&]() {
+			for (int l = 0; l < loops; l++)
+				incr(hot[l % natoms]);
+		}));
+	for (std::thread& th : thrs) th.join();
+	auto end = std::chrono::steady_clock::now();
+
+	double total = 0.0;
+	for (const Handle& h : hot) total += get(h, key, 0);
+	if (total != nthreads * loops) return -1.0;
+	return 1e9 * std::chrono::duration<double>(end - start).count()
+		/ (nthreads * loops);
+}
+
+// Print the cost of incrementCount, compared to making a new
+// FloatValue for each increment, as was done before.
+int main()
+{
+	Handle key(createNode(PREDICATE_NODE, "speed key"));
+	HandleSeq hot;
+	for (int i = 0; i < natoms; i++)
+		hot.push_back(createNode(CONCEPT_NODE, "hot " + std::to_string(i)));
+
+	double tinplace = timeit(hot, key, [&](const Handle& h) {
+		h->incrementCount(key, 0, 1.0);
+	});
+
+	std::mutex mtx;
+	double tcopy = timeit(hot, key, [&](const Handle& h) {
+		std::lock_guard<std::mutex> lck(mtx);
+		ValuePtr vp(h->getValue(key));
+		std::vector<double> cnt({0.0});
+		if (vp) cnt = FloatValueCast(vp)->value();
+		cnt[0] += 1.0;
+		h->setValue(key, createFloatValue(cnt));
+	});
+
+	if (tinplace < 0.0 or tcopy < 0.0)
+	{
+		fprintf(stderr, "Lost an increment\n");
+		return 1;
+	}
+
+	printf("incrementCount, %d threads on %d atoms: "
+	       "%.0f nsecs in place, %.0f nsecs copying\n",
+	       nthreads, natoms, tinplace, tcopy);
+	return 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * tests/benchmark/HashBenchmark.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <opencog/atoms/base/Link.h>
+#include <opencog/atoms/base/Node.h>
+#include <opencog/atoms/base/hash.h>
+
+using namespace opencog;
+
+static std::string test_string(size_t len)
+{
+	std::string s;
+	for (size_t i = 0; i < len; i++)
+		s.push_back((char) ('a' + (i * 7) % 26));
+	return s;
+}
+
+// Print the cost of name_hash against std::hash, for names of several
+// lengths, and the cost of hashing an outgoing set.
+int main()
+{
+	// Printed, so that the loops are not optimized away.
+	uint64_t sum = 0;
+
+	printf("  Length   name_hash (nsec)   std::hash (nsec)\n");
+	for (size_t len : {8, 32, 256, 4096})
+	{
+		std::vector<std::string> strs;
+		for (int i = 0; i < 64; i++)
+			strs.push_back(std::to_string(i) + test_string(len));
+
+		const size_t reps = 100000000 / (len + 16);
+		auto start = std::chrono::steady_clock::now();
+		for (size_t r = 0; r < reps; r++)
+			sum += name_hash(strs[r % 64]);
+		auto mid = std::chrono::steady_clock::now();
+		for (size_t r = 0; r < reps; r++)
+			sum += std::hash<std::string>()(strs[r % 64]);
+		auto end = std::chrono::steady_clock::now();
+
+		double tw = std::chrono::duration<double>(mid - start).count();
+		double ts = std::chrono::duration<double>(end - mid).count();
+		printf("%8zu   %12.1f       %12.1f\n", len,
+		       1e9 * tw / reps, 1e9 * ts / reps);
+	}
+
+	HandleSeq nodes;
+	for (int i = 0; i < 8; i++)
+		nodes.push_back(createNode(CONCEPT_NODE, std::to_string(i)));
+	for (size_t arity : {2, 8})
+	{
+		HandleSeq oset(nodes.begin(), nodes.begin() + arity);
+		const size_t reps = 1000000;
+		auto start = std::chrono::steady_clock::now();
+		for (size_t r = 0; r < reps; r++)
+			sum += hash_sequence(r, arity,
+				[&](size_t i) { return oset[i]->get_hash(); });
+		auto end = std::chrono::steady_clock::now();
+		double t = std::chrono::duration<double>(end - start).count();
+		printf("Arity %zu outgoing set: %.1f nsec\n", arity, 1e9 * t / reps);
+	}
+
+	printf("(checksum %lx)\n", (unsigned long) sum);
+	return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * tests/benchmark/LinkLookupBenchmark.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <chrono>
+
+#include <opencog/atomspace/AtomSpace.h>
+
+using namespace opencog;
+
+// Dedup-heavy ingestion: every Link being added is already in the
+// AtomSpace. Print the re-add rate through a temporary Link, and
+// through the hash probe in add_link().
+int main()
+{
+	AtomSpacePtr as = createAtomSpace();
+
+	const size_t nlinks = 200000;
+	HandleSeq nodes;
+	for (size_t i = 0; i < 1000; i++)
+		nodes.push_back(as->add_node(CONCEPT_NODE, std::to_string(i)));
+	for (size_t i = 0; i < nlinks; i++)
+		as->add_link(LIST_LINK, nodes[i % 1000], nodes[(i / 1000) % 1000]);
+
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < nlinks; i++)
+		as->add_atom(createLink(HandleSeq{nodes[i % 1000],
+			nodes[(i / 1000) % 1000]}, LIST_LINK));
+	auto mid = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < nlinks; i++)
+		as->add_link(LIST_LINK, nodes[i % 1000], nodes[(i / 1000) % 1000]);
+	auto end = std::chrono::steady_clock::now();
+
+	if (as->get_num_atoms_of_type(LIST_LINK) != nlinks)
+	{
+		fprintf(stderr, "Re-adding made new links\n");
+		return 1;
+	}
+
+	double tlink = std::chrono::duration<double>(mid - start).count();
+	double thash = std::chrono::duration<double>(end - mid).count();
+	printf("Re-adding %zu links: temporary Link %.0f K/sec, "
+	       "hash probe %.0f K/sec\n", nlinks,
+	       1e-3 * nlinks / tlink, 1e-3 * nlinks / thash);
+	return 0;
+}
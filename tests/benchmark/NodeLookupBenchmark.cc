@@ -0,0 +1,68 @@
+/*
+ * tests/benchmark/NodeLookupBenchmark.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <opencog/atomspace/AtomSpace.h>
+
+using namespace opencog;
+
+// A dictionary-sized vocabulary, each word under two types. Print the
+// rate of Node lookups through a temporary Node, and through the raw
+// bytes of the name. Build with USE_NAME_POOL to compare the two ways
+// of holding names.
+int main()
+{
+	AtomSpacePtr as = createAtomSpace();
+
+	const size_t nwords = 200000;
+	std::vector<std::string> words;
+	for (size_t i = 0; i < nwords; i++)
+	{
+		words.push_back("word-" + std::to_string(i * 7919));
+		as->add_node(CONCEPT_NODE, std::string(words.back()));
+		as->add_node(WORD_NODE, std::string(words.back()));
+	}
+
+	size_t found = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (const std::string& w : words)
+		if (as->get_node(CONCEPT_NODE, std::string(w))) found++;
+	auto mid = std::chrono::steady_clock::now();
+	for (const std::string& w : words)
+		if (as->get_node(CONCEPT_NODE, w.c_str())) found++;
+	auto end = std::chrono::steady_clock::now();
+
+	if (found != 2 * nwords)
+	{
+		fprintf(stderr, "Found %zu of %zu nodes\n", found, 2 * nwords);
+		return 1;
+	}
+
+	double tnode = std::chrono::duration<double>(mid - start).count();
+	double tbytes = std::chrono::duration<double>(end - mid).count();
+	printf("Lookup of %zu nodes: temporary Node %.0f K/sec, "
+	       "raw bytes %.0f K/sec\n", nwords,
+	       1e-3 * nwords / tnode, 1e-3 * nwords / tbytes);
+	return 0;
+}
@@ -0,0 +1,114 @@
+/*
+ * tests/benchmark/SlabAllocatorBenchmark.cc
+ *
+ * Copyright (C) 2025 Linas Vepstas <linasvepstas@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <opencog/atoms/base/Link.h>
+#include <opencog/atoms/base/Node.h>
+#include <opencog/atoms/base/SlabAllocator.h>
+#include <opencog/atoms/atom_types/atom_types.h>
+
+using namespace opencog;
+
+static size_t rss_bytes(void)
+{
+	size_t pages = 0, resident = 0;
+	std::ifstream statm("/proc/self/statm");
+	statm >> pages >> resident;
+	return resident * sysconf(_SC_PAGESIZE);
+}
+
+template<class MAKER>
+static void load(const char* what, size_t num, MAKER make)
+{
+	// Touch the pages of the vectors, so they don't count.
+	HandleSeq nodes(num);
+	HandleSeq links(num);
+	nodes.clear();
+	links.clear();
+
+	size_t rss0 = rss_bytes();
+	auto start = std::chrono::steady_clock::now();
+
+	for (size_t i = 0; i < num; i++)
+		nodes.push_back(make(std::to_string(i)));
+
+	for (size_t i = 0; i+1 < num; i++)
+		links.push_back(MAKER::link(nodes[i], nodes[i+1]));
+
+	auto made = std::chrono::steady_clock::now();
+	size_t rss1 = rss_bytes();
+	links.clear();
+	nodes.clear();
+	auto done = std::chrono::steady_clock::now();
+
+	double tmake = std::chrono::duration<double>(made - start).count();
+	double tfree = std::chrono::duration<double>(done - made).count();
+	printf("%s: %zu atoms: create %.0f K/sec free %.0f K/sec; "
+	       "RSS grew %zu MB\n", what, 2*num-1,
+	       1e-3 * (2*num-1) / tmake, 1e-3 * (2*num-1) / tfree,
+	       (rss1 - rss0) >> 20);
+}
+
+struct SlabMaker
+{
+	Handle operator()(const std::string& s) const
+		{ return Handle(slab_create<Node>(CONCEPT_NODE, std::string(s))); }
+	static Handle link(const Handle& a, const Handle& b)
+		{ return Handle(slab_create<Link>(HandleSeq({a, b}), LIST_LINK)); }
+};
+
+struct HeapMaker
+{
+	Handle operator()(const std::string& s) const
+		{ return Handle(std::make_shared<Node>(CONCEPT_NODE, std::string(s))); }
+	static Handle link(const Handle& a, const Handle& b)
+		{ return Handle(std::make_shared<Link>(HandleSeq({a, b}), LIST_LINK)); }
+};
+
+// Compare Atom creation and release through the slab allocator against
+// the general-purpose heap. Each run is in a fresh process, so that
+// neither can re-use memory freed by the other.
+int main()
+{
+	const size_t num = 500000;
+	int rc = 0;
+	for (int run = 0; run < 2; run++)
+	{
+		fflush(stdout);
+		pid_t pid = fork();
+		if (0 == pid)
+		{
+			if (0 == run) load("slab", num, SlabMaker());
+			else load("heap", num, HeapMaker());
+			fflush(stdout);
+			_exit(0);
+		}
+		int status = 0;
+		waitpid(pid, &status, 0);
+		if (0 != status) rc = 1;
+	}
+	return rc;
+}
@@ -271,6 +271,77 @@ class AtomTest(TestCase):
         self.assertTrue(test2 in b.get_atoms_by_type(types.ConceptNode))
         self.assertTrue(test2 not in self.space.get_atoms_by_type(types.ConceptNode))
 
+    def test_memory_usage(self):
+        key = PredicateNode("key")
+        a = ConceptNode("a")
+        a.set_value(key, FloatValue([1, 2, 3]))
+        ListLink(a, ConceptNode("b"))
+
+        usage = self.space.memory_usage()
+        self.assertEqual(usage['frame'], self.space)
+        self.assertEqual(usage['total']['atoms'], 4)
+        self.assertEqual(usage['types']['ConceptNode']['atoms'], 2)
+        self.assertEqual(usage['types']['ListLink']['atoms'], 1)
+        self.assertTrue(usage['types']['ListLink']['atom_bytes'] > 0)
+        self.assertEqual(usage['keys'][key]['atoms'], 1)
+        self.assertTrue(usage['keys'][key]['value_bytes'] > 0)
+
+        child = create_child_atomspace(self.space)
+        child.add_node(types.ConceptNode, 'c')
+        frames = child.memory_usage_by_frame()
+        self.assertEqual(len(frames), 2)
+        self.assertEqual(frames[0]['total']['atoms'], 1)
+        self.assertEqual(frames[1]['total']['atoms'], 4)
+
+    def test_indexes(self):
+        key = PredicateNode("key")
+        anti = ConceptNode("antimatter")
+        ConceptNode("matter")
+        PredicateNode("antique")
+        pair = ListLink(ConceptNode("x"), anti)
+        anti.set_value(key, FloatValue(1))
+
+        self.space.add_name_index(types.Node)
+        self.space.add_key_index(key)
+        self.space.add_position_index(types.ListLink, 1)
+
+        found = self.space.get_atoms_by_name_prefix(types.Node, "anti")
+        self.assertEqual(set(found), {anti, PredicateNode("antique")})
+        found = self.space.get_atoms_by_name_prefix(types.ConceptNode, "anti",
+                                                    subtype=False)
+        self.assertEqual(found, [anti])
+        self.assertEqual(self.space.get_atoms_by_key(key), [anti])
+        self.assertEqual(self.space.get_links_by_position(types.ListLink, 1, anti),
+                         [pair])
+        self.assertEqual(self.space.get_links_by_position(types.ListLink, 0, anti),
+                         [])
+
+        self.space.remove(pair)
+        self.assertEqual(self.space.get_links_by_position(types.ListLink, 1, anti),
+                         [])
+
+    def test_iterators(self):
+        hub = ConceptNode("hub")
+        links = [ListLink(hub, ConceptNode(str(i))) for i in range(50)]
+        evals = [EvaluationLink(PredicateNode("p"), l) for l in links[:5]]
+
+        found = list(self.space.iter_atoms_by_type(types.ConceptNode, chunk=7))
+        self.assertEqual(len(found), 51)
+        self.assertEqual(set(found), set(self.space.get_atoms_by_type(types.ConceptNode)))
+        found = list(self.space.iter_atoms_by_type(types.Link, chunk=7))
+        self.assertEqual(set(found), set(links + evals))
+
+        # Stopping early is fine.
+        it = self.space.iter_atoms_by_type(types.ConceptNode, chunk=3)
+        self.assertEqual(next(it).type, types.ConceptNode)
+        del it
+
+        found = list(self.space.iter_incoming(hub, chunk=7))
+        self.assertEqual(set(found), set(links))
+        found = list(self.space.iter_incoming(links[0], types.EvaluationLink))
+        self.assertEqual(found, [evals[0]])
+        self.assertEqual(list(self.space.iter_incoming(links[0], types.SetLink)), [])
+
     def test_strings(self):
         # set up a link and atoms
         a1 = Node("test1")